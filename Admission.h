@@ -0,0 +1,280 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include "DataStructures.h"
+#include <algorithm>
+#include <cfloat>
+
+// Token bucket: holds up to capacity tokens and refills at rate tokens per second
+struct TokenBucket {
+    double tokens;
+    double capacity;
+    double rate;
+    double lastRefill;
+
+    TokenBucket() : tokens(0), capacity(0), rate(0), lastRefill(0) {}
+    TokenBucket(double cap, double perSecond, double now) : tokens(cap), capacity(cap), rate(perSecond), lastRefill(now) {}
+
+    void refill(double now) {
+        if (now > lastRefill) {
+            tokens = min(capacity, tokens + (now - lastRefill) * rate);
+            lastRefill = now;
+        }
+    }
+
+    bool tryTake(double now) {
+        refill(now);
+        if (tokens < 1.0) return false;
+        tokens -= 1.0;
+        return true;
+    }
+
+    // Seconds until tokens reach need (0 when they already have)
+    double secondsUntil(double need) const {
+        return tokens >= need ? 0.0 : (need - tokens) / rate;
+    }
+};
+
+// Registration opens at opensAt (seconds on the system clock) for students whose
+// roll number starts with rollPrefix; the earlier a window opens, the higher its priority
+struct RegistrationWindow {
+    string rollPrefix;
+    double opensAt;
+};
+
+inline void heapUsage(const RegistrationWindow& window, MemoryStats& stats) {
+    heapUsage(window.rollPrefix, stats);
+}
+
+enum class Admission { Admitted, WindowClosed, RateLimited, Queued, Shed };
+
+struct AdmissionDecision {
+    Admission result;
+    double retryAt; // When to come back; meaningless once admitted
+};
+
+struct AdmissionMetrics {
+    long long admitted;
+    long long queued;      // Tickets issued
+    long long shed;        // Refused because the queue was full
+    long long rateLimited;
+    long long windowClosed;
+    long long expired;     // Tickets abandoned past their retry time
+    int peakDepth;
+    double totalLatency;   // Seconds from ticket to admission, summed over queued requests
+    double maxLatency;
+    long long latencySamples;
+    AdmissionMetrics() : admitted(0), queued(0), shed(0), rateLimited(0), windowClosed(0), expired(0),
+                         peakDepth(0), totalLatency(0), maxLatency(0), latencySamples(0) {}
+};
+
+// Admission control for registration requests.
+// A request first has to fall inside the student's registration window and pass
+// their personal token bucket. It is then admitted at once if the system bucket
+// has a token and nobody is queued; otherwise the student gets a ticket in a
+// priority queue (earlier windows first, then arrival order) and a time to retry.
+// Only the ticket at the head is admitted, and tickets whose holders do not come
+// back shortly after their retry time are dropped so they cannot block the line.
+class AdmissionController {
+private:
+    static constexpr double TICKET_GRACE_SECONDS = 30.0;
+
+    struct Ticket {
+        long long seq;
+        double priority;
+        long long place; // Issue number within its lane
+        double issuedAt;
+        double expiresAt;
+        Ticket() : seq(0), priority(0), place(0), issuedAt(0), expiresAt(0) {}
+        Ticket(long long s, double p, long long pl, double issued)
+            : seq(s), priority(p), place(pl), issuedAt(issued), expiresAt(issued) {}
+    };
+
+    // Tickets of equal priority leave the line in the order they were issued,
+    // so a ticket's place in line follows from per-priority counters alone
+    struct Lane {
+        double priority;
+        long long issued;
+        long long departed; // Admitted or dropped
+    };
+
+    struct QueueEntry {
+        double priority;
+        long long seq;
+        string username;
+
+        friend void heapUsage(const QueueEntry& entry, MemoryStats& stats) {
+            heapUsage(entry.username, stats);
+        }
+    };
+
+    struct EntryLess {
+        bool operator()(const QueueEntry& a, const QueueEntry& b) const {
+            return a.priority != b.priority ? a.priority < b.priority : a.seq < b.seq;
+        }
+    };
+
+    vector<RegistrationWindow> windows;
+    HashTable<TokenBucket> userBuckets;
+    TokenBucket systemBucket;
+    HashTable<Ticket> tickets; // Username -> live ticket
+    MinHeap<QueueEntry, EntryLess> line;
+    vector<Lane> lanes; // Ascending priority, only those with tickets in line; one per window at most
+    long long nextSeq;
+    double userBurst;
+    double userRate;
+    int maxQueue;
+    AdmissionMetrics stats;
+
+    bool isLive(const QueueEntry& entry, double now) {
+        Ticket* ticket = tickets.search(entry.username);
+        return ticket != nullptr && ticket->seq == entry.seq && ticket->expiresAt >= now;
+    }
+
+    vector<Lane>::iterator laneFor(double priority) {
+        auto lane = lower_bound(lanes.begin(), lanes.end(), priority,
+                                [](const Lane& l, double p) { return l.priority < p; });
+        if (lane == lanes.end() || lane->priority != priority) lane = lanes.insert(lane, Lane{priority, 0, 0});
+        return lane;
+    }
+
+    void popHead() {
+        auto lane = laneFor(line.top().priority);
+        if (++lane->departed == lane->issued) lanes.erase(lane);
+        line.pop();
+    }
+
+    // Pops abandoned and superseded entries off the head of the line
+    void dropStale(double now) {
+        while (!line.isEmpty() && !isLive(line.top(), now)) {
+            Ticket* ticket = tickets.search(line.top().username);
+            if (ticket != nullptr && ticket->seq == line.top().seq) {
+                tickets.remove(line.top().username);
+                stats.expired++;
+            }
+            popHead();
+        }
+    }
+
+    // Tickets in line before this one. Abandoned tickets still count until they
+    // reach the head and are dropped, which only makes the retry time later.
+    long long ticketsAhead(const Ticket& ticket) const {
+        long long ahead = 0;
+        for (const Lane& lane : lanes) {
+            if (lane.priority < ticket.priority) ahead += lane.issued - lane.departed;
+            if (lane.priority == ticket.priority) ahead += ticket.place - lane.departed;
+        }
+        return ahead;
+    }
+
+public:
+    AdmissionController(double systemBurst, double systemRate, double userBurstSize, double userRatePerSecond,
+                        int queueLimit)
+        : systemBucket(systemBurst, systemRate, 0), nextSeq(0), userBurst(userBurstSize),
+          userRate(userRatePerSecond), maxQueue(queueLimit) {}
+
+    // Adds or moves the window for a roll-number prefix
+    void setWindow(const string& rollPrefix, double opensAt) {
+        for (RegistrationWindow& window : windows) {
+            if (window.rollPrefix == rollPrefix) {
+                window.opensAt = opensAt;
+                return;
+            }
+        }
+        windows.push_back({rollPrefix, opensAt});
+    }
+
+    const vector<RegistrationWindow>& getWindows() const { return windows; }
+
+    // Longest matching prefix wins; students outside every window may register any time
+    const RegistrationWindow* windowFor(const string& rollNo) const {
+        const RegistrationWindow* best = nullptr;
+        for (const RegistrationWindow& window : windows) {
+            if (rollNo.compare(0, window.rollPrefix.length(), window.rollPrefix) == 0 &&
+                (best == nullptr || window.rollPrefix.length() > best->rollPrefix.length())) {
+                best = &window;
+            }
+        }
+        return best;
+    }
+
+    AdmissionDecision admit(const string& username, const string& rollNo, double now) {
+        const RegistrationWindow* window = windowFor(rollNo);
+        if (window != nullptr && now < window->opensAt) {
+            stats.windowClosed++;
+            return {Admission::WindowClosed, window->opensAt};
+        }
+
+        TokenBucket* bucket = userBuckets.search(username);
+        if (bucket == nullptr) {
+            userBuckets.insert(username, TokenBucket(userBurst, userRate, now));
+            bucket = userBuckets.search(username);
+        }
+        if (!bucket->tryTake(now)) {
+            stats.rateLimited++;
+            return {Admission::RateLimited, now + bucket->secondsUntil(1.0)};
+        }
+
+        dropStale(now);
+        systemBucket.refill(now);
+        Ticket* ticket = tickets.search(username);
+
+        if (ticket == nullptr) {
+            if (line.isEmpty() && systemBucket.tryTake(now)) {
+                stats.admitted++;
+                return {Admission::Admitted, now};
+            }
+            if (line.size() >= maxQueue) {
+                stats.shed++;
+                return {Admission::Shed, now + systemBucket.secondsUntil(line.size() + 1.0)};
+            }
+            // Students outside every window queue behind all windowed cohorts
+            double priority = window != nullptr ? window->opensAt : DBL_MAX;
+            tickets.insert(username, Ticket(nextSeq, priority, laneFor(priority)->issued++, now));
+            line.push({priority, nextSeq, username});
+            nextSeq++;
+            ticket = tickets.search(username);
+            stats.queued++;
+            stats.peakDepth = max(stats.peakDepth, line.size());
+        } else if (line.top().username == username && systemBucket.tryTake(now)) {
+            double latency = now - ticket->issuedAt;
+            tickets.remove(username);
+            popHead();
+            stats.admitted++;
+            stats.totalLatency += latency;
+            stats.maxLatency = max(stats.maxLatency, latency);
+            stats.latencySamples++;
+            return {Admission::Admitted, now};
+        }
+
+        double retryAt = now + systemBucket.secondsUntil(ticketsAhead(*ticket) + 1.0);
+        ticket->expiresAt = retryAt + TICKET_GRACE_SECONDS;
+        return {Admission::Queued, retryAt};
+    }
+
+    // Drops a deleted account's bucket and ticket. Its entry stays in the heap
+    // until it reaches the head, where dropStale sees no live ticket behind it.
+    void forget(const string& username) {
+        userBuckets.remove(username);
+        tickets.remove(username);
+    }
+
+    int queueDepth() const { return tickets.size(); }
+
+    // Buckets and tickets are the records; the heap and window list index them
+    MemoryStats memoryUsage() const {
+        MemoryStats stats = userBuckets.memoryUsage();
+        stats += tickets.memoryUsage();
+        stats.addIndex(line.memoryUsage());
+        MemoryStats laneList;
+        heapUsage(lanes, laneList);
+        stats.addIndex(laneList);
+        MemoryStats windowList;
+        heapUsage(windows, windowList);
+        stats.addIndex(windowList);
+        return stats;
+    }
+    const AdmissionMetrics& metrics() const { return stats; }
+};
+
+#endif
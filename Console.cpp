@@ -0,0 +1,867 @@
+#include "Console.h"
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+
+// Local wall-clock time the given number of seconds from now, as HH:MM:SS
+string formatClockTime(double secondsFromNow) {
+    auto at = chrono::system_clock::now() + chrono::milliseconds(static_cast<long long>(secondsFromNow * 1000));
+    time_t t = chrono::system_clock::to_time_t(chrono::time_point_cast<chrono::seconds>(at + chrono::milliseconds(999)));
+    tm local{};
+    localtime_r(&t, &local);
+    ostringstream out;
+    out << put_time(&local, "%H:%M:%S");
+    return out.str();
+}
+
+string joinPrerequisites(const vector<string>& prereqs) {
+    if (prereqs.empty()) return "None";
+    string text;
+    for (const string& prereq : prereqs) text += (text.empty() ? "" : ", ") + prereq;
+    return text;
+}
+
+string describeAction(const UserAction& action) {
+    switch (action.type) {
+        case ActionType::Enroll: return "enrollment in " + action.target;
+        case ActionType::Drop: return "drop of " + action.target;
+        case ActionType::VoidPayment: return "void of payment " + action.target;
+    }
+    return action.target;
+}
+
+// The message for a status on its own; operations whose wording depends on
+// what was asked handle those statuses before falling back to this
+string statusMessage(Status status) {
+    switch (status) {
+        case Status::Ok: return "Done.";
+        case Status::ReadOnlyReplica: return "This is a read-only replica. Please make changes on the primary instance.";
+        case Status::NotLoggedIn: return "Please login first!";
+        case Status::AdminRequired: return "Access denied! Admin privileges required.";
+        case Status::AdminNotAllowed: return "Administrators cannot do that!";
+        case Status::AccessDenied: return "Access denied!";
+        case Status::InvalidCredentials: return "Invalid credentials.";
+        case Status::ShardUnavailable: return "That part of the catalog is not answering. Please try again later.";
+        case Status::WindowClosed: return "Registration is not open for your roll number yet.";
+        case Status::RateLimited: return "Too many requests.";
+        case Status::Queued: return "Registration is busy. You are in the queue.";
+        case Status::Shed: return "Registration is at capacity.";
+        case Status::EmptyUsername: return "Error: Username cannot be empty!";
+        case Status::EmptyPassword: return "Error: Password cannot be empty!";
+        case Status::PasswordTooShort: return "Error: Password must be at least 3 characters long!";
+        case Status::EmptyFullName: return "Error: Full name cannot be empty!";
+        case Status::EmptyRollNo: return "Error: Roll number cannot be empty!";
+        case Status::UsernameHasSpaces: return "Error: Username cannot contain spaces!";
+        case Status::UsernameTaken: return "Error: Username already exists!";
+        case Status::RollNoTaken: return "Error: User with this Roll No already exists!";
+        case Status::UserNotFound: return "User not found!";
+        case Status::StudentNotFound: return "Student not found!";
+        case Status::CannotDeleteSelf: return "Cannot delete your own account!";
+        case Status::CourseNotFound: return "Course not found!";
+        case Status::AlreadyEnrolled: return "You are already enrolled in this course!";
+        case Status::AlreadyCompleted: return "You have already completed this course!";
+        case Status::NotEnrolled: return "You are not enrolled in this course!";
+        case Status::PrerequisitesMissing: return "You have not completed the prerequisites for this course!";
+        case Status::ScheduleConflict: return "Schedule conflict!";
+        case Status::CreditLimitExceeded: return "Credit limit exceeded!";
+        case Status::CreditMinimum: return "Cannot drop below the minimum credit hours!";
+        case Status::NoSeats: return "No seats available!";
+        case Status::AlreadyHeld: return "You already hold a seat in this course!";
+        case Status::NoHold: return "You have no active hold on this course!";
+        case Status::NothingToUndo: return "No action to undo!";
+        case Status::NoLongerApplies: return "That action no longer applies.";
+        case Status::EmptyCourseCode: return "Error: Course code cannot be empty!";
+        case Status::CourseCodeTooLong:
+            return "Error: Course code cannot exceed " + to_string(CourseKey::MAX_LENGTH) + " characters!";
+        case Status::CourseCodeHasNul: return "Error: Course code cannot contain a NUL character!";
+        case Status::EmptyCourseName: return "Error: Course name cannot be empty!";
+        case Status::CreditHoursNotPositive: return "Error: Credit hours must be a positive number!";
+        case Status::CreditHoursTooHigh: return "Error: Credit hours cannot exceed 6!";
+        case Status::SeatsNotPositive: return "Error: Total seats must be a positive number!";
+        case Status::SeatsBelowTaken: return "Error: Total seats cannot be fewer than the seats already taken!";
+        case Status::InvalidMeetingTimes:
+            return "Error: Invalid meeting times! Use day letters MTWRF and hours 8-20, e.g. MWF 9-10;TR 13-15";
+        case Status::CourseExists: return "Error: Course with this code already exists!";
+        case Status::CourseNameExists: return "Error: Course with this name already exists!";
+        case Status::EmptyDepartment: return "Error: Department cannot be empty!";
+        case Status::EmptyRollNoPrefix: return "Error: Roll number prefix cannot be empty!";
+        case Status::NoMatches: return "Nothing matched!";
+        case Status::InvalidHoldDuration: return "Error: Hold duration must be between 1 minute and 24 hours!";
+        case Status::InvalidCreditLimits:
+            return "Error: Credit limits must satisfy 0 <= minimum <= maximum, with a positive maximum!";
+        case Status::InvalidWindow: return "Error: Window must open within 30 days!";
+        case Status::EmptyPrerequisite: return "Error: Prerequisite code cannot be empty!";
+        case Status::PrerequisiteNotFound: return "Error: Prerequisite course does not exist!";
+        case Status::SelfPrerequisite: return "Error: A course cannot be its own prerequisite!";
+        case Status::PrerequisiteExists: return "Error: This prerequisite already exists for the course!";
+        case Status::CircularPrerequisite: return "Error: Circular dependency detected!";
+        case Status::InvalidTermName:
+            return "Error: Term names use letters, digits, '-' and '_' (at most 32 characters)!";
+        case Status::TermExists: return "Error: That term already exists!";
+        case Status::NoPreferenceRound: return "No preference round is open right now.";
+        case Status::RoundAlreadyOpen: return "A preference round is already open.";
+        case Status::PreferenceCount:
+            return "Error: Rank between 1 and " + to_string(MAX_PREFERENCES) + " courses!";
+        case Status::DuplicatePreference: return "Error: A course is ranked twice!";
+        case Status::NoAudit: return "Error: No readable lottery audit found!";
+        case Status::EmptyTransactionId: return "Error: Transaction ID cannot be empty!";
+        case Status::AmountNotPositive: return "Error: Amount must be a positive number!";
+        case Status::AmountTooHigh: return "Error: Amount exceeds maximum limit!";
+        case Status::TransactionExists: return "Error: Transaction ID already exists!";
+        case Status::PaymentNotFound: return "Payment record not found!";
+        case Status::MalformedRecord: return "Error: Expected transactionId,username,amount,Completed|Voided!";
+        case Status::NotVoidable: return "Only completed payments can be voided!";
+        case Status::CannotOpenFile: return "Error: Cannot open file!";
+    }
+    return "Error!";
+}
+
+// Failures that carry details of their own, then the plain message
+void printFailure(const Outcome& outcome) {
+    switch (outcome.status) {
+        case Status::WindowClosed:
+            cout << "Registration is not open for your roll number yet. Try again at "
+                 << formatClockTime(outcome.waitSeconds) << ".\n";
+            return;
+        case Status::RateLimited:
+            cout << "Too many requests. Try again at " << formatClockTime(outcome.waitSeconds) << ".\n";
+            return;
+        case Status::Queued:
+            cout << "Registration is busy. You are in the queue; try again at " << formatClockTime(outcome.waitSeconds)
+                 << ".\n";
+            return;
+        case Status::Shed:
+            cout << "Registration is at capacity. Try again at " << formatClockTime(outcome.waitSeconds) << ".\n";
+            return;
+        case Status::PrerequisitesMissing:
+            cout << statusMessage(outcome.status) << "\n";
+            if (!outcome.items.empty()) {
+                cout << "Prerequisites: ";
+                for (const string& p : outcome.items) cout << p << " ";
+                cout << "\n";
+            }
+            return;
+        case Status::ScheduleConflict:
+            cout << "Schedule conflict! " << outcome.subject << " meets at " << outcome.detail
+                 << ", overlapping one of your courses.\n";
+            return;
+        case Status::CreditLimitExceeded:
+            cout << "Credit limit exceeded! " << outcome.subject << " would bring you to " << outcome.count
+                 << " of a maximum " << outcome.limit << " credit hours.\n";
+            return;
+        case Status::CreditMinimum:
+            cout << "Cannot drop " << outcome.subject << ": you must keep at least " << outcome.limit
+                 << " credit hours.\n";
+            return;
+        case Status::SeatsBelowTaken:
+            cout << "Error: " << outcome.subject << " has " << outcome.limit
+                 << " seats taken; total seats cannot be fewer than that!\n";
+            return;
+        default:
+            cout << statusMessage(outcome.status) << "\n";
+    }
+}
+
+// Prints message on success, the failure otherwise; adminRefusal replaces the
+// generic text when an administrator tries a student-only operation
+void report(const Outcome& outcome, const string& message, const char* adminRefusal = nullptr) {
+    if (outcome.ok()) {
+        cout << message;
+    } else if (outcome.status == Status::AdminNotAllowed && adminRefusal != nullptr) {
+        cout << adminRefusal << "\n";
+    } else {
+        printFailure(outcome);
+    }
+}
+
+void printCourseList(const vector<CourseView>& courses, CourseOrder order) {
+    if (courses.empty()) {
+        cout << "No courses available.\n";
+        return;
+    }
+
+    if (order == CourseOrder::ByCode) {
+        cout << "\n--- All Courses (Sorted by Code) ---\n";
+    } else {
+        cout << "\n--- All Courses (Sorted by Name) ---\n";
+    }
+
+    for (const CourseView& course : courses) {
+        cout << "Code: " << course.code
+             << " | Name: " << course.name
+             << " | Credit Hours: " << course.creditHours
+             << " | Times: " << formatSchedule(course.timeSlots)
+             << " | Available Seats: " << course.availableSeats
+             << "/" << course.totalSeats
+             << " | Prerequisites: " << joinPrerequisites(course.prerequisites) << "\n";
+    }
+}
+
+void printCourseDetails(const optional<CourseView>& course) {
+    if (!course) {
+        cout << "Course not found!\n";
+        return;
+    }
+    cout << "\n--- Course Details ---\n";
+    cout << "Code: " << course->code << "\n";
+    cout << "Name: " << course->name << "\n";
+    cout << "Credit Hours: " << course->creditHours << "\n";
+    cout << "Meeting Times: " << formatSchedule(course->timeSlots) << "\n";
+    cout << "Available Seats: " << course->availableSeats << "/" << course->totalSeats << "\n";
+    cout << "Prerequisites: " << joinPrerequisites(course->prerequisites) << "\n";
+}
+
+void printHistory(const Result<StudentRecord>& result) {
+    if (!result.ok()) {
+        report(result.status, "", "Administrators do not have enrollment history!");
+        return;
+    }
+    const StudentRecord& record = result.value;
+    cout << "\n--- My Enrolled Courses ---\n";
+    for (const CourseView& course : record.courses) {
+        cout << "Code: " << course.code << " | Name: " << course.name
+             << " | Times: " << formatSchedule(course.timeSlots) << "\n";
+    }
+    if (record.courses.empty()) {
+        cout << "No enrollments yet.\n";
+    }
+    cout << "Total Credit Hours: " << record.creditHours << " (allowed "
+         << record.minCreditHours << "-" << record.maxCreditHours << ")\n";
+}
+
+void printEligible(const Result<vector<CourseView>>& result) {
+    if (!result.ok()) {
+        report(result.status, "", "Administrators cannot enroll in courses!");
+        return;
+    }
+    cout << "\n--- Courses You Can Enroll In ---\n";
+    for (const CourseView& course : result.value) {
+        cout << "Code: " << course.code
+             << " | Name: " << course.name
+             << " | Credit Hours: " << course.creditHours
+             << " | Times: " << formatSchedule(course.timeSlots)
+             << " | Available Seats: " << course.availableSeats << "/" << course.totalSeats << "\n";
+    }
+    if (result.value.empty()) {
+        cout << "No eligible courses right now.\n";
+    }
+}
+
+void printDegreePlan(const Result<DegreePlan>& result, const string& username, const string& target) {
+    if (result.status == Status::AccessDenied) {
+        cout << "Access denied! You can only plan your own courses.\n";
+        return;
+    }
+    if (result.status == Status::AlreadyEnrolled) {
+        cout << username << " is already enrolled in " << target << ".\n";
+        return;
+    }
+    if (result.status == Status::AlreadyCompleted) {
+        cout << username << " has already completed " << target << ".\n";
+        return;
+    }
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+
+    const DegreePlan& plan = result.value;
+    cout << "\n--- Degree Plan: " << target << " for " << username << " (max "
+         << plan.maxCredits << " credit hours per term) ---\n";
+    if (!plan.feasible) {
+        cout << "No plan possible: " << plan.problem << ".\n";
+        return;
+    }
+    for (size_t term = 0; term < plan.terms.size(); term++) {
+        cout << "Term " << term + 1 << ": ";
+        for (size_t i = 0; i < plan.terms[term].size(); i++) {
+            cout << plan.terms[term][i] << (i < plan.terms[term].size() - 1 ? ", " : "");
+        }
+        cout << " | " << plan.termCredits[term] << " credit hours\n";
+    }
+}
+
+void printUndo(const Result<UserAction>& result, bool redo) {
+    const char* verb = redo ? "redo" : "undo";
+    switch (result.status) {
+        case Status::Ok:
+            cout << (redo ? "Redo successful! Reapplied " : "Undo successful! Reverted ")
+                 << describeAction(result.value) << "\n";
+            break;
+        case Status::NoLongerApplies:
+            cout << "Cannot " << verb << " " << describeAction(result.value) << ": it no longer applies.\n";
+            break;
+        case Status::NothingToUndo:
+            cout << "No action to " << verb << "!\n";
+            break;
+        case Status::AdminNotAllowed:
+            cout << (redo ? "Redo" : "Undo") << " is not available for administrators!\n";
+            break;
+        default:
+            printFailure(result.status);
+    }
+}
+
+void printPaymentStatus(const Result<Payment>& result) {
+    if (result.status == Status::AccessDenied) {
+        cout << "Access denied! You can only view your own payments.\n";
+        return;
+    }
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    const Payment& payment = result.value;
+    cout << "\n--- Payment Details ---\n";
+    cout << "Transaction ID: " << payment.transactionId << "\n";
+    cout << "User: " << payment.username << "\n";
+    cout << "Amount: $" << payment.amount << "\n";
+    cout << "Status: " << payment.status << "\n";
+}
+
+void printPaymentHistory(const Result<PaymentHistory>& result, const string& username) {
+    if (result.status == Status::AccessDenied) {
+        cout << "Access denied! You can only view your own payments.\n";
+        return;
+    }
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    const PaymentHistory& history = result.value;
+    if (history.payments.empty()) {
+        cout << "No payments found for " << username << ".\n";
+        return;
+    }
+
+    cout << "\n--- Payments for " << username << " ---\n";
+    for (const Payment& payment : history.payments) {
+        cout << payment.transactionId << " | $" << payment.amount << " | " << payment.status << "\n";
+    }
+    const PaymentStats& totals = history.totals;
+    cout << "Completed: " << totals.completedCount << " ($" << totals.completedAmount << "), Voided: "
+         << totals.voidedCount << " ($" << totals.voidedAmount << ")\n";
+}
+
+void printReconciliation(const Result<ReconciliationReport>& result, const string& filename) {
+    if (result.status == Status::CannotOpenFile) {
+        cout << "Error: Cannot open " << filename << "!\n";
+        return;
+    }
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    const ReconciliationReport& r = result.value;
+    cout << "Reconciled " << r.lines << " line(s): " << r.added << " new, " << r.updated << " status change(s), "
+         << r.unchanged << " already matching.\n";
+    if (r.mismatched > 0) cout << r.mismatched << " line(s) disagree on username or amount and were skipped.\n";
+    if (r.rejected > 0) {
+        cout << r.rejected << " line(s) rejected:\n";
+        size_t shown = min<size_t>(r.rejections.size(), 20);
+        for (size_t i = 0; i < shown; i++) {
+            cout << "  Line " << r.rejections[i].first << ": " << statusMessage(r.rejections[i].second) << "\n";
+        }
+        if (shown < r.rejections.size()) cout << "  ... and " << r.rejections.size() - shown << " more.\n";
+    }
+    cout << fixed << setprecision(1) << "Took " << r.seconds * 1000 << " ms ("
+         << (r.seconds > 0 ? r.lines / r.seconds : 0.0) << " lines/s).\n" << defaultfloat << setprecision(6);
+}
+
+void printUsers(const Result<vector<UserView>>& result) {
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    cout << "\n--- All Users ---\n";
+    for (const UserView& user : result.value) {
+        cout << "Username: " << user.username
+             << " | Name: " << user.fullName
+             << " | Roll No: " << user.rollNo
+             << " | Type: " << (user.isAdmin ? "Admin" : "Student") << "\n";
+    }
+}
+
+void printRoster(const Result<CourseRoster>& result) {
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    cout << "\n--- Enrollments for " << result.value.courseName << " ---\n";
+    for (const UserView& user : result.value.students) {
+        cout << "Username: " << user.username
+             << " | Name: " << user.fullName
+             << " | Roll No: " << user.rollNo << "\n";
+    }
+    if (result.value.students.empty()) {
+        cout << "No enrollments yet.\n";
+    }
+}
+
+void printAllEnrollments(const Result<EnrollmentSnapshot>& result) {
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    cout << "\n--- All Enrollments ---\n";
+    const EnrollmentSnapshot& snapshot = result.value;
+
+    // Chunks are formatted in parallel and written in order, so the output is unchanged
+    const size_t CHUNK_ROWS = 4096;
+    int chunks = static_cast<int>((snapshot->size() + CHUNK_ROWS - 1) / CHUNK_ROWS);
+    vector<string> text(chunks);
+    sharedTaskPool().run(chunks, [&snapshot, &text, CHUNK_ROWS](int chunk) {
+        ostringstream out;
+        size_t end = min(snapshot->size(), (chunk + 1) * CHUNK_ROWS);
+        for (size_t i = chunk * CHUNK_ROWS; i < end; i++) {
+            const EnrollmentRow& row = (*snapshot)[i];
+            out << "Student: " << row.fullName
+                << " | Course: " << row.courseName
+                << " (" << row.courseCode << ")\n";
+        }
+        text[chunk] = out.str();
+    });
+    for (const string& part : text) cout << part;
+    if (snapshot->empty()) {
+        cout << "No enrollments yet.\n";
+    }
+}
+
+void printPrerequisite(Status status, const string& course, const string& prereq) {
+    switch (status) {
+        case Status::Ok: cout << "Prerequisite added successfully!\n"; break;
+        case Status::CourseNotFound: cout << "Error: Course '" << course << "' does not exist!\n"; break;
+        case Status::PrerequisiteNotFound:
+            cout << "Error: Prerequisite course '" << prereq << "' does not exist!\n";
+            break;
+        case Status::CircularPrerequisite:
+            cout << "Error: Circular dependency detected! '" << prereq << "' already requires '" << course << "'.\n";
+            break;
+        default: printFailure(status);
+    }
+}
+
+void printReplication(const Result<ReplicationStatus>& result) {
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    const ReplicationStatus& r = result.value;
+    cout << "\n--- Replication Status ---\n";
+    if (!r.replica) {
+        cout << "Role: Primary\n";
+        cout << "Journal records written: " << r.lastRecord << "\n";
+        return;
+    }
+    cout << "Role: Read replica (max staleness " << r.maxStalenessMs << " ms)\n";
+    cout << "Last applied record: " << r.lastRecord << "\n";
+    cout << "Records behind primary: " << r.pending << "\n";
+    cout << "Apply lag of last record: " << r.applyLagMs << " ms\n";
+    cout << "Last sync: " << r.sinceSyncMs << " ms ago\n";
+}
+
+void printDashboard(const Result<Dashboard>& result) {
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    const Dashboard& d = result.value;
+    cout << "\n--- Registration Dashboard ---\n";
+    cout << "Payments completed: " << d.payments.completedCount
+         << " (Total: $" << d.payments.completedAmount << ")\n";
+    cout << "Payments voided: " << d.payments.voidedCount
+         << " (Total: $" << d.payments.voidedAmount << ")\n";
+
+    cout << "\nDepartment | Courses | Seats | Enrolled | Students\n";
+    for (const auto& [department, stats] : d.departments) {
+        cout << department << " | " << stats.courses << " | " << stats.totalSeats
+             << " | " << stats.enrollments << " | " << stats.students << "\n";
+    }
+
+    cout << "\nCourse | Enrolled/Seats | Fill\n";
+    for (const CourseFill& course : d.courses) {
+        int fill = course.totalSeats > 0 ? course.enrolled * 100 / course.totalSeats : 0;
+        cout << course.code << " | " << course.enrolled << "/" << course.totalSeats << " | " << fill << "%\n";
+    }
+
+    cout << "\nStudent | Courses | Credit Hours\n";
+    for (const auto& [username, load] : d.students) {
+        cout << username << " | " << load.courses << " | " << load.creditHours << "\n";
+    }
+}
+
+void printAdmission(const Result<AdmissionReport>& result) {
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    const AdmissionMetrics& m = result.value.metrics;
+    cout << "\n--- Admission Control ---\n";
+    cout << "Queue depth: " << result.value.queueDepth << " (peak " << m.peakDepth << ")\n";
+    cout << "Admitted: " << m.admitted << ", Tickets issued: " << m.queued << ", Expired: " << m.expired << "\n";
+    cout << "Refused - Rate limited: " << m.rateLimited << ", Window closed: " << m.windowClosed
+         << ", Shed: " << m.shed << "\n";
+    cout << fixed << setprecision(3);
+    cout << "Queued admission latency: avg "
+         << (m.latencySamples > 0 ? m.totalLatency / m.latencySamples : 0.0) << " s, max " << m.maxLatency << " s\n";
+    cout << defaultfloat << setprecision(6);
+
+    if (result.value.windows.empty()) {
+        cout << "No registration windows; registration is open to everyone.\n";
+        return;
+    }
+    cout << "Windows:\n";
+    for (const WindowView& window : result.value.windows) {
+        cout << "  " << window.rollPrefix << "*  "
+             << (window.opensIn <= 0 ? "open since " : "opens at ") << formatClockTime(window.opensIn) << "\n";
+    }
+}
+
+void printLottery(const Result<LotteryReport>& result) {
+    if (result.status == Status::NoPreferenceRound) {
+        cout << "Error: Open a preference round first!\n";
+        return;
+    }
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    const LotteryReport& r = result.value;
+    cout << "Lottery seed " << r.seed << ": " << r.assigned << " seat(s) assigned out of "
+         << r.requested << " ranked request(s) from " << r.students << " student(s) in "
+         << r.elapsedMs << " ms.\n";
+    if (r.refused > 0) cout << r.refused << " drawn seat(s) could no longer be filled and were left out.\n";
+    cout << "Audit written to lottery_audit.txt (digest " << hex << r.digest << dec << ").\n";
+}
+
+void printLotteryCheck(const Result<LotteryCheck>& result) {
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    const LotteryCheck& c = result.value;
+    cout << "Replayed lottery seed " << c.seed << " over " << c.students << " student(s): "
+         << c.assigned << " seat(s) assigned.\n";
+    if (c.replayDigest == c.recordedDigest) {
+        cout << "Digest " << hex << c.replayDigest << dec << " matches the recorded run.\n";
+    } else {
+        cout << "MISMATCH: recorded digest " << hex << c.recordedDigest << ", replay gives " << c.replayDigest
+             << dec << ".\n";
+    }
+}
+
+void printMemoryReport(const Result<MemoryReport>& result) {
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    cout << "\n--- Memory Report (bytes) ---\n";
+    cout << "Structure | Records | Payload | Overhead | Allocations | Per record\n";
+    MemoryStats sum;
+    for (const auto& [name, stats] : result.value.rows) {
+        cout << name << " | " << stats.nodes << " | " << stats.payloadBytes << " | " << stats.overheadBytes << " | "
+             << stats.allocations << " | "
+             << (stats.nodes > 0 ? (stats.payloadBytes + stats.overheadBytes) / stats.nodes : 0) << "\n";
+        sum += stats;
+    }
+    cout << "Total | " << sum.nodes << " | " << sum.payloadBytes << " | " << sum.overheadBytes << " | "
+         << sum.allocations << " |\n";
+    cout << "Overhead assumes " << ALLOCATION_HEADER << " bytes of allocator bookkeeping per block.\n";
+
+    if (result.value.heapTracked) {
+        const HeapCounters& heap = result.value.heap;
+        cout << "Tracked heap: " << heap.liveBytes << " bytes in " << heap.liveAllocations
+             << " live allocation(s), " << heap.totalAllocations << " since startup.\n";
+    } else {
+        cout << "Build with CRS_TRACK_ALLOCATIONS=ON to compare against the real heap.\n";
+    }
+}
+
+void printTermReport(const Result<TermReport>& result) {
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    const TermReport& r = result.value;
+    cout << "\n--- Terms ---\n";
+    cout << "Active term: " << r.activeTerm << "\n";
+    if (r.archived.empty()) {
+        cout << "No closed terms yet.\n";
+        return;
+    }
+    cout << "Term | Students | Enrollments | Bytes | Access\n";
+    for (const TermSummary& term : r.archived) {
+        if (!term.readable) {
+            cout << term.term << " | archive missing or damaged\n";
+            continue;
+        }
+        cout << term.term << " | " << term.students << " | " << term.enrollments << " | " << term.bytes << " | "
+             << (term.mapped ? "mapped" : "read") << "\n";
+    }
+}
+
+void printTranscript(const Result<Transcript>& result, const string& username) {
+    if (result.status == Status::AccessDenied) {
+        cout << "Access denied! You can only view your own transcript.\n";
+        return;
+    }
+    if (!result.ok()) {
+        printFailure(result.status);
+        return;
+    }
+    const Transcript& transcript = result.value;
+    if (transcript.terms.empty()) {
+        cout << "No completed courses for " << username << ".\n";
+        return;
+    }
+
+    cout << "\n--- Transcript for " << username << " ---\n";
+    for (const TranscriptTerm& term : transcript.terms) {
+        cout << term.term << ": ";
+        for (size_t i = 0; i < term.courses.size(); i++) {
+            cout << term.courses[i].first << " (" << term.courses[i].second << ")"
+                 << (i < term.courses.size() - 1 ? ", " : "");
+        }
+        cout << " | " << term.creditHours << " credit hours\n";
+    }
+    cout << "Total: " << transcript.creditHours << " credit hours completed.\n";
+}
+
+}
+
+bool runConsoleOp(CourseRegistrationSystem& sys, SessionToken& session, const TraceRecord& record) {
+    const vector<string>& a = record.args;
+    auto arg = [&a](size_t i) -> const string& {
+        static const string missing;
+        return i < a.size() ? a[i] : missing;
+    };
+
+    switch (record.op) {
+        case TraceOp::Login: {
+            Result<LoginSession> login = sys.login(arg(0), arg(1));
+            if (!login.ok()) return false; // The login menu says so
+            session = login.value.token;
+            const UserView& user = login.value.user;
+            cout << "Login successful! Welcome, " << user.fullName << "\n";
+            cout << (user.isAdmin ? "Logged in as Administrator.\n" : "Logged in as Student.\n");
+            return true;
+        }
+        case TraceOp::Logout:
+            if (sys.logout(session) == Status::Ok) cout << "Logged out successfully.\n";
+            break;
+        case TraceOp::RegisterUser:
+            report(sys.registerUser(arg(0), arg(1), arg(2), arg(3)), "Registration successful! You can now login.\n");
+            break;
+        case TraceOp::ViewAllCourses: {
+            CourseOrder order = static_cast<CourseOrder>(stoi(arg(0)));
+            printCourseList(sys.listCourses(order), order);
+            break;
+        }
+        case TraceOp::SearchCourse: printCourseDetails(sys.findCourse(arg(0))); break;
+        case TraceOp::EnrollCourse: {
+            Outcome enrolled = sys.enrollCourse(session, arg(0));
+            report(enrolled, "Successfully enrolled in " + enrolled.subject + "!\n",
+                   "Administrators cannot enroll in courses!");
+            break;
+        }
+        case TraceOp::DropCourse: {
+            Outcome dropped = sys.dropCourse(session, arg(0));
+            report(dropped, "Dropped " + dropped.subject + ".\n", "Administrators cannot drop courses!");
+            break;
+        }
+        case TraceOp::ViewMyHistory: printHistory(sys.myEnrollments(session)); break;
+        case TraceOp::UndoLastAction: printUndo(sys.undoLastAction(session), false); break;
+        case TraceOp::RedoLastAction: printUndo(sys.redoLastAction(session), true); break;
+        case TraceOp::ProcessPayment:
+            report(sys.processPayment(session, arg(0), stod(arg(1))),
+                   "Payment processed successfully! Transaction ID: " + arg(0) + "\n");
+            break;
+        case TraceOp::VoidPayment: {
+            Status voided = sys.voidPayment(session, arg(0));
+            if (voided == Status::AccessDenied) {
+                cout << "Access denied! You can only void your own payments.\n";
+            } else {
+                report(voided, "Payment " + arg(0) + " voided.\n", "Administrators cannot void payments!");
+            }
+            break;
+        }
+        case TraceOp::ViewPaymentStatus: printPaymentStatus(sys.paymentStatus(session, arg(0))); break;
+        case TraceOp::HoldSeat: {
+            Outcome held = sys.holdSeat(session, arg(0));
+            report(held, "Seat held in " + held.subject + " for " + to_string(held.count) +
+                         " minute(s). Confirm it before it expires.\n",
+                   "Administrators cannot hold seats!");
+            break;
+        }
+        case TraceOp::ConfirmHold: {
+            Outcome confirmed = sys.confirmHold(session, arg(0));
+            report(confirmed, "Successfully enrolled in " + confirmed.subject + "!\n");
+            break;
+        }
+        case TraceOp::ReleaseHold: report(sys.releaseHold(session, arg(0)), "Seat hold released.\n"); break;
+        case TraceOp::ViewEligibleCourses: printEligible(sys.eligibleCourses(session)); break;
+        case TraceOp::ViewDegreePlan: printDegreePlan(sys.degreePlan(session, arg(0), arg(1)), arg(0), arg(1)); break;
+        case TraceOp::SubmitPreferences: {
+            Outcome saved = sys.submitPreferences(session, a);
+            if (saved.status == Status::CourseNotFound) {
+                cout << "Course " << saved.subject << " not found!\n";
+            } else if (saved.status == Status::DuplicatePreference) {
+                cout << "Error: " << saved.subject << " is ranked twice!\n";
+            } else {
+                report(saved, "Preferences saved (" + to_string(saved.count) +
+                              " course(s)). Seats are assigned when the lottery runs.\n",
+                       "Administrators cannot enroll in courses!");
+            }
+            break;
+        }
+        case TraceOp::ViewPayments: printPaymentHistory(sys.paymentHistory(session, arg(0)), arg(0)); break;
+        case TraceOp::AddCourse:
+            report(sys.addCourse(session, arg(0), arg(1), stoi(arg(2)), stoi(arg(3)), arg(4)), "Course added successfully!\n");
+            break;
+        case TraceOp::DeleteCourse: report(sys.deleteCourse(session, arg(0)), "Course deleted successfully!\n"); break;
+        case TraceOp::UpdateCourse: {
+            Outcome updated = sys.updateCourse(session, arg(0), arg(1), stoi(arg(2)), stoi(arg(3)), arg(4));
+            if (updated.ok() && !updated.detail.empty()) {
+                cout << "Error: Invalid meeting times! Keeping " << updated.detail << ".\n";
+            }
+            report(updated, "Course updated successfully!\n");
+            break;
+        }
+        case TraceOp::ViewAllUsers: printUsers(sys.allUsers(session)); break;
+        case TraceOp::DeleteUser: report(sys.deleteUser(session, arg(0)), "User deleted successfully!\n"); break;
+        case TraceOp::ViewCourseEnrollments: printRoster(sys.courseEnrollments(session, arg(0))); break;
+        case TraceOp::ViewAllEnrollments: printAllEnrollments(sys.allEnrollments(session)); break;
+        case TraceOp::AddPrerequisite: printPrerequisite(sys.addPrerequisite(session, arg(0), arg(1)), arg(0), arg(1)); break;
+        case TraceOp::RetireDepartment: {
+            Outcome retired = sys.retireDepartment(session, arg(0));
+            if (retired.status == Status::NoMatches) {
+                cout << "No courses found for department " << retired.subject << "!\n";
+            } else {
+                report(retired, "Retired " + to_string(retired.count) + " course(s) from department " +
+                                retired.subject + ".\n");
+            }
+            break;
+        }
+        case TraceOp::RemoveCohort: {
+            Outcome removed = sys.removeCohort(session, arg(0));
+            if (removed.status == Status::NoMatches) {
+                cout << "No students found with roll number prefix " << removed.subject << "!\n";
+            } else {
+                report(removed, "Removed " + to_string(removed.count) + " student(s) with roll number prefix " +
+                                removed.subject + ".\n");
+            }
+            break;
+        }
+        case TraceOp::SetHoldDuration:
+            report(sys.setHoldDuration(session, stoi(arg(0))), "New seat holds will last " + arg(0) + " minute(s).\n");
+            break;
+        case TraceOp::ViewReplicationStatus: printReplication(sys.replicationStatus(session)); break;
+        case TraceOp::ViewStatistics: printDashboard(sys.statistics(session)); break;
+        case TraceOp::SetCreditLimits:
+            report(sys.setCreditLimits(session, stoi(arg(0)), stoi(arg(1))),
+                   "Students may now carry " + arg(0) + " to " + arg(1) + " credit hours.\n");
+            break;
+        case TraceOp::SetRegistrationWindow: {
+            Outcome set = sys.setRegistrationWindow(session, arg(0), stoi(arg(1)));
+            report(set, "Registration for roll numbers starting with " + set.subject + " opens at " +
+                        formatClockTime(set.waitSeconds) + ".\n");
+            break;
+        }
+        case TraceOp::ViewAdmissionMetrics: printAdmission(sys.admissionMetrics(session)); break;
+        case TraceOp::OpenPreferenceRound: {
+            Outcome opened = sys.openPreferenceRound(session);
+            if (opened.status == Status::RoundAlreadyOpen) {
+                cout << "A preference round is already open (" << opened.count << " student(s) so far).\n";
+            } else {
+                report(opened, "Preference round opened. Students can now rank up to " + to_string(opened.limit) +
+                               " courses.\n");
+            }
+            break;
+        }
+        case TraceOp::RunSeatLottery: printLottery(sys.runSeatLottery(session, stoull(arg(0)))); break;
+        case TraceOp::VerifyLotteryAudit: printLotteryCheck(sys.verifyLotteryAudit(session)); break;
+        case TraceOp::ImportReconciliation: printReconciliation(sys.importReconciliation(session, arg(0)), arg(0)); break;
+        case TraceOp::ViewMemoryReport: printMemoryReport(sys.memoryReport(session)); break;
+        case TraceOp::CloseTerm: {
+            Outcome closed = sys.closeTerm(session, arg(0));
+            report(closed, "Closed term " + closed.subject + ": " + to_string(closed.count) +
+                           " enrollment(s) archived. Term " + closed.detail + " is now open.\n");
+            break;
+        }
+        case TraceOp::ViewTermArchives: printTermReport(sys.termArchives(session)); break;
+        case TraceOp::ViewTranscript: printTranscript(sys.transcript(session, arg(0)), arg(0)); break;
+        case TraceOp::RecountSeats: {
+            Outcome recounted = sys.recountSeats(session);
+            report(recounted, recounted.count == 0 ? string("Seat counts are consistent.\n")
+                                                   : "Corrected open seats for " + to_string(recounted.count) +
+                                                         " course(s).\n");
+            break;
+        }
+        case TraceOp::ExportEnrollments: {
+            Outcome exported = sys.exportEnrollments(session, arg(0));
+            report(exported, "Exported " + to_string(exported.count) + " enrollment(s) to " + exported.subject + ".\n");
+            break;
+        }
+        case TraceOp::ViewDepartmentStats: {
+            Result<DepartmentStats> stats = sys.departmentStatistics(session, arg(0));
+            if (stats.status == Status::NoMatches) {
+                cout << "No courses found for department " << arg(0) << "!\n";
+            } else if (!stats.ok()) {
+                printFailure(stats.status);
+            } else {
+                cout << arg(0) << ": " << stats.value.courses << " course(s), " << stats.value.totalSeats
+                     << " seat(s), " << stats.value.enrollments << " enrollment(s) from " << stats.value.students
+                     << " student(s)\n";
+            }
+            break;
+        }
+        case TraceOp::ViewCourseStats: {
+            Result<CourseFill> fill = sys.courseStatistics(session, arg(0));
+            if (!fill.ok()) {
+                printFailure(fill.status);
+            } else {
+                int percent = fill.value.totalSeats > 0 ? fill.value.enrolled * 100 / fill.value.totalSeats : 0;
+                cout << fill.value.code << ": " << fill.value.enrolled << "/" << fill.value.totalSeats << " enrolled ("
+                     << percent << "%)\n";
+            }
+            break;
+        }
+        case TraceOp::ViewStudentStats: {
+            Result<StudentLoad> load = sys.studentStatistics(session, arg(0));
+            if (!load.ok()) {
+                printFailure(load.status);
+            } else {
+                cout << arg(0) << ": " << load.value.courses << " course(s), " << load.value.creditHours
+                     << " credit hour(s)\n";
+            }
+            break;
+        }
+        case TraceOp::Count: break;
+    }
+    return true;
+}
+
+int printReplay(const string& path, const Result<ReplayReport>& result) {
+    if (!result.ok()) {
+        cout << "Error: " << path << " is not a readable trace!\n";
+        return 1;
+    }
+    const ReplayReport& r = result.value;
+    cout << "\n--- Trace Replay (" << (r.paced ? "original pacing" : "as fast as possible") << ") ---\n";
+    cout << fixed << setprecision(1);
+    cout << "Replayed " << r.replayed << " call(s) from " << r.sessions << " session(s) in " << r.wallMs << " ms (startup " << r.startupMs << " ms)\n";
+    cout << "Operation | Calls | Total ms | Mean us | p50 us | p99 us | Max us\n";
+    for (const OpTiming& op : r.ops) {
+        cout << traceOpName(op.op) << " | " << op.calls << " | " << op.totalMs << " | " << op.meanMicros << " | "
+             << op.p50Micros << " | " << op.p99Micros << " | " << op.maxMicros;
+        if (op.malformed > 0) cout << " (" << op.malformed << " malformed)";
+        cout << "\n";
+    }
+    cout << defaultfloat << setprecision(6);
+    return 0;
+}
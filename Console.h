@@ -0,0 +1,19 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "System.h"
+#include "Trace.h"
+
+// Console front end over the core library: runs the API call behind a menu
+// action and prints what came back. Nothing else writes to the terminal
+// on the system's behalf.
+
+// Runs the operation as session. A successful login stores its token there.
+// Returns whether a login succeeded, true for every other operation;
+// a failed login prints nothing so the caller can word it
+bool runConsoleOp(CourseRegistrationSystem& sys, SessionToken& session, const TraceRecord& record);
+
+// Prints a replay's per-operation timings; returns the process exit code
+int printReplay(const string& path, const Result<ReplayReport>& result);
+
+#endif
@@ -2,15 +2,103 @@
 #define DATASTRUCTURES_H
 
 #include "Models.h"
-#include <iostream>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <vector>
 
+// Memory accounting for the containers below. Payload is the records
+// themselves, including heap memory owned by their strings and vectors.
+// Overhead is what a container adds on top: links, keys, bucket arrays and
+// an estimated allocator header for every block it allocates.
+struct MemoryStats {
+    size_t nodes = 0;
+    size_t payloadBytes = 0;
+    size_t overheadBytes = 0;
+    size_t allocations = 0;
+
+    MemoryStats& operator+=(const MemoryStats& other) {
+        nodes += other.nodes;
+        payloadBytes += other.payloadBytes;
+        overheadBytes += other.overheadBytes;
+        allocations += other.allocations;
+        return *this;
+    }
+
+    // Folds in a structure that only indexes records counted elsewhere
+    void addIndex(const MemoryStats& index) {
+        overheadBytes += index.payloadBytes + index.overheadBytes;
+        allocations += index.allocations;
+    }
+};
+
+const size_t ALLOCATION_HEADER = 16; // Typical 64-bit malloc bookkeeping and rounding per block
+
+// heapUsage() adds the heap memory a value owns beyond its own sizeof
+template <typename T>
+void heapUsage(const T&, MemoryStats&) {}
+
+inline void heapUsage(const string& text, MemoryStats& stats) {
+    static const size_t inlineCapacity = string().capacity(); // Short strings live inside the object
+    if (text.capacity() <= inlineCapacity) return;
+    stats.payloadBytes += text.capacity() + 1;
+    stats.overheadBytes += ALLOCATION_HEADER;
+    stats.allocations++;
+}
+
+inline void heapUsage(const User& user, MemoryStats& stats) {
+    heapUsage(user.getUsername(), stats);
+    heapUsage(user.getPassword(), stats);
+    heapUsage(user.getFullName(), stats);
+    heapUsage(user.getRollNo(), stats);
+}
+
+inline void heapUsage(const Course& course, MemoryStats& stats) {
+    heapUsage(course.getName(), stats);
+}
+
+inline void heapUsage(const Enrollment& enrollment, MemoryStats& stats) {
+    heapUsage(enrollment.username, stats);
+    heapUsage(enrollment.courseCode, stats);
+}
+
+inline void heapUsage(const UserAction& action, MemoryStats& stats) {
+    heapUsage(action.target, stats);
+}
+
+inline void heapUsage(const Payment& payment, MemoryStats& stats) {
+    heapUsage(payment.transactionId, stats);
+    heapUsage(payment.username, stats);
+    heapUsage(payment.status, stats);
+}
+
+template <typename T>
+void heapUsage(const vector<T>& items, MemoryStats& stats) {
+    if (items.capacity() == 0) return;
+    stats.payloadBytes += items.size() * sizeof(T);
+    stats.overheadBytes += (items.capacity() - items.size()) * sizeof(T) + ALLOCATION_HEADER;
+    stats.allocations++;
+    for (const T& item : items) heapUsage(item, stats);
+}
+
+// One heap-allocated node holding a T: the record is payload, the rest is overhead
+template <typename T, typename NodeType>
+void countNode(const T& data, MemoryStats& stats) {
+    stats.nodes++;
+    stats.payloadBytes += sizeof(T);
+    stats.overheadBytes += sizeof(NodeType) - sizeof(T) + ALLOCATION_HEADER;
+    stats.allocations++;
+    heapUsage(data, stats);
+}
+
 // Node for Linked List (for User storage)
 template <typename T>
 struct Node {
     T data;
     Node* next;
-    explicit Node(T d) : data(d), next(nullptr) {}
+    Node* prev; // Lets a node known by its address be unlinked in O(1)
+    template <typename... Args>
+    explicit Node(Args&&... args) : data(std::forward<Args>(args)...), next(nullptr), prev(nullptr) {}
 };
 
 // Linked List class
@@ -18,9 +106,10 @@ template <typename T>
 class LinkedList {
 private:
     Node<T>* head;
+    Node<T>* tail; // Appends are O(1), so bulk loads stay linear
 
 public:
-    LinkedList() : head(nullptr) {}
+    LinkedList() : head(nullptr), tail(nullptr) {}
 
     ~LinkedList() {
         Node<T>* current = head;
@@ -31,22 +120,49 @@ public:
         }
     }
 
-    void insert(T data) {
-        auto* newNode = new Node<T>(data);
+    // Returns the stored record; it stays put until its node is removed
+    T* insert(T data) {
+        return emplace(std::move(data));
+    }
+
+    // Builds the record in place inside its node
+    template <typename... Args>
+    T* emplace(Args&&... args) {
+        return &(append(std::forward<Args>(args)...)->data);
+    }
+
+    // Like emplace, but returns the node, a handle for erase()
+    template <typename... Args>
+    Node<T>* append(Args&&... args) {
+        auto* newNode = new Node<T>(std::forward<Args>(args)...);
         if (head == nullptr) {
             head = newNode;
         } else {
-            Node<T>* current = head;
-            while (current->next != nullptr) {
-                current = current->next;
-            }
-            current->next = newNode;
+            tail->next = newNode;
+            newNode->prev = tail;
         }
+        tail = newNode;
+        return newNode;
+    }
+
+    // Unlinks and frees a node of this list in O(1)
+    void erase(Node<T>* node) {
+        (node->prev ? node->prev->next : head) = node->next;
+        (node->next ? node->next->prev : tail) = node->prev;
+        delete node;
     }
 
     Node<T>* getHead() { return head; }
 
-    T* search(string key, bool (*comparator)(const T&, const string&)) {
+    MemoryStats memoryUsage() const {
+        MemoryStats stats;
+        for (Node<T>* current = head; current != nullptr; current = current->next) {
+            countNode<T, Node<T>>(current->data, stats);
+        }
+        return stats;
+    }
+
+    T* search(const string& key, bool (*comparator)(const T&, const string&)) {
         Node<T>* current = head;
         while (current != nullptr) {
             if (comparator(current->data, key)) {
@@ -57,28 +173,40 @@ public:
         return nullptr;
     }
 
-    bool remove(string key, bool (*comparator)(const T&, const string&)) {
+    bool remove(const string& key, bool (*comparator)(const T&, const string&)) {
         if (head == nullptr) return false;
 
-        if (comparator(head->data, key)) {
-            Node<T>* temp = head;
-            head = head->next;
-            delete temp;
-            return true;
-        }
-
-        Node<T>* current = head;
-        while (current->next != nullptr) {
-            if (comparator(current->next->data, key)) {
-                Node<T>* temp = current->next;
-                current->next = current->next->next;
-                delete temp;
+        for (Node<T>* current = head; current != nullptr; current = current->next) {
+            if (comparator(current->data, key)) {
+                erase(current);
                 return true;
             }
-            current = current->next;
         }
         return false;
     }
+
+    // Unlinks every node matching shouldRemove in a single pass.
+    // onRemove sees each record just before its node is freed.
+    template <typename Pred, typename Visit>
+    int removeIf(Pred shouldRemove, Visit onRemove) {
+        int removed = 0;
+        Node<T>** link = &head;
+        tail = nullptr;
+        while (*link != nullptr) {
+            Node<T>* current = *link;
+            if (shouldRemove(current->data)) {
+                onRemove(current->data);
+                *link = current->next;
+                delete current;
+                removed++;
+            } else {
+                current->prev = tail;
+                tail = current;
+                link = &(current->next);
+            }
+        }
+        return removed;
+    }
 };
 
 // Stack for Undo functionality
@@ -88,7 +216,7 @@ private:
     struct StackNode {
         T data;
         StackNode* next;
-        explicit StackNode(T d) : data(d), next(nullptr) {}
+        explicit StackNode(T d) : data(std::move(d)), next(nullptr) {}
     };
     StackNode* top;
 
@@ -104,14 +232,14 @@ public:
     }
 
     void push(T data) {
-        auto* newNode = new StackNode(data);
+        auto* newNode = new StackNode(std::move(data));
         newNode->next = top;
         top = newNode;
     }
 
     bool pop(T& data) {
         if (top == nullptr) return false;
-        data = top->data;
+        data = std::move(top->data);
         StackNode* temp = top;
         top = top->next;
         delete temp;
@@ -121,6 +249,59 @@ public:
     bool isEmpty() {
         return top == nullptr;
     }
+
+    MemoryStats memoryUsage() const {
+        MemoryStats stats;
+        for (StackNode* current = top; current != nullptr; current = current->next) {
+            countNode<T, StackNode>(current->data, stats);
+        }
+        return stats;
+    }
+};
+
+// Fixed-capacity ring buffer used as a bounded stack (per-user undo/redo).
+// Pushing onto a full buffer overwrites the oldest entry.
+template <typename T, int CAPACITY>
+class RingBuffer {
+private:
+    T items[CAPACITY];
+    int start; // Index of the oldest entry
+    int count;
+
+public:
+    RingBuffer() : start(0), count(0) {}
+
+    void push(const T& data) {
+        if (count == CAPACITY) {
+            items[start] = data;
+            start = (start + 1) % CAPACITY;
+        } else {
+            items[(start + count) % CAPACITY] = data;
+            count++;
+        }
+    }
+
+    bool pop(T& data) {
+        if (count == 0) return false;
+        count--;
+        data = items[(start + count) % CAPACITY];
+        return true;
+    }
+
+    void clear() {
+        start = 0;
+        count = 0;
+    }
+
+    bool isEmpty() const {
+        return count == 0;
+    }
+
+    // Live entries, oldest first
+    template <typename Func>
+    void forEach(Func visit) const {
+        for (int i = 0; i < count; i++) visit(items[(start + i) % CAPACITY]);
+    }
 };
 
 // Queue for Waitlist
@@ -130,7 +311,7 @@ private:
     struct QueueNode {
         T data;
         QueueNode* next;
-        explicit QueueNode(T d) : data(d), next(nullptr) {}
+        explicit QueueNode(T d) : data(std::move(d)), next(nullptr) {}
     };
     QueueNode* front;
     QueueNode* rear;
@@ -147,7 +328,7 @@ public:
     }
 
     void enqueue(T data) {
-        auto* newNode = new QueueNode(data);
+        auto* newNode = new QueueNode(std::move(data));
         if (rear == nullptr) {
             front = rear = newNode;
             return;
@@ -159,7 +340,7 @@ public:
     bool dequeue(T& data) {
         if (front == nullptr) return false;
         QueueNode* temp = front;
-        data = temp->data;
+        data = std::move(temp->data);
         front = front->next;
         if (front == nullptr) rear = nullptr;
         delete temp;
@@ -169,34 +350,116 @@ public:
     bool isEmpty() {
         return front == nullptr;
     }
+
+    MemoryStats memoryUsage() const {
+        MemoryStats stats;
+        for (QueueNode* current = front; current != nullptr; current = current->next) {
+            countNode<T, QueueNode>(current->data, stats);
+        }
+        return stats;
+    }
+};
+
+// Binary min-heap; Less orders the entries and the smallest sits at top()
+template <typename T, typename Less>
+class MinHeap {
+private:
+    vector<T> items;
+    Less less;
+
+    void siftUp(size_t i) {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!less(items[i], items[parent])) break;
+            swap(items[i], items[parent]);
+            i = parent;
+        }
+    }
+
+    void siftDown(size_t i) {
+        while (true) {
+            size_t smallest = i;
+            size_t left = 2 * i + 1, right = left + 1;
+            if (left < items.size() && less(items[left], items[smallest])) smallest = left;
+            if (right < items.size() && less(items[right], items[smallest])) smallest = right;
+            if (smallest == i) return;
+            swap(items[i], items[smallest]);
+            i = smallest;
+        }
+    }
+
+public:
+    void push(T item) {
+        items.push_back(std::move(item));
+        siftUp(items.size() - 1);
+    }
+
+    const T& top() const { return items.front(); }
+
+    void pop() {
+        items.front() = std::move(items.back());
+        items.pop_back();
+        if (!items.empty()) siftDown(0);
+    }
+
+    bool isEmpty() const { return items.empty(); }
+    int size() const { return static_cast<int>(items.size()); }
+
+    // Unordered view of every entry
+    const vector<T>& entries() const { return items; }
+
+    MemoryStats memoryUsage() const {
+        MemoryStats stats;
+        heapUsage(items, stats);
+        stats.nodes = items.size();
+        return stats;
+    }
 };
 
 // Hash Table for User/Payment lookup
+// Chained buckets; the bucket array doubles once the table is full, so lookups
+// stay O(1) on average from a handful of payments up to millions of seat holds.
 template <typename T>
 class HashTable {
 private:
-    static const int TABLE_SIZE = 100;
+    static const int INITIAL_SIZE = 128; // Power of two, so hashing can mask
     struct HashNode {
         string key;
         T value;
         HashNode* next;
-        HashNode(string k, T v) : key(std::move(k)), value(v), next(nullptr) {}
+        HashNode(string k, T v) : key(std::move(k)), value(std::move(v)), next(nullptr) {}
     };
-    HashNode* table[TABLE_SIZE];
+    vector<HashNode*> table;
+    int count;
 
-    int hashFunction(const string& key) {
-        int hash = 0;
+    size_t hashFunction(string_view key) const {
+        size_t hash = 0;
         for (char c : key) {
-            hash = (hash * 31 + c) % TABLE_SIZE;
+            hash = hash * 31 + static_cast<unsigned char>(c);
         }
-        return hash;
+        return hash & (table.size() - 1);
     }
 
-public:
-    HashTable() {
-        for (auto & i : table) i = nullptr;
+    void grow() {
+        vector<HashNode*> old(table.size() * 2, nullptr);
+        old.swap(table);
+        for (HashNode* current : old) {
+            while (current != nullptr) {
+                HashNode* next = current->next;
+                size_t index = hashFunction(current->key);
+                current->next = table[index];
+                table[index] = current;
+                current = next;
+            }
+        }
     }
 
+public:
+    HashTable() : table(INITIAL_SIZE, nullptr), count(0) {}
+
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
+
     ~HashTable() {
         for (auto & current : table) {
             while (current != nullptr) {
@@ -208,14 +471,33 @@ public:
     }
 
     void insert(string key, T value) {
-        int index = hashFunction(key);
-        auto* newNode = new HashNode(std::move(key), value);
+        if (count >= static_cast<int>(table.size())) grow();
+        size_t index = hashFunction(key);
+        auto* newNode = new HashNode(std::move(key), std::move(value));
         newNode->next = table[index];
         table[index] = newNode;
+        count++;
     }
 
-    T* search(string key) {
-        int index = hashFunction(key);
+    bool remove(string_view key) {
+        size_t index = hashFunction(key);
+        HashNode** link = &table[index];
+        while (*link != nullptr) {
+            if ((*link)->key == key) {
+                HashNode* temp = *link;
+                *link = temp->next;
+                delete temp;
+                count--;
+                return true;
+            }
+            link = &((*link)->next);
+        }
+        return false;
+    }
+
+    // Keys are looked up as views, so a code read out of a course needs no copy
+    T* search(string_view key) {
+        size_t index = hashFunction(key);
         HashNode* current = table[index];
         while (current != nullptr) {
             if (current->key == key) return &(current->value);
@@ -223,6 +505,180 @@ public:
         }
         return nullptr;
     }
+
+    // Finds the value for key, inserting a default-constructed one if missing
+    T* searchOrInsert(string_view key) {
+        T* existing = search(key);
+        if (existing != nullptr) return existing;
+        insert(string(key), T());
+        return search(key);
+    }
+
+    int size() const { return count; }
+
+    // Visit every stored value (bucket order)
+    template <typename Func>
+    void forEach(Func visit) {
+        for (HashNode* current : table) {
+            while (current != nullptr) {
+                visit(current->value);
+                current = current->next;
+            }
+        }
+    }
+
+    // Keys count as overhead: they index the values
+    MemoryStats memoryUsage() const {
+        MemoryStats stats;
+        for (HashNode* current : table) {
+            for (; current != nullptr; current = current->next) {
+                countNode<T, HashNode>(current->value, stats);
+                MemoryStats key;
+                heapUsage(current->key, key);
+                stats.addIndex(key);
+            }
+        }
+        stats.overheadBytes += table.capacity() * sizeof(HashNode*) + ALLOCATION_HEADER;
+        stats.allocations++;
+        return stats;
+    }
+};
+
+// Hierarchical Timing Wheel for expiring timers (seat holds)
+// LEVELS wheels of 64 slots; a slot on level L spans 64^L ticks. Timers are
+// doubly linked into their slot, so schedule and cancel are O(1). Advancing
+// the clock only visits the current slot, and a far-off timer is cascaded
+// down at most LEVELS - 1 times before it fires.
+template <typename T>
+class TimingWheel {
+private:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4; // Covers 64^4 ticks (about 194 days at one tick per second)
+
+public:
+    struct Timer {
+        T data;
+        uint64_t expiry;
+        Timer* prev;
+        Timer* next;
+        Timer** slot; // Head pointer of the slot this timer is filed under
+        Timer(T d, uint64_t e) : data(std::move(d)), expiry(e), prev(nullptr), next(nullptr), slot(nullptr) {}
+    };
+
+private:
+    Timer* slots[LEVELS][SLOTS];
+    uint64_t now;
+    int count;
+
+    void link(Timer* timer) {
+        uint64_t delta = timer->expiry - now;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+        uint64_t maxExpiry = now + (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+        uint64_t when = timer->expiry < maxExpiry ? timer->expiry : maxExpiry;
+        Timer*& head = slots[level][(when >> (SLOT_BITS * level)) & (SLOTS - 1)];
+        timer->prev = nullptr;
+        timer->next = head;
+        timer->slot = &head;
+        if (head != nullptr) head->prev = timer;
+        head = timer;
+    }
+
+    void unlink(Timer* timer) {
+        if (timer->prev != nullptr) {
+            timer->prev->next = timer->next;
+        } else {
+            *(timer->slot) = timer->next;
+        }
+        if (timer->next != nullptr) timer->next->prev = timer->prev;
+    }
+
+    // Re-files every timer in a higher-level slot now that it is within reach
+    void cascade(int level) {
+        Timer*& head = slots[level][(now >> (SLOT_BITS * level)) & (SLOTS - 1)];
+        Timer* current = head;
+        head = nullptr;
+        while (current != nullptr) {
+            Timer* next = current->next;
+            link(current);
+            current = next;
+        }
+    }
+
+public:
+    explicit TimingWheel(uint64_t start = 0) : now(start), count(0) {
+        for (auto& level : slots) {
+            for (auto& head : level) head = nullptr;
+        }
+    }
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    ~TimingWheel() {
+        for (auto& level : slots) {
+            for (Timer* current : level) {
+                while (current != nullptr) {
+                    Timer* temp = current;
+                    current = current->next;
+                    delete temp;
+                }
+            }
+        }
+    }
+
+    // Timers due at or before the current tick fire on the next advance
+    Timer* schedule(T data, uint64_t expiry) {
+        auto* timer = new Timer(std::move(data), expiry > now ? expiry : now + 1);
+        link(timer);
+        count++;
+        return timer;
+    }
+
+    void cancel(Timer* timer) {
+        unlink(timer);
+        delete timer;
+        count--;
+    }
+
+    // Moves the clock forward to target, calling onExpire for every due timer
+    template <typename Func>
+    void advance(uint64_t target, Func onExpire) {
+        while (now < target) {
+            now++;
+            for (int level = 1; level < LEVELS; level++) {
+                if ((now & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0) break;
+                cascade(level);
+            }
+            Timer*& head = slots[0][now & (SLOTS - 1)];
+            while (head != nullptr) {
+                Timer* timer = head;
+                head = timer->next;
+                if (head != nullptr) head->prev = nullptr;
+                count--;
+                onExpire(timer->data);
+                delete timer;
+            }
+        }
+    }
+
+    uint64_t currentTick() const { return now; }
+    int size() const { return count; }
+
+    // The slot arrays are part of the wheel itself and count as overhead
+    MemoryStats memoryUsage() const {
+        MemoryStats stats;
+        for (const auto& level : slots) {
+            for (Timer* current : level) {
+                for (; current != nullptr; current = current->next) countNode<T, Timer>(current->data, stats);
+            }
+        }
+        stats.overheadBytes += sizeof(slots);
+        return stats;
+    }
 };
 
 // BST Node for Course storage
@@ -238,12 +694,12 @@ class BST {
 private:
     BSTNode* root;
 
-    static BSTNode* searchHelper(BSTNode* node, const string& code) {
+    static BSTNode* searchHelper(BSTNode* node, const CourseKey& key) {
         while (node != nullptr) {
-            if (node->data.getCode() == code) {
+            if (node->data.getKey() == key) {
                 return node;
             }
-            if (code < node->data.getCode()) {
+            if (key < node->data.getKey()) {
                 node = node->left;
             } else {
                 node = node->right;
@@ -284,15 +740,16 @@ public:
             root = new BSTNode(course);
             return;
         }
+        const CourseKey& key = course.getKey();
         BSTNode* current = root;
         while (true) {
-            if (course.getCode() < current->data.getCode()) {
+            if (key < current->data.getKey()) {
                 if (current->left == nullptr) {
                     current->left = new BSTNode(course);
                     break;
                 }
                 current = current->left;
-            } else if (course.getCode() > current->data.getCode()) {
+            } else if (current->data.getKey() < key) {
                 if (current->right == nullptr) {
                     current->right = new BSTNode(course);
                     break;
@@ -304,48 +761,23 @@ public:
         }
     }
 
-    Course* search(const string& code) {
-        BSTNode* result = searchHelper(root, code);
+    Course* search(string_view code) {
+        if (!CourseKey::fits(code)) return nullptr;
+        BSTNode* result = searchHelper(root, CourseKey(code));
         return result ? &(result->data) : nullptr;
     }
 
-    void displayInorder() {
-        if (root == nullptr) {
-            cout << "No courses available.\n";
-            return;
-        }
-
-        std::vector<BSTNode*> stack;
-        BSTNode* curr = root;
-
-        while (curr != nullptr || !stack.empty()) {
-            while (curr != nullptr) {
-                stack.push_back(curr);
-                curr = curr->left;
-            }
-            curr = stack.back();
-            stack.pop_back();
-
-            cout << "Code: " << curr->data.getCode()
-                 << " | Name: " << curr->data.getName()
-                 << " | Credit Hours: " << curr->data.getCreditHours()
-                 << " | Available Seats: " << curr->data.getAvailableSeats()
-                 << "/" << curr->data.getTotalSeats() << "\n";
-
-            curr = curr->right;
-        }
-    }
-
-    bool deleteCourse(const string& code) {
-        if (root == nullptr) return false;
+    bool deleteCourse(string_view code) {
+        if (root == nullptr || !CourseKey::fits(code)) return false;
 
+        CourseKey key(code);
         BSTNode* parent = nullptr;
         BSTNode* current = root;
 
         // Find node
-        while (current != nullptr && current->data.getCode() != code) {
+        while (current != nullptr && current->data.getKey() != key) {
             parent = current;
-            if (code < current->data.getCode()) {
+            if (key < current->data.getKey()) {
                 current = current->left;
             } else {
                 current = current->right;
@@ -388,6 +820,366 @@ public:
     }
 
     BSTNode* getRoot() { return root; }
+
+    // Visit every course in code order
+    template <typename Func>
+    void forEachInorder(Func visit) const {
+        std::vector<BSTNode*> stack;
+        BSTNode* curr = root;
+        while (curr != nullptr || !stack.empty()) {
+            while (curr != nullptr) {
+                stack.push_back(curr);
+                curr = curr->left;
+            }
+            curr = stack.back();
+            stack.pop_back();
+            visit(curr->data);
+            curr = curr->right;
+        }
+    }
+
+    MemoryStats memoryUsage() const {
+        MemoryStats stats;
+        forEachInorder([&stats](const Course& course) { countNode<Course, BSTNode>(course, stats); });
+        return stats;
+    }
+};
+
+// Course catalog partitioned in memory by department prefix ("CS", "MATH", ...).
+// Each shard owns its courses and the enrollments in them, so per-course work
+// only walks one department, and a prerequisite lookup goes straight to the
+// prerequisite's own shard. These shards live in one process; ShardRouter
+// (ShardRouter.h) splits departments across worker processes instead.
+class ShardedCatalog {
+public:
+    struct Shard {
+        string department;
+        BST courses;
+        LinkedList<Enrollment> enrollments;
+        HashTable<Node<Enrollment>*> enrollmentNodes; // "user:course" -> its node in enrollments
+        HashTable<int> studentCourses; // Username -> their enrollments here; its size is the distinct students
+        explicit Shard(string d) : department(std::move(d)) {}
+    };
+
+    static string enrollmentKey(const string& username, const string& code) {
+        return username + ":" + code;
+    }
+
+    // A student enters the count with their first course in the department and leaves with their last
+    static void countStudent(Shard& shard, const string& username, int delta) {
+        int* courses = shard.studentCourses.searchOrInsert(username);
+        *courses += delta;
+        if (*courses <= 0) shard.studentCourses.remove(username);
+    }
+
+private:
+    vector<Shard*> shards; // Sorted by department, so walking them keeps code order
+
+    vector<Shard*>::iterator lowerBound(const string& department) {
+        size_t lo = 0, hi = shards.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (shards[mid]->department < department) lo = mid + 1;
+            else hi = mid;
+        }
+        return shards.begin() + static_cast<long>(lo);
+    }
+
+    Shard* shardFor(string_view code, bool create) {
+        string department = departmentOf(code);
+        auto it = lowerBound(department);
+        if (it != shards.end() && (*it)->department == department) return *it;
+        if (!create) return nullptr;
+        return *shards.insert(it, new Shard(department));
+    }
+
+public:
+    ShardedCatalog() = default;
+    ShardedCatalog(const ShardedCatalog&) = delete;
+    ShardedCatalog& operator=(const ShardedCatalog&) = delete;
+
+    ~ShardedCatalog() {
+        for (Shard* shard : shards) delete shard;
+    }
+
+    Shard* getShard(const string& department) {
+        auto it = lowerBound(department);
+        return (it != shards.end() && (*it)->department == department) ? *it : nullptr;
+    }
+
+    void insert(const Course& course) {
+        shardFor(course.getCode(), true)->courses.insert(course);
+    }
+
+    Course* search(string_view code) {
+        Shard* shard = shardFor(code, false);
+        return shard ? shard->courses.search(code) : nullptr;
+    }
+
+    // Drops the department's shard once it holds nothing
+    bool deleteCourse(const string& code) {
+        auto it = lowerBound(departmentOf(code));
+        if (it == shards.end() || (*it)->department != departmentOf(code)) return false;
+        Shard* shard = *it;
+        if (!shard->courses.deleteCourse(code)) return false;
+        if (shard->courses.getRoot() == nullptr && shard->enrollments.getHead() == nullptr) {
+            shards.erase(it);
+            delete shard;
+        }
+        return true;
+    }
+
+    void collectCourses(vector<Course>& courseList) const {
+        for (Shard* shard : shards) {
+            shard->courses.forEachInorder([&courseList](const Course& c) { courseList.push_back(c); });
+        }
+    }
+
+    // False, leaving the catalog as it was, if the student already has the course
+    bool addEnrollment(Enrollment enrollment) {
+        Shard* shard = shardFor(enrollment.courseCode, true);
+        string key = enrollmentKey(enrollment.username, enrollment.courseCode);
+        if (shard->enrollmentNodes.search(key) != nullptr) return false;
+        countStudent(*shard, enrollment.username, 1);
+        shard->enrollmentNodes.insert(std::move(key), shard->enrollments.append(std::move(enrollment)));
+        return true;
+    }
+
+    // O(1): the node is found through the shard's index, not by walking the list
+    bool removeEnrollment(const string& username, const string& code) {
+        Shard* shard = shardFor(code, false);
+        if (shard == nullptr) return false;
+        string key = enrollmentKey(username, code);
+        Node<Enrollment>** node = shard->enrollmentNodes.search(key);
+        if (node == nullptr) return false;
+        shard->enrollments.erase(*node);
+        shard->enrollmentNodes.remove(key);
+        countStudent(*shard, username, -1);
+        return true;
+    }
+
+    // Point lookup used for duplicate and prerequisite checks
+    bool hasEnrollment(const string& username, const string& code) {
+        Shard* shard = shardFor(code, false);
+        return shard != nullptr && shard->enrollmentNodes.search(enrollmentKey(username, code)) != nullptr;
+    }
+
+    // Bulk unlink within one shard, keeping its index in step. Touches nothing
+    // outside the shard, so different shards may be cleared in parallel.
+    template <typename Pred, typename Visit>
+    static int removeEnrollmentsIf(Shard& shard, Pred shouldRemove, Visit onRemove) {
+        return shard.enrollments.removeIf(shouldRemove, [&shard, &onRemove](const Enrollment& e) {
+            shard.enrollmentNodes.remove(enrollmentKey(e.username, e.courseCode));
+            countStudent(shard, e.username, -1);
+            onRemove(e);
+        });
+    }
+
+    int enrollmentCount() const {
+        int count = 0;
+        for (Shard* shard : shards) count += shard->enrollmentNodes.size();
+        return count;
+    }
+
+    int shardCount() const { return static_cast<int>(shards.size()); }
+
+    // Distinct students enrolled in the department, O(1)
+    int studentsIn(const string& department) {
+        Shard* shard = getShard(department);
+        return shard != nullptr ? shard->studentCourses.size() : 0;
+    }
+
+    // Shard bookkeeping is charged to the courses
+    MemoryStats courseMemory() const {
+        MemoryStats stats;
+        for (Shard* shard : shards) {
+            stats += shard->courses.memoryUsage();
+            MemoryStats bookkeeping;
+            heapUsage(shard->department, bookkeeping);
+            bookkeeping.overheadBytes += sizeof(Shard) + ALLOCATION_HEADER;
+            bookkeeping.allocations++;
+            stats.addIndex(bookkeeping);
+        }
+        MemoryStats shardList;
+        heapUsage(shards, shardList);
+        stats.addIndex(shardList);
+        return stats;
+    }
+
+    MemoryStats enrollmentMemory() const {
+        MemoryStats stats;
+        for (Shard* shard : shards) {
+            stats += shard->enrollments.memoryUsage();
+            stats.addIndex(shard->enrollmentNodes.memoryUsage());
+            stats.addIndex(shard->studentCourses.memoryUsage());
+        }
+        return stats;
+    }
+
+    template <typename Func>
+    void forEachShard(Func visit) {
+        for (Shard* shard : shards) visit(*shard);
+    }
+
+    // Empties every shard's enrollment list, visiting each enrollment on its way out
+    template <typename Func>
+    void clearEnrollments(Func visit) {
+        for (Shard* shard : shards) {
+            removeEnrollmentsIf(*shard, [](const Enrollment&) { return true; }, visit);
+        }
+    }
+
+    template <typename Func>
+    void forEachEnrollment(Func visit) {
+        for (Shard* shard : shards) {
+            for (Node<Enrollment>* current = shard->enrollments.getHead(); current != nullptr; current = current->next) {
+                visit(current->data);
+            }
+        }
+    }
+};
+
+// Dense course IDs for bitset queries. Each course gets a small integer ID
+// (reused after deletion), its prerequisites are kept as ID lists, and open
+// seats are one bit per course, so a whole catalog is tested 64 courses per word.
+class CourseIndex {
+private:
+    HashTable<int> ids; // Course code -> ID
+    vector<string> codes; // ID -> course code, empty when the ID is free
+    vector<int> freeIds;
+    vector<vector<int>> prereqIds;
+    vector<vector<int>> dependentIds; // The reverse edges: courses listing this one as a prerequisite
+    vector<uint64_t> open;  // Live courses with a free seat
+    vector<uint64_t> gated; // Live courses with at least one prerequisite
+
+    static void assign(vector<uint64_t>& bits, int id, bool value) {
+        uint64_t mask = uint64_t(1) << (id % 64);
+        if (value) {
+            bits[id / 64] |= mask;
+        } else {
+            bits[id / 64] &= ~mask;
+        }
+    }
+
+public:
+    static bool test(const vector<uint64_t>& bits, int id) {
+        return id / 64 < static_cast<int>(bits.size()) && (bits[id / 64] >> (id % 64)) & 1;
+    }
+
+    // Sets or clears a course's bit in a caller-owned set, growing it as needed
+    static void mark(vector<uint64_t>& bits, int id, bool value) {
+        if (id / 64 >= static_cast<int>(bits.size())) {
+            if (!value) return;
+            bits.resize(id / 64 + 1, 0);
+        }
+        assign(bits, id, value);
+    }
+
+    int idOf(string_view code) {
+        int* id = ids.search(code);
+        return id ? *id : -1;
+    }
+
+    const string& codeOf(int id) const { return codes[id]; }
+
+    int add(string_view code) {
+        int existing = idOf(code);
+        if (existing >= 0) return existing;
+        int id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+            codes[id] = string(code);
+        } else {
+            id = static_cast<int>(codes.size());
+            codes.emplace_back(code);
+            prereqIds.emplace_back();
+            dependentIds.emplace_back();
+            if (id % 64 == 0) {
+                open.push_back(0);
+                gated.push_back(0);
+            }
+        }
+        ids.insert(string(code), id);
+        return id;
+    }
+
+    // Drops the course and every prerequisite edge touching it; the reverse
+    // edges lead straight to the lists to fix, so no other course is visited
+    void remove(string_view code) {
+        int id = idOf(code);
+        if (id < 0) return;
+        ids.remove(code);
+        codes[id].clear();
+        for (int prereq : prereqIds[id]) {
+            vector<int>& list = dependentIds[prereq];
+            list.erase(std::remove(list.begin(), list.end(), id), list.end());
+        }
+        for (int dependent : dependentIds[id]) {
+            vector<int>& list = prereqIds[dependent];
+            list.erase(std::remove(list.begin(), list.end(), id), list.end());
+            if (list.empty()) assign(gated, dependent, false);
+        }
+        prereqIds[id].clear();
+        dependentIds[id].clear();
+        assign(open, id, false);
+        assign(gated, id, false);
+        freeIds.push_back(id);
+    }
+
+    void addPrerequisite(const string& course, const string& prereq) {
+        int id = idOf(course);
+        int prereqId = idOf(prereq);
+        if (id < 0 || prereqId < 0) return;
+        prereqIds[id].push_back(prereqId);
+        dependentIds[prereqId].push_back(id);
+        assign(gated, id, true);
+    }
+
+    void setOpen(string_view code, bool hasSeats) {
+        int id = idOf(code);
+        if (id >= 0) assign(open, id, hasSeats);
+    }
+
+    // IDs of open courses in neither set whose prerequisites are all completed.
+    // Ungated courses are decided a word at a time; only gated ones walk their lists.
+    void eligible(const vector<uint64_t>& enrolled, const vector<uint64_t>& completed, vector<int>& result) const {
+        for (size_t word = 0; word < open.size(); word++) {
+            uint64_t mine = (word < enrolled.size() ? enrolled[word] : 0) |
+                            (word < completed.size() ? completed[word] : 0);
+            uint64_t candidates = open[word] & ~mine;
+            for (uint64_t check = candidates & gated[word]; check != 0; check &= check - 1) {
+                int bit = countr_zero(check);
+                for (int prereq : prereqIds[word * 64 + bit]) {
+                    if (!test(completed, prereq)) {
+                        candidates &= ~(uint64_t(1) << bit);
+                        break;
+                    }
+                }
+            }
+            for (; candidates != 0; candidates &= candidates - 1) {
+                result.push_back(static_cast<int>(word * 64) + countr_zero(candidates));
+            }
+        }
+    }
+
+    // Codes and prerequisite lists are the payload; the code lookup and bitsets index them
+    MemoryStats memoryUsage() const {
+        MemoryStats stats;
+        heapUsage(codes, stats);
+        heapUsage(prereqIds, stats);
+        stats.nodes = ids.size();
+        stats.addIndex(ids.memoryUsage());
+        MemoryStats reverseEdges;
+        heapUsage(dependentIds, reverseEdges);
+        stats.addIndex(reverseEdges);
+        MemoryStats bitsets;
+        heapUsage(open, bitsets);
+        heapUsage(gated, bitsets);
+        heapUsage(freeIds, bitsets);
+        stats.addIndex(bitsets);
+        return stats;
+    }
 };
 
 // Graph for Prerequisites
@@ -466,7 +1258,38 @@ public:
         return true;
     }
 
-    GraphNode* findNode(const string& course) {
+    // Drops every course matching isRemoved, both its own prerequisite list
+    // and any edge pointing at it from other courses, in one pass over the graph
+    template <typename Pred>
+    void removeCoursesIf(Pred isRemoved) {
+        GraphNode** link = &head;
+        while (*link != nullptr) {
+            GraphNode* node = *link;
+            AdjListNode** adjLink = &(node->head);
+            bool dropNode = isRemoved(node->courseCode);
+            while (*adjLink != nullptr) {
+                AdjListNode* adj = *adjLink;
+                if (dropNode || isRemoved(adj->dest)) {
+                    *adjLink = adj->next;
+                    delete adj;
+                } else {
+                    adjLink = &(adj->next);
+                }
+            }
+            if (dropNode) {
+                *link = node->next;
+                delete node;
+            } else {
+                link = &(node->next);
+            }
+        }
+    }
+
+    void removeCourse(const string& course) {
+        removeCoursesIf([&course](const string& code) { return code == course; });
+    }
+
+    GraphNode* findNode(string_view course) {
         GraphNode* current = head;
         while (current != nullptr) {
             if (current->courseCode == course) return current;
@@ -475,7 +1298,7 @@ public:
         return nullptr;
     }
 
-    vector<string> getPrerequisites(const string& course) {
+    vector<string> getPrerequisites(string_view course) {
         vector<string> prereqs;
         GraphNode* node = findNode(course);
         if (node) {
@@ -487,10 +1310,37 @@ public:
         }
         return prereqs;
     }
+
+    // Visit every (course, prerequisite) edge, oldest edge of each course first
+    template <typename Func>
+    void forEachEdge(Func visit) {
+        for (GraphNode* node = head; node != nullptr; node = node->next) {
+            vector<string> prereqs = getPrerequisites(node->courseCode);
+            for (auto it = prereqs.rbegin(); it != prereqs.rend(); ++it) {
+                visit(node->courseCode, *it);
+            }
+        }
+    }
+
+    // One record per edge; the per-course list heads are overhead
+    MemoryStats memoryUsage() const {
+        MemoryStats stats;
+        for (GraphNode* node = head; node != nullptr; node = node->next) {
+            MemoryStats listHead;
+            heapUsage(node->courseCode, listHead);
+            listHead.overheadBytes += sizeof(GraphNode) + ALLOCATION_HEADER;
+            listHead.allocations++;
+            stats.addIndex(listHead);
+            for (AdjListNode* edge = node->head; edge != nullptr; edge = edge->next) {
+                countNode<string, AdjListNode>(edge->dest, stats);
+            }
+        }
+        return stats;
+    }
 };
 
 // KMP Algorithm for String Matching
-inline bool kmpSearch(string text, string pattern) {
+inline bool kmpSearch(string_view text, string_view pattern) {
     int n = static_cast<int>(text.length());
     int m = static_cast<int>(pattern.length());
     if (m == 0) return true;
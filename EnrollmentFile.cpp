@@ -0,0 +1,265 @@
+#include "EnrollmentFile.h"
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+// Blocks are flushed once they reach BLOCK_SIZE, so one never holds more than
+// that plus a name; the reader treats anything larger as damage
+const size_t BLOCK_SIZE = 64 * 1024;
+const size_t MAX_NAME_LENGTH = 32 * 1024;
+const size_t MAX_BLOCK_SIZE = BLOCK_SIZE + MAX_NAME_LENGTH + 32;
+
+// Block packing is a small LZ77: tokens of
+//   literalCount literals [matchLength-MIN_MATCH offset]
+// where the last token carries literals only. Matches are found through a
+// hash of the next four bytes, so packing is one pass with no search.
+const size_t MIN_MATCH = 4;
+const size_t MAX_OFFSET = 65535;
+const int HASH_BITS = 13;
+const uint32_t NO_POSITION = UINT32_MAX;
+
+uint32_t read32(const char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+size_t hash4(uint32_t word) {
+    return (word * 2654435761u) >> (32 - HASH_BITS);
+}
+
+void appendVarint(string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool parseVarint(const char*& p, const char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*p++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+void packBlock(const string& in, string& out) {
+    out.clear();
+    vector<uint32_t> table(size_t(1) << HASH_BITS, NO_POSITION);
+    const char* data = in.data();
+    size_t n = in.size();
+    size_t anchor = 0, i = 0;
+    while (i + MIN_MATCH <= n) {
+        uint32_t word = read32(data + i);
+        uint32_t& slot = table[hash4(word)];
+        size_t candidate = slot;
+        slot = static_cast<uint32_t>(i);
+        if (candidate == NO_POSITION || i - candidate > MAX_OFFSET || read32(data + candidate) != word) {
+            i++;
+            continue;
+        }
+        size_t length = MIN_MATCH;
+        while (i + length < n && data[candidate + length] == data[i + length]) length++;
+        appendVarint(out, i - anchor);
+        out.append(data + anchor, i - anchor);
+        appendVarint(out, length - MIN_MATCH);
+        appendVarint(out, i - candidate);
+        i += length;
+        anchor = i;
+    }
+    appendVarint(out, n - anchor);
+    out.append(data + anchor, n - anchor);
+}
+
+bool unpackBlock(const string& in, size_t rawLength, string& out) {
+    out.clear();
+    out.reserve(rawLength);
+    const char* p = in.data();
+    const char* end = p + in.size();
+    while (true) {
+        uint64_t literals;
+        if (!parseVarint(p, end, literals) || literals > static_cast<size_t>(end - p) ||
+            literals > rawLength - out.size()) {
+            return false;
+        }
+        out.append(p, literals);
+        p += literals;
+        if (out.size() == rawLength) return p == end;
+
+        uint64_t length, offset;
+        if (!parseVarint(p, end, length) || !parseVarint(p, end, offset)) return false;
+        length += MIN_MATCH;
+        if (offset == 0 || offset > out.size() || length > rawLength - out.size()) return false;
+        // Byte by byte: a match may overlap the bytes it is producing
+        size_t from = out.size() - offset;
+        for (size_t k = 0; k < length; k++) out.push_back(out[from + k]);
+    }
+}
+
+}
+
+EnrollmentFileWriter::EnrollmentFileWriter(const string& path, const vector<string>& courseCodes,
+                                           size_t studentCount)
+    : out(path, ios::binary | ios::trunc), studentsLeft(studentCount) {
+    out.write("CRSENROL", 8);
+    writeVarint(1);
+    putVarint(courseCodes.size());
+    for (const string& code : courseCodes) putName(code);
+    previousName.clear();
+    putVarint(studentCount);
+}
+
+void EnrollmentFileWriter::putVarint(uint64_t value) {
+    if (block.size() >= BLOCK_SIZE) flushBlock();
+    appendVarint(block, value);
+}
+
+void EnrollmentFileWriter::putName(const string& name) {
+    size_t shared = 0;
+    size_t limit = min(name.size(), previousName.size());
+    while (shared < limit && name[shared] == previousName[shared]) shared++;
+    putVarint(shared);
+    putVarint(name.size() - shared);
+    if (block.size() >= BLOCK_SIZE) flushBlock();
+    block.append(name, shared, string::npos);
+    previousName = name;
+}
+
+void EnrollmentFileWriter::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+// Stores the block packed when that is smaller, raw otherwise
+void EnrollmentFileWriter::flushBlock() {
+    if (block.empty()) return;
+    packBlock(block, packed);
+    const string& bytes = packed.size() < block.size() ? packed : block;
+    writeVarint(block.size());
+    writeVarint(bytes.size());
+    out.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+    block.clear();
+}
+
+void EnrollmentFileWriter::putStudent(const string& username, const vector<uint32_t>& courseIds) {
+    putName(username);
+    putVarint(courseIds.size());
+    uint32_t previous = 0;
+    for (uint32_t id : courseIds) {
+        putVarint(id - previous);
+        previous = id;
+    }
+    studentsLeft--;
+}
+
+bool EnrollmentFileWriter::finish() {
+    flushBlock();
+    writeVarint(0);
+    out.flush();
+    return studentsLeft == 0 && out.good();
+}
+
+EnrollmentFileReader::EnrollmentFileReader(const string& path)
+    : in(path, ios::binary), pos(0), studentsLeft(0), valid(false) {
+    char magic[8];
+    uint64_t version, courseCount, studentCount;
+    if (!in.read(magic, 8) || string(magic, 8) != "CRSENROL") return;
+    if (!readVarint(version) || version != 1 || !getVarint(courseCount)) return;
+    for (uint64_t i = 0; i < courseCount; i++) {
+        string code;
+        if (!getName(code)) return;
+        courseCodes.push_back(std::move(code));
+    }
+    if (!getVarint(studentCount)) return;
+    previousName.clear();
+    studentsLeft = studentCount;
+    valid = true;
+}
+
+bool EnrollmentFileReader::readVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == EOF) return false;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool EnrollmentFileReader::loadBlock() {
+    uint64_t rawLength, storedLength;
+    if (!readVarint(rawLength) || rawLength == 0 || rawLength > MAX_BLOCK_SIZE) return false;
+    if (!readVarint(storedLength) || storedLength > rawLength) return false;
+    pos = 0;
+    if (storedLength == rawLength) {
+        block.resize(rawLength);
+        return static_cast<bool>(in.read(block.data(), static_cast<streamsize>(rawLength)));
+    }
+    stored.resize(storedLength);
+    if (!in.read(stored.data(), static_cast<streamsize>(storedLength))) return false;
+    return unpackBlock(stored, rawLength, block);
+}
+
+bool EnrollmentFileReader::getVarint(uint64_t& value) {
+    // Most varints sit wholly inside the block and decode in place
+    if (block.size() - pos >= 10) {
+        const char* p = block.data() + pos;
+        if (!parseVarint(p, block.data() + block.size(), value)) return false;
+        pos = p - block.data();
+        return true;
+    }
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos == block.size() && !loadBlock()) return false;
+        uint8_t byte = static_cast<uint8_t>(block[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool EnrollmentFileReader::getName(string& name) {
+    uint64_t shared, suffix;
+    if (!getVarint(shared) || !getVarint(suffix)) return false;
+    if (shared > previousName.size() || suffix > MAX_NAME_LENGTH) return false;
+    name.assign(previousName, 0, shared);
+    while (suffix > 0) {
+        if (pos == block.size() && !loadBlock()) return false;
+        size_t take = min<size_t>(suffix, block.size() - pos);
+        name.append(block, pos, take);
+        pos += take;
+        suffix -= take;
+    }
+    previousName = name;
+    return true;
+}
+
+bool EnrollmentFileReader::next(string& username, vector<uint32_t>& courseIds) {
+    if (!valid || studentsLeft == 0) return false;
+    uint64_t count;
+    if (!getName(username) || !getVarint(count) || count > courseCodes.size()) {
+        valid = false;
+        return false;
+    }
+    courseIds.resize(count);
+    uint64_t id = 0;
+    for (uint32_t& courseId : courseIds) {
+        uint64_t delta;
+        if (!getVarint(delta) || (id += delta) >= courseCodes.size()) {
+            valid = false;
+            return false;
+        }
+        courseId = static_cast<uint32_t>(id);
+    }
+    studentsLeft--;
+    return true;
+}
@@ -0,0 +1,84 @@
+#ifndef ENROLLMENT_FILE_H
+#define ENROLLMENT_FILE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Compact enrollment snapshot (enrollments.dat). Usernames and course codes
+// are each stored once, and every student's courses are a sorted list of
+// course IDs written as varint deltas, so an enrollment costs about a byte.
+//
+// File layout (all integers are LEB128 varints):
+//   "CRSENROL" version
+//   blocks: rawLength storedLength bytes, ending with a block of rawLength 0
+//     (stored bytes are LZ-packed when storedLength < rawLength, raw otherwise)
+// The bytes of all blocks in order form one stream:
+//   courseCount, then per course: name
+//   studentCount, then per student: name idCount firstId delta...
+// A name is front coded against the previous one in its list:
+//   sharedPrefixLength suffixLength suffix
+
+// Enrollments dictionary coded and grouped per student, as the snapshot and
+// the term archives store them
+struct EnrollmentGroups {
+    vector<string> courseCodes;         // Sorted; a course's ID is its index
+    vector<string> usernames;           // Sorted
+    vector<vector<uint32_t>> courseIds; // Per username, sorted
+};
+
+class EnrollmentFileWriter {
+private:
+    ofstream out;
+    string block;        // Stream bytes not yet written
+    string packed;       // Scratch for the packed form of a block
+    string previousName; // Front coding base
+    size_t studentsLeft;
+
+    void putVarint(uint64_t value);
+    void putName(const string& name);
+    void writeVarint(uint64_t value);
+    void flushBlock();
+
+public:
+    // Codes are course IDs' names in ID order; sorted lists front code best
+    EnrollmentFileWriter(const string& path, const vector<string>& courseCodes, size_t studentCount);
+
+    bool isOpen() const { return out.is_open(); }
+
+    // courseIds must be sorted; students go in name order for the best front coding
+    void putStudent(const string& username, const vector<uint32_t>& courseIds);
+
+    // Writes the last block and the end marker; false if anything failed to reach the file
+    bool finish();
+};
+
+class EnrollmentFileReader {
+private:
+    ifstream in;
+    string block;  // Unpacked bytes of the current block
+    string stored; // Scratch for a block as read from the file
+    size_t pos;
+    size_t studentsLeft;
+    string previousName;
+    bool valid;
+
+    bool loadBlock();
+    bool getVarint(uint64_t& value);
+    bool getName(string& name);
+    bool readVarint(uint64_t& value); // Straight from the file, outside any block
+
+public:
+    vector<string> courseCodes; // Course ID -> code
+
+    explicit EnrollmentFileReader(const string& path);
+
+    bool isValid() const { return valid; }
+
+    // False after the last student or at a damaged record
+    bool next(string& username, vector<uint32_t>& courseIds);
+};
+
+#endif
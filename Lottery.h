@@ -0,0 +1,132 @@
+#ifndef LOTTERY_H
+#define LOTTERY_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// Seat lottery for oversubscribed courses.
+// Students rank up to MAX_PREFERENCES courses; allocateSeats() then draws one
+// random order of all students from the seed and deals seats in rounds: every
+// student's first choice is tried before anyone's second, and so on. A choice
+// is granted only if the course has a seat, the student has completed its
+// prerequisites in an earlier term, and it fits their schedule and credit limit. The input is
+// self-contained, so the same input and seed always give the same result.
+
+struct LotteryCourse {
+    string code;
+    int seats; // Seats still open
+    int creditHours;
+    uint64_t timeSlots;
+    vector<int> prerequisites; // Indices into LotteryInput::courses
+};
+
+struct LotteryStudent {
+    string username;
+    int creditHours;
+    uint64_t busySlots;
+    vector<int> taken;       // Courses already enrolled in
+    vector<int> completed;   // Courses passed in earlier terms; prerequisites count only these
+    vector<int> preferences; // Ranked, most wanted first
+};
+
+struct LotteryInput {
+    uint64_t seed;
+    int maxCreditHours;
+    vector<LotteryCourse> courses;
+    vector<LotteryStudent> students;
+};
+
+struct LotteryAssignment {
+    int student;
+    int course;
+};
+
+struct LotteryResult {
+    vector<LotteryAssignment> assignments; // In the order they were granted
+    uint64_t digest; // Fingerprint of the assignments, compared on replay
+};
+
+const int MAX_PREFERENCES = 10;
+
+// splitmix64: small, fast and identical on every platform, unlike the
+// distributions in <random>, so an audit replays bit for bit anywhere
+inline uint64_t lotteryNext(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline LotteryResult allocateSeats(const LotteryInput& input) {
+    int studentCount = static_cast<int>(input.students.size());
+    int courseCount = static_cast<int>(input.courses.size());
+    size_t words = (courseCount + 63) / 64;
+
+    // Fisher-Yates draw of the student order
+    vector<int> order(studentCount);
+    for (int i = 0; i < studentCount; i++) order[i] = i;
+    uint64_t state = input.seed;
+    for (int i = studentCount - 1; i > 0; i--) {
+        int j = static_cast<int>(lotteryNext(state) % static_cast<uint64_t>(i + 1));
+        swap(order[i], order[j]);
+    }
+
+    // Working copies; prerequisites only count courses completed before the lottery
+    vector<int> seats(courseCount);
+    for (int c = 0; c < courseCount; c++) seats[c] = input.courses[c].seats;
+    vector<int> credits(studentCount);
+    vector<uint64_t> busy(studentCount);
+    vector<uint64_t> completed(studentCount * words, 0);
+    vector<uint64_t> holding(studentCount * words, 0); // Taken, completed or granted this run
+    for (int s = 0; s < studentCount; s++) {
+        const LotteryStudent& student = input.students[s];
+        credits[s] = student.creditHours;
+        busy[s] = student.busySlots;
+        for (int c : student.completed) {
+            completed[s * words + c / 64] |= uint64_t(1) << (c % 64);
+            holding[s * words + c / 64] |= uint64_t(1) << (c % 64);
+        }
+        for (int c : student.taken) {
+            holding[s * words + c / 64] |= uint64_t(1) << (c % 64);
+        }
+    }
+
+    LotteryResult result;
+    result.digest = 0xCBF29CE484222325ULL;
+    for (int round = 0; round < MAX_PREFERENCES; round++) {
+        for (int s : order) {
+            const LotteryStudent& student = input.students[s];
+            if (round >= static_cast<int>(student.preferences.size())) continue;
+            int c = student.preferences[round];
+            const LotteryCourse& course = input.courses[c];
+            const uint64_t* mine = &holding[s * words];
+            if (seats[c] <= 0 || (mine[c / 64] >> (c % 64)) & 1) continue;
+            if ((busy[s] & course.timeSlots) != 0) continue;
+            if (credits[s] + course.creditHours > input.maxCreditHours) continue;
+            bool ready = true;
+            for (int p : course.prerequisites) {
+                if (!((completed[s * words + p / 64] >> (p % 64)) & 1)) {
+                    ready = false;
+                    break;
+                }
+            }
+            if (!ready) continue;
+
+            seats[c]--;
+            busy[s] |= course.timeSlots;
+            credits[s] += course.creditHours;
+            holding[s * words + c / 64] |= uint64_t(1) << (c % 64);
+            result.assignments.push_back({s, c});
+            // FNV-1a over the (student, course) pairs
+            for (uint64_t value : {static_cast<uint64_t>(s), static_cast<uint64_t>(c)}) {
+                result.digest = (result.digest ^ value) * 0x100000001B3ULL;
+            }
+        }
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,58 @@
+#include "MemoryTracking.h"
+
+#ifdef CRS_TRACK_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<size_t> liveBytes{0};
+std::atomic<size_t> liveAllocations{0};
+std::atomic<size_t> totalAllocations{0};
+
+// Each block carries its size in front, so unsized deletes can be counted too.
+// The prefix is a full max_align_t so the caller's pointer stays aligned.
+constexpr size_t PREFIX = alignof(std::max_align_t);
+
+void* allocate(size_t size) {
+    void* block = std::malloc(size + PREFIX);
+    if (block == nullptr) throw std::bad_alloc();
+    *static_cast<size_t*>(block) = size;
+    liveBytes += size;
+    liveAllocations++;
+    totalAllocations++;
+    return static_cast<char*>(block) + PREFIX;
+}
+
+void release(void* pointer) {
+    if (pointer == nullptr) return;
+    void* block = static_cast<char*>(pointer) - PREFIX;
+    liveBytes -= *static_cast<size_t*>(block);
+    liveAllocations--;
+    std::free(block);
+}
+
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { release(pointer); }
+
+bool heapTrackingEnabled() { return true; }
+
+HeapCounters heapCounters() {
+    return {liveBytes.load(), liveAllocations.load(), totalAllocations.load()};
+}
+
+#else
+
+bool heapTrackingEnabled() { return false; }
+
+HeapCounters heapCounters() { return {0, 0, 0}; }
+
+#endif
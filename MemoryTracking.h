@@ -0,0 +1,18 @@
+#ifndef MEMORYTRACKING_H
+#define MEMORYTRACKING_H
+
+#include <cstddef>
+
+// Counting allocator. Building with CRS_TRACK_ALLOCATIONS replaces the global
+// operator new/delete with versions that keep these counters, so the estimates
+// in the memory report can be checked against what was really allocated.
+struct HeapCounters {
+    size_t liveBytes;       // Requested bytes not yet freed
+    size_t liveAllocations;
+    size_t totalAllocations; // Since startup
+};
+
+bool heapTrackingEnabled();
+HeapCounters heapCounters(); // All zero when tracking is disabled
+
+#endif
@@ -1,7 +1,16 @@
 #ifndef MODELS_H
 #define MODELS_H
 
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 using namespace std;
 
 // Base User class
@@ -12,49 +21,168 @@ protected:
     string fullName;
     string rollNo;
     bool isAdmin;
+    int firstArchive; // Archives before this one belong to an earlier account under the same name
 
 public:
-    User() : username(""), password(""), fullName(""), rollNo(""), isAdmin(false) {}
-    User(string u, string p, string n, string r, bool admin = false)
-        : username(u), password(p), fullName(n), rollNo(r), isAdmin(admin) {}
-
-    string getUsername() const { return username; }
-    string getPassword() const { return password; }
-    string getFullName() const { return fullName; }
-    string getRollNo() const { return rollNo; }
+    User() : username(""), password(""), fullName(""), rollNo(""), isAdmin(false), firstArchive(0) {}
+    User(string u, string p, string n, string r, bool admin = false, int first = 0)
+        : username(std::move(u)), password(std::move(p)), fullName(std::move(n)), rollNo(std::move(r)),
+          isAdmin(admin), firstArchive(first) {}
+
+    const string& getUsername() const { return username; }
+    const string& getPassword() const { return password; }
+    const string& getFullName() const { return fullName; }
+    const string& getRollNo() const { return rollNo; }
     bool getIsAdmin() const { return isAdmin; }
+    int getFirstArchive() const { return firstArchive; }
+
+    void setUsername(string u) { username = std::move(u); }
+    void setPassword(string p) { password = std::move(p); }
+    void setFullName(string n) { fullName = std::move(n); }
+    void setRollNo(string r) { rollNo = std::move(r); }
+};
+
+// Course code held inline, zero padded to 16 bytes. Read as two big-endian
+// words it compares as integers in string order (padding sorts first), and
+// getCode is a view over the buffer, so neither a compare nor getCode allocates.
+struct CourseKey {
+    static constexpr size_t MAX_LENGTH = 16;
+    char bytes[MAX_LENGTH];
+
+    uint64_t word(size_t at) const {
+        uint64_t value;
+        memcpy(&value, bytes + at, sizeof(value));
+        return endian::native == endian::little ? byteswap(value) : value;
+    }
 
-    void setUsername(string u) { username = u; }
-    void setPassword(string p) { password = p; }
-    void setFullName(string n) { fullName = n; }
-    void setRollNo(string r) { rollNo = r; }
+    CourseKey() : bytes{} {}
+    explicit CourseKey(string_view code) : bytes{} {
+        memcpy(bytes, code.data(), min(code.length(), MAX_LENGTH));
+    }
+
+    // Only codes that fit are stored; longer ones, and any with a NUL that
+    // would end the code early, are rejected where they are read
+    static bool fits(string_view code) {
+        return !code.empty() && code.length() <= MAX_LENGTH && code.find('\0') == string_view::npos;
+    }
+
+    string_view view() const { return string_view(bytes, strnlen(bytes, MAX_LENGTH)); }
+
+    bool operator==(const CourseKey& other) const { return memcmp(bytes, other.bytes, MAX_LENGTH) == 0; }
+    bool operator!=(const CourseKey& other) const { return !(*this == other); }
+    bool operator<(const CourseKey& other) const {
+        uint64_t hi = word(0), otherHi = other.word(0);
+        return hi < otherHi || (hi == otherHi && word(8) < other.word(8));
+    }
 };
 
+// Weekly meeting times: one bit per hour, Monday to Friday, 08:00 to 20:00
+const int SCHEDULE_DAYS = 5;
+const int SCHEDULE_FIRST_HOUR = 8;
+const int SCHEDULE_HOURS = 12;
+const int SCHEDULE_SLOTS = SCHEDULE_DAYS * SCHEDULE_HOURS;
+const char SCHEDULE_DAY_LETTERS[] = "MTWRF";
+
+// Parses blocks like "MWF 9-10;TR 13-15" into slot bits; blank or "TBA" means no fixed times
+inline bool parseSchedule(const string& spec, uint64_t& slots) {
+    slots = 0;
+    size_t pos = 0;
+    while (pos <= spec.length()) {
+        size_t end = spec.find(';', pos);
+        if (end == string::npos) end = spec.length();
+        string block = spec.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t i = 0;
+        while (i < block.length() && isspace(static_cast<unsigned char>(block[i]))) i++;
+        if (i == block.length() || block.compare(i, string::npos, "TBA") == 0) continue;
+
+        uint64_t days = 0;
+        for (; i < block.length() && isalpha(static_cast<unsigned char>(block[i])); i++) {
+            char letter = static_cast<char>(toupper(static_cast<unsigned char>(block[i])));
+            size_t day = string_view(SCHEDULE_DAY_LETTERS).find(letter);
+            if (day == string_view::npos) return false;
+            days |= uint64_t(1) << day;
+        }
+
+        int start = 0, finish = 0;
+        char dash = 0, extra = 0;
+        if (days == 0 || sscanf(block.c_str() + i, " %d %c %d %c", &start, &dash, &finish, &extra) != 3 || dash != '-') {
+            return false;
+        }
+        if (start < SCHEDULE_FIRST_HOUR || finish > SCHEDULE_FIRST_HOUR + SCHEDULE_HOURS || start >= finish) {
+            return false;
+        }
+        for (int day = 0; day < SCHEDULE_DAYS; day++) {
+            if (!(days & (uint64_t(1) << day))) continue;
+            for (int hour = start; hour < finish; hour++) {
+                slots |= uint64_t(1) << (day * SCHEDULE_HOURS + hour - SCHEDULE_FIRST_HOUR);
+            }
+        }
+    }
+    return true;
+}
+
+// Inverse of parseSchedule; days that meet at the same hours are grouped
+inline string formatSchedule(uint64_t slots) {
+    if (slots == 0) return "TBA";
+    vector<pair<string, string>> blocks; // (hours, days)
+    for (int day = 0; day < SCHEDULE_DAYS; day++) {
+        int hour = 0;
+        while (hour < SCHEDULE_HOURS) {
+            if (!(slots & (uint64_t(1) << (day * SCHEDULE_HOURS + hour)))) {
+                hour++;
+                continue;
+            }
+            int start = hour;
+            while (hour < SCHEDULE_HOURS && (slots & (uint64_t(1) << (day * SCHEDULE_HOURS + hour)))) hour++;
+            string hours = to_string(start + SCHEDULE_FIRST_HOUR) + "-" + to_string(hour + SCHEDULE_FIRST_HOUR);
+            size_t b = 0;
+            while (b < blocks.size() && blocks[b].first != hours) b++;
+            if (b == blocks.size()) blocks.emplace_back(hours, "");
+            blocks[b].second += SCHEDULE_DAY_LETTERS[day];
+        }
+    }
+    string spec;
+    for (const auto& block : blocks) {
+        if (!spec.empty()) spec += ";";
+        spec += block.second + " " + block.first;
+    }
+    return spec;
+}
+
 // Course class
 class Course {
 private:
-    string code;
+    CourseKey key;
     string name;
     int creditHours;
     int totalSeats;
     int availableSeats;
+    int heldSeats; // Reserved by seat holds; already excluded from availableSeats
+    uint64_t timeSlots; // Weekly meeting hours, see parseSchedule
 
 public:
-    Course() : code(""), name(""), creditHours(0), totalSeats(0), availableSeats(0) {}
-    Course(string c, string n, int ch, int ts)
-        : code(c), name(n), creditHours(ch), totalSeats(ts), availableSeats(ts) {}
+    Course() : name(""), creditHours(0), totalSeats(0), availableSeats(0), heldSeats(0), timeSlots(0) {}
+    Course(string c, string n, int ch, int ts, uint64_t slots = 0)
+        : key(c), name(std::move(n)), creditHours(ch), totalSeats(ts), availableSeats(ts), heldSeats(0),
+          timeSlots(slots) {}
 
-    string getCode() const { return code; }
-    string getName() const { return name; }
+    const CourseKey& getKey() const { return key; }
+    string_view getCode() const { return key.view(); } // Valid while the course is
+    const string& getName() const { return name; }
     int getCreditHours() const { return creditHours; }
     int getTotalSeats() const { return totalSeats; }
     int getAvailableSeats() const { return availableSeats; }
+    int getHeldSeats() const { return heldSeats; }
+    uint64_t getTimeSlots() const { return timeSlots; }
 
-    void setCode(string c) { code = c; }
-    void setName(string n) { name = n; }
+    void setCode(string c) { key = CourseKey(c); }
+    void setName(string n) { name = std::move(n); }
     void setCreditHours(int ch) { creditHours = ch; }
     void setTotalSeats(int ts) { totalSeats = ts; }
     void setAvailableSeats(int as) { availableSeats = as; }
+    void setTimeSlots(uint64_t slots) { timeSlots = slots; }
 
     bool enrollStudent() {
         if (availableSeats > 0) {
@@ -64,18 +192,61 @@ public:
         return false;
     }
 
+    // Held seats are out of availableSeats but still taken, so they count against the cap
     void unenrollStudent() {
-        if (availableSeats < totalSeats) {
+        if (availableSeats + heldSeats < totalSeats) {
             availableSeats++;
         }
     }
+
+    // Seat holds take a seat out of availableSeats until they are confirmed or expire
+    bool holdSeat() {
+        if (availableSeats > 0) {
+            availableSeats--;
+            heldSeats++;
+            return true;
+        }
+        return false;
+    }
+
+    void releaseHold() {
+        if (heldSeats > 0) {
+            heldSeats--;
+            availableSeats++;
+        }
+    }
+
+    bool convertHold() {
+        if (heldSeats > 0) {
+            heldSeats--;
+            return true;
+        }
+        return false;
+    }
 };
 
+// Department prefix of a course code, e.g. "CS" for "CS101"
+inline string departmentOf(string_view code) {
+    size_t end = 0;
+    while (end < code.length() && isalpha(static_cast<unsigned char>(code[end]))) end++;
+    return string(code.substr(0, end));
+}
+
 // Enrollment record
 struct Enrollment {
     string username;
     string courseCode;
-    Enrollment(string u, string c) : username(u), courseCode(c) {}
+    Enrollment(string u, string c) : username(std::move(u)), courseCode(std::move(c)) {}
+};
+
+// Reversible student action, kept in the per-user undo/redo logs
+enum class ActionType { Enroll, Drop, VoidPayment };
+
+struct UserAction {
+    ActionType type;
+    string target; // Course code, or transaction ID for VoidPayment
+    UserAction() : type(ActionType::Enroll) {}
+    UserAction(ActionType t, string tgt) : type(t), target(std::move(tgt)) {}
 };
 
 struct Payment {
@@ -84,7 +255,8 @@ struct Payment {
     double amount;
     string status; // "Pending", "Completed"
     Payment() : amount(0.0) {}
-    Payment(string t, string u, double a, string s) : transactionId(t), username(u), amount(a), status(s) {}
+    Payment(string t, string u, double a, string s)
+        : transactionId(std::move(t)), username(std::move(u)), amount(a), status(std::move(s)) {}
 };
 
 #endif
@@ -0,0 +1,135 @@
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// What the core API reports back. Nothing in the core prints: a front end
+// (the console menus, a server, a benchmark) turns these into messages.
+enum class Status {
+    Ok,
+
+    // Access
+    ReadOnlyReplica,    // Changes must go to the primary
+    NotLoggedIn,
+    AdminRequired,
+    AdminNotAllowed,    // Student-only operation
+    AccessDenied,       // A student asking about someone else
+    InvalidCredentials,
+    ShardUnavailable,   // The worker process holding that part of the catalog did not answer
+
+    // Admission control; Outcome::waitSeconds says when to come back
+    WindowClosed,
+    RateLimited,
+    Queued,
+    Shed,
+
+    // Accounts
+    EmptyUsername,
+    EmptyPassword,
+    PasswordTooShort,
+    EmptyFullName,
+    EmptyRollNo,
+    UsernameHasSpaces,
+    UsernameTaken,
+    RollNoTaken,
+    UserNotFound,
+    StudentNotFound,
+    CannotDeleteSelf,
+
+    // Registration
+    CourseNotFound,
+    AlreadyEnrolled,
+    AlreadyCompleted,   // Passed in an archived term
+    NotEnrolled,
+    PrerequisitesMissing,
+    ScheduleConflict,
+    CreditLimitExceeded,
+    CreditMinimum,
+    NoSeats,
+    AlreadyHeld,
+    NoHold,
+    NothingToUndo,
+    NoLongerApplies,
+
+    // Catalog administration
+    EmptyCourseCode,
+    CourseCodeTooLong,
+    CourseCodeHasNul,
+    EmptyCourseName,
+    CreditHoursNotPositive,
+    CreditHoursTooHigh,
+    SeatsNotPositive,
+    SeatsBelowTaken,    // Fewer seats than students already enrolled or holding one
+    InvalidMeetingTimes,
+    CourseExists,
+    CourseNameExists,
+    EmptyDepartment,
+    EmptyRollNoPrefix,
+    NoMatches,          // A bulk delete found nothing to remove
+    InvalidHoldDuration,
+    InvalidCreditLimits,
+    InvalidWindow,
+
+    // Prerequisites
+    EmptyPrerequisite,
+    PrerequisiteNotFound,
+    SelfPrerequisite,
+    PrerequisiteExists,
+    CircularPrerequisite,
+
+    // Terms
+    InvalidTermName,
+    TermExists,
+
+    // Lottery
+    NoPreferenceRound,
+    RoundAlreadyOpen,
+    PreferenceCount,
+    DuplicatePreference,
+    NoAudit,
+
+    // Payments
+    EmptyTransactionId,
+    AmountNotPositive,
+    AmountTooHigh,
+    TransactionExists,
+    PaymentNotFound,
+    NotVoidable,
+    MalformedRecord,    // An imported line with a missing field, bad number or unknown status
+    CannotOpenFile
+};
+
+// Result of a command. Fields past status are filled only where the status needs them.
+struct Outcome {
+    Status status;
+    string subject;        // Course name on success, or the code, ID or prefix a failure is about
+    string detail;         // Meeting times of a conflicting course, times kept by an update, or a term opened
+    vector<string> items;  // Missing prerequisites
+    long long count;       // Credit hours, minutes or records, as the status calls for
+    long long limit;       // The bound count was checked against
+    double waitSeconds;    // Until an admission refusal lifts or a registration window opens
+
+    Outcome(Status s = Status::Ok) : status(s), count(0), limit(0), waitSeconds(0) {}
+    Outcome(Status s, string about) : status(s), subject(std::move(about)), count(0), limit(0), waitSeconds(0) {}
+
+    bool ok() const { return status == Status::Ok; }
+};
+
+// Result of a query; value is meaningful only when status is Ok
+template <typename T>
+struct Result {
+    Status status;
+    T value;
+
+    Result(Status s = Status::Ok) : status(s), value() {}
+    Result(T v) : status(Status::Ok), value(std::move(v)) {}
+    Result(Status s, T v) : status(s), value(std::move(v)) {}
+
+    bool ok() const { return status == Status::Ok; }
+};
+
+#endif
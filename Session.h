@@ -0,0 +1,120 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "DataStructures.h"
+#include <random>
+
+// Opaque handle handed out by login; every call made as that user passes it back
+using SessionToken = string;
+
+struct Session {
+    string token;
+    string username; // The account's stable key; its User record is looked up on each call
+    double lastSeen; // Seconds on the system clock
+    Session* older;  // Recency list, least recently used at the head
+    Session* newer;
+};
+
+inline void heapUsage(const Session& session, MemoryStats& stats) {
+    heapUsage(session.token, stats);
+    heapUsage(session.username, stats);
+}
+
+// Every logged-in session, keyed by a random 128-bit token.
+// A call looks its token up in the hash table and moves the session to the
+// recent end of an intrusive list, both O(1). Sessions idle past the timeout
+// fall off the old end as the clock moves, so expiry costs nothing per call
+// beyond the sessions that actually expire.
+class SessionTable {
+private:
+    HashTable<Session> byToken; // Nodes never move, so the list can point into them
+    Session* oldest;
+    Session* newest;
+    double idleTimeout;
+    random_device entropy;
+
+    void unlink(Session* session) {
+        (session->older ? session->older->newer : oldest) = session->newer;
+        (session->newer ? session->newer->older : newest) = session->older;
+        session->older = session->newer = nullptr;
+    }
+
+    void append(Session* session) {
+        session->older = newest;
+        session->newer = nullptr;
+        (newest ? newest->newer : oldest) = session;
+        newest = session;
+    }
+
+    void erase(Session* session) {
+        unlink(session);
+        string token = std::move(session->token); // The node, and the string in it, goes with the remove
+        byToken.remove(token);
+    }
+
+    SessionToken newToken() {
+        static const char digits[] = "0123456789abcdef";
+        SessionToken token;
+        for (int word = 0; word < 4; word++) {
+            uint32_t bits = entropy();
+            for (int i = 0; i < 8; i++, bits >>= 4) token.push_back(digits[bits & 0xF]);
+        }
+        return token;
+    }
+
+public:
+    static constexpr double DEFAULT_IDLE_SECONDS = 30 * 60;
+
+    explicit SessionTable(double idleSeconds = DEFAULT_IDLE_SECONDS)
+        : oldest(nullptr), newest(nullptr), idleTimeout(idleSeconds) {}
+
+    SessionTable(const SessionTable&) = delete;
+    SessionTable& operator=(const SessionTable&) = delete;
+
+    SessionToken open(const string& username, double now) {
+        expire(now);
+        SessionToken token = newToken();
+        while (byToken.search(token) != nullptr) token = newToken();
+        byToken.insert(token, Session{token, username, now, nullptr, nullptr});
+        append(byToken.search(token));
+        return token;
+    }
+
+    // Username behind a live session, restarting its idle clock; nullptr if unknown or expired
+    const string* touch(const SessionToken& token, double now) {
+        expire(now);
+        Session* session = byToken.search(token);
+        if (session == nullptr) return nullptr;
+        session->lastSeen = now;
+        unlink(session);
+        append(session);
+        return &session->username;
+    }
+
+    bool close(const SessionToken& token) {
+        Session* session = byToken.search(token);
+        if (session == nullptr) return false;
+        erase(session);
+        return true;
+    }
+
+    // Ends every session whose username matches, e.g. when accounts are deleted
+    template <typename Func>
+    void closeIf(Func matches) {
+        for (Session* session = oldest; session != nullptr;) {
+            Session* next = session->newer;
+            if (matches(session->username)) erase(session);
+            session = next;
+        }
+    }
+
+    void expire(double now) {
+        while (oldest != nullptr && now - oldest->lastSeen > idleTimeout) erase(oldest);
+    }
+
+    int size() const { return byToken.size(); }
+
+    MemoryStats memoryUsage() const { return byToken.memoryUsage(); }
+};
+
+#endif
@@ -0,0 +1,555 @@
+#include "ShardRouter.h"
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+const char* const SHARDS_DIR = "shards";
+const char* const LAYOUT_FILE = "shards/layout.txt";
+
+string shardDirectory(int index) {
+    return string(SHARDS_DIR) + "/" + to_string(index);
+}
+
+string statusField(Status status) {
+    return to_string(static_cast<int>(status));
+}
+
+bool toStatus(const string& field, Status& status) {
+    if (field.empty() || field.find_first_not_of("0123456789") != string::npos) return false;
+    status = static_cast<Status>(stoi(field));
+    return true;
+}
+
+string encodeLine(const vector<string>& fields) {
+    string line;
+    for (size_t i = 0; i < fields.size(); i++) {
+        if (i > 0) line += '\t';
+        for (char c : fields[i]) {
+            switch (c) {
+                case '\\': line += "\\\\"; break;
+                case '\t': line += "\\t"; break;
+                case '\n': line += "\\n"; break;
+                default: line += c;
+            }
+        }
+    }
+    line += '\n';
+    return line;
+}
+
+vector<string> decodeLine(const string& line) {
+    vector<string> fields(1);
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (c == '\t') {
+            fields.emplace_back();
+        } else if (c == '\\' && i + 1 < line.size()) {
+            char escaped = line[++i];
+            fields.back() += escaped == 't' ? '\t' : escaped == 'n' ? '\n' : escaped;
+        } else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+// A worker that has gone away must not take the router down with SIGPIPE
+bool writeAll(int fd, const string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Takes the next full line out of received, reading more from fd as needed.
+// Lines are taken from consumed on, so a burst of replies is not shifted once per line.
+bool readLine(int fd, string& received, size_t& consumed, string& line) {
+    size_t end;
+    while ((end = received.find('\n', consumed)) == string::npos) {
+        received.erase(0, consumed);
+        consumed = 0;
+        char chunk[65536];
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        received.append(chunk, static_cast<size_t>(n));
+    }
+    line.assign(received, consumed, end - consumed);
+    consumed = end + 1;
+    return true;
+}
+
+// code name creditHours timeSlots availableSeats totalSeats prerequisite...
+void putCourse(vector<string>& fields, const CourseView& course) {
+    fields.insert(fields.end(), {course.code, course.name, to_string(course.creditHours), to_string(course.timeSlots),
+                                 to_string(course.availableSeats), to_string(course.totalSeats)});
+    fields.insert(fields.end(), course.prerequisites.begin(), course.prerequisites.end());
+}
+
+bool getCourse(const vector<string>& fields, size_t first, CourseView& course) {
+    if (fields.size() < first + 6) return false;
+    try {
+        course.code = fields[first];
+        course.name = fields[first + 1];
+        course.creditHours = stoi(fields[first + 2]);
+        course.timeSlots = stoull(fields[first + 3]);
+        course.availableSeats = stoi(fields[first + 4]);
+        course.totalSeats = stoi(fields[first + 5]);
+    } catch (...) {
+        return false;
+    }
+    course.prerequisites.assign(fields.begin() + static_cast<long>(first + 6), fields.end());
+    return true;
+}
+
+// status subject detail count limit waitSeconds item...
+vector<string> outcomeFields(const Outcome& outcome) {
+    vector<string> fields = {statusField(outcome.status), outcome.subject, outcome.detail, to_string(outcome.count),
+                             to_string(outcome.limit), to_string(outcome.waitSeconds)};
+    fields.insert(fields.end(), outcome.items.begin(), outcome.items.end());
+    return fields;
+}
+
+bool getOutcome(const vector<string>& fields, Outcome& outcome) {
+    if (fields.size() < 6 || !toStatus(fields[0], outcome.status)) return false;
+    try {
+        outcome.subject = fields[1];
+        outcome.detail = fields[2];
+        outcome.count = stoll(fields[3]);
+        outcome.limit = stoll(fields[4]);
+        outcome.waitSeconds = stod(fields[5]);
+    } catch (...) {
+        return false;
+    }
+    outcome.items.assign(fields.begin() + 6, fields.end());
+    return true;
+}
+
+// Answers one request against the worker's own system; a listing adds a line per course
+void answer(CourseRegistrationSystem& sys, const vector<string>& request, string& out) {
+    auto arg = [&request](size_t i) -> const string& {
+        static const string missing;
+        return i < request.size() ? request[i] : missing;
+    };
+    const string& verb = arg(0);
+    vector<string> reply;
+    try {
+        if (verb == "CLOCK") {
+            sys.setClock(stod(arg(1)));
+            reply = {statusField(Status::Ok)};
+        } else if (verb == "LOGIN") {
+            Result<LoginSession> login = sys.login(arg(1), arg(2));
+            reply = {statusField(login.status), login.value.token};
+        } else if (verb == "LOGOUT") {
+            reply = {statusField(sys.logout(arg(1)))};
+        } else if (verb == "FIND") {
+            optional<CourseView> course = sys.findCourse(arg(1));
+            reply = {statusField(course ? Status::Ok : Status::CourseNotFound)};
+            if (course) putCourse(reply, *course);
+        } else if (verb == "LIST") {
+            vector<CourseView> courses = sys.listCourses(static_cast<CourseOrder>(stoi(arg(1))));
+            out += encodeLine({statusField(Status::Ok), to_string(courses.size())});
+            for (const CourseView& course : courses) {
+                reply.clear();
+                putCourse(reply, course);
+                out += encodeLine(reply);
+            }
+            return;
+        } else if (verb == "ENROLL") {
+            reply = outcomeFields(sys.enrollCourse(arg(1), arg(2)));
+        } else if (verb == "DROP") {
+            reply = outcomeFields(sys.dropCourse(arg(1), arg(2)));
+        } else if (verb == "DONE") {
+            // DONE token username code... answers with the codes the student has not completed
+            Result<Transcript> transcript = sys.transcript(arg(1), arg(2));
+            reply = {statusField(transcript.status)};
+            for (size_t i = 3; transcript.ok() && i < request.size(); i++) {
+                bool completed = false;
+                for (const TranscriptTerm& term : transcript.value.terms) {
+                    for (const auto& course : term.courses) completed = completed || course.first == request[i];
+                }
+                if (!completed) reply.push_back(request[i]);
+            }
+        } else {
+            reply = {statusField(Status::MalformedRecord)};
+        }
+    } catch (...) {
+        reply = {statusField(Status::MalformedRecord)};
+    }
+    out += encodeLine(reply);
+}
+
+// The worker's whole life: serve requests until the router hangs up, then save
+// and leave without running the handlers of the process it was forked from
+[[noreturn]] void serveShard(int fd) {
+    {
+        CourseRegistrationSystem sys;
+        string received, line, out;
+        size_t consumed = 0;
+        while (readLine(fd, received, consumed, line)) {
+            answer(sys, decodeLine(line), out);
+            // Replies wait while more requests are already here, then go out in one write
+            if (received.find('\n', consumed) == string::npos) {
+                if (!writeAll(fd, out)) break;
+                out.clear();
+            }
+        }
+    }
+    _exit(0);
+}
+
+}
+
+ShardRouter::ShardRouter(int workerCount) {
+    workerCount = max(1, workerCount);
+    if (!loadLayout(workerCount)) splitData(workerCount);
+    for (int i = 0; i < workerCount; i++) startWorker(i);
+}
+
+ShardRouter::~ShardRouter() {
+    for (int i = 0; i < workerCount(); i++) fail(i); // A worker exits once its connection closes
+    for (Worker& worker : workers) {
+        if (worker.pid > 0) waitpid(worker.pid, nullptr, 0);
+    }
+}
+
+bool ShardRouter::loadLayout(int workerCount) {
+    ifstream layout(LAYOUT_FILE);
+    string line;
+    if (!getline(layout, line) || line != to_string(workerCount)) return false;
+    while (getline(layout, line)) {
+        stringstream ss(line);
+        string tag, first, second;
+        getline(ss, tag, ',');
+        getline(ss, first, ',');
+        getline(ss, second, ',');
+        if (first.empty() || second.empty()) continue; // Skip malformed lines
+        if (tag == "D") {
+            int worker = atoi(second.c_str());
+            if (worker >= 0 && worker < workerCount) departmentWorkers.insert(first, worker);
+        } else if (tag == "P") {
+            remotePrerequisites.searchOrInsert(first)->push_back(second);
+        }
+    }
+    return true;
+}
+
+void ShardRouter::splitData(int workerCount) {
+    // Files from before terms existed are brought up to date by opening them once
+    if (!filesystem::exists(TERMS_FILE)) {
+        CourseRegistrationSystem whole;
+    }
+
+    // Departments in name order, each with its lines of courses.txt
+    HashTable<string> courseLines;
+    vector<string> departments;
+    ifstream courseFile("courses.txt");
+    string line;
+    while (getline(courseFile, line)) {
+        string department = departmentOf(string_view(line).substr(0, line.find(',')));
+        if (department.empty()) continue;
+        if (courseLines.search(department) == nullptr) departments.push_back(department);
+        *courseLines.searchOrInsert(department) += line + "\n";
+    }
+    sort(departments.begin(), departments.end());
+    string layout = to_string(workerCount) + "\n";
+    for (size_t i = 0; i < departments.size(); i++) {
+        int worker = static_cast<int>(i % workerCount);
+        departmentWorkers.insert(departments[i], worker);
+        layout += "D," + departments[i] + "," + to_string(worker) + "\n";
+    }
+
+    // Accounts, history and enrollments go to every worker. A worker loads only
+    // the enrollments in its own courses and folds just those into its snapshot.
+    error_code ignored;
+    filesystem::remove_all(SHARDS_DIR, ignored);
+    vector<string> shared = {"users.txt", TERMS_FILE, "enrollments.dat", "enrollments.txt"};
+    for (const string& archive : termArchiveFiles()) shared.push_back(archive);
+    vector<ofstream> prereqFiles;
+    for (int w = 0; w < workerCount; w++) {
+        string directory = shardDirectory(w);
+        filesystem::create_directories(directory, ignored);
+        for (const string& name : shared) {
+            if (!filesystem::exists(name)) continue;
+            filesystem::copy_file(name, directory + "/" + name, filesystem::copy_options::overwrite_existing, ignored);
+        }
+        ofstream shardCourses(directory + "/courses.txt");
+        for (size_t i = w; i < departments.size(); i += workerCount) shardCourses << *courseLines.search(departments[i]);
+        prereqFiles.emplace_back(directory + "/prerequisites.txt");
+    }
+
+    // A prerequisite stays with its worker when both courses do; the router keeps the rest
+    ifstream prereqFile("prerequisites.txt");
+    while (getline(prereqFile, line)) {
+        stringstream ss(line);
+        string c, p;
+        getline(ss, c, ',');
+        getline(ss, p, ',');
+        int courseWorker = workerFor(c);
+        int prereqWorker = workerFor(p);
+        if (courseWorker < 0 || prereqWorker < 0) continue;
+        if (courseWorker == prereqWorker) {
+            prereqFiles[courseWorker] << c << "," << p << "\n";
+        } else {
+            remotePrerequisites.searchOrInsert(c)->push_back(p);
+            layout += "P," + c + "," + p + "\n";
+        }
+    }
+    prereqFiles.clear();
+
+    // Written last, so a split cut short has no layout and is done again
+    ofstream(string(LAYOUT_FILE) + ".tmp") << layout;
+    filesystem::rename(string(LAYOUT_FILE) + ".tmp", LAYOUT_FILE, ignored);
+}
+
+void ShardRouter::startWorker(int index) {
+    string directory = filesystem::absolute(shardDirectory(index)).string();
+    Worker worker{-1, -1, "", 0};
+    int ends[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) != 0) {
+        workers.push_back(std::move(worker));
+        outbound.emplace_back();
+        return;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(ends[0]);
+        // Holding the other workers' connections open would keep them from ever seeing the router hang up
+        for (const Worker& other : workers) {
+            if (other.fd >= 0) close(other.fd);
+        }
+        if (chdir(directory.c_str()) != 0) _exit(1);
+        serveShard(ends[1]);
+    }
+    close(ends[1]);
+    if (pid < 0) {
+        close(ends[0]);
+    } else {
+        worker.pid = pid;
+        worker.fd = ends[0];
+    }
+    workers.push_back(std::move(worker));
+    outbound.emplace_back();
+}
+
+int ShardRouter::workerFor(string_view code) {
+    int* worker = departmentWorkers.search(departmentOf(code));
+    return worker != nullptr ? *worker : -1;
+}
+
+// Requests are queued per worker and go out together at the first receive
+bool ShardRouter::send(int worker, const vector<string>& fields) {
+    if (workers[worker].fd < 0) return false;
+    outbound[worker] += encodeLine(fields);
+    return true;
+}
+
+void ShardRouter::flush() {
+    for (int i = 0; i < workerCount(); i++) {
+        if (outbound[i].empty()) continue;
+        if (workers[i].fd >= 0 && !writeAll(workers[i].fd, outbound[i])) fail(i);
+        outbound[i].clear();
+    }
+}
+
+bool ShardRouter::receive(int worker, vector<string>& fields) {
+    flush();
+    Worker& from = workers[worker];
+    string line;
+    if (from.fd < 0 || !readLine(from.fd, from.received, from.consumed, line)) {
+        fail(worker);
+        return false;
+    }
+    fields = decodeLine(line);
+    return true;
+}
+
+// Once a reply is missing or garbled the stream cannot be trusted, so the worker is dropped
+void ShardRouter::fail(int worker) {
+    Worker& dropped = workers[worker];
+    if (dropped.fd >= 0) close(dropped.fd);
+    dropped.fd = -1;
+    dropped.received.clear();
+    dropped.consumed = 0;
+}
+
+vector<string> ShardRouter::call(int worker, const vector<string>& fields) {
+    vector<string> reply;
+    if (!send(worker, fields) || !receive(worker, reply)) reply.clear();
+    return reply;
+}
+
+void ShardRouter::addRemotePrerequisites(CourseView& course) {
+    vector<string>* remote = remotePrerequisites.search(course.code);
+    if (remote != nullptr) course.prerequisites.insert(course.prerequisites.end(), remote->begin(), remote->end());
+}
+
+void ShardRouter::setClock(double seconds) {
+    for (int i = 0; i < workerCount(); i++) send(i, {"CLOCK", to_string(seconds)});
+    vector<string> reply;
+    for (int i = 0; i < workerCount(); i++) receive(i, reply);
+}
+
+Result<SessionToken> ShardRouter::login(const string& username, const string& password) {
+    for (int i = 0; i < workerCount(); i++) send(i, {"LOGIN", username, password});
+    RouterSession session{username, vector<SessionToken>(workers.size())};
+    Status status = Status::Ok;
+    for (int i = 0; i < workerCount(); i++) {
+        vector<string> reply;
+        Status answered = Status::ShardUnavailable;
+        if (receive(i, reply) && reply.size() == 2 && toStatus(reply[0], answered) && answered == Status::Ok) {
+            session.tokens[i] = reply[1];
+        } else if (status == Status::Ok) {
+            status = answered;
+        }
+    }
+    if (status != Status::Ok) {
+        for (int i = 0; i < workerCount(); i++) {
+            if (!session.tokens[i].empty()) call(i, {"LOGOUT", session.tokens[i]});
+        }
+        return status;
+    }
+    SessionToken token = session.tokens[0];
+    sessions.insert(token, std::move(session));
+    return token;
+}
+
+Status ShardRouter::logout(const SessionToken& session) {
+    RouterSession* open = sessions.search(session);
+    if (open == nullptr) return Status::NotLoggedIn;
+    for (int i = 0; i < workerCount(); i++) send(i, {"LOGOUT", open->tokens[i]});
+    vector<string> reply;
+    for (int i = 0; i < workerCount(); i++) receive(i, reply);
+    sessions.remove(session);
+    return Status::Ok;
+}
+
+optional<CourseView> ShardRouter::findCourse(const string& code) {
+    int owner = workerFor(code);
+    if (owner < 0) return nullopt;
+    vector<string> reply = call(owner, {"FIND", code});
+    CourseView course;
+    Status status = Status::ShardUnavailable;
+    if (reply.empty() || !toStatus(reply[0], status) || status != Status::Ok || !getCourse(reply, 1, course)) {
+        return nullopt;
+    }
+    addRemotePrerequisites(course);
+    return course;
+}
+
+vector<CourseView> ShardRouter::listCourses(CourseOrder order) {
+    for (int i = 0; i < workerCount(); i++) send(i, {"LIST", to_string(static_cast<int>(order))});
+    vector<CourseView> courses;
+    for (int i = 0; i < workerCount(); i++) {
+        vector<string> reply;
+        if (!receive(i, reply) || reply.size() != 2) continue;
+        size_t count = strtoull(reply[1].c_str(), nullptr, 10);
+        for (size_t n = 0; n < count && receive(i, reply); n++) {
+            CourseView course;
+            if (!getCourse(reply, 0, course)) continue;
+            addRemotePrerequisites(course);
+            courses.push_back(std::move(course));
+        }
+    }
+    sort(courses.begin(), courses.end(), [order](const CourseView& a, const CourseView& b) {
+        return order == CourseOrder::ByCode ? a.code < b.code : a.name < b.name;
+    });
+    return courses;
+}
+
+Outcome ShardRouter::enrollCourse(const SessionToken& session, const string& code) {
+    return enrollMany({{session, code}})[0];
+}
+
+// Two rounds per batch: every lookup of a prerequisite in another shard, then
+// every enrollment that passed them. Within a round each worker gets all its
+// requests before any reply is read.
+vector<Outcome> ShardRouter::enrollMany(const vector<EnrollRequest>& requests) {
+    vector<Outcome> outcomes(requests.size());
+    vector<vector<size_t>> waiting(workers.size()); // Per worker, the requests it owes a reply, in order
+    auto collect = [this, &waiting](const function<void(size_t, const vector<string>*)>& take) {
+        for (int i = 0; i < workerCount(); i++) {
+            for (size_t r : waiting[i]) {
+                vector<string> reply;
+                take(r, receive(i, reply) ? &reply : nullptr);
+            }
+            waiting[i].clear();
+        }
+    };
+
+    for (size_t first = 0; first < requests.size(); first += BATCH) {
+        size_t last = min(requests.size(), first + BATCH);
+        for (size_t r = first; r < last; r++) {
+            RouterSession* session = sessions.search(requests[r].session);
+            if (session == nullptr) {
+                outcomes[r] = Status::NotLoggedIn;
+                continue;
+            }
+            if (workerFor(requests[r].code) < 0) {
+                outcomes[r] = Status::CourseNotFound;
+                continue;
+            }
+            vector<string>* remote = remotePrerequisites.search(requests[r].code);
+            for (int i = 0; remote != nullptr && i < workerCount(); i++) {
+                vector<string> lookup = {"DONE", session->tokens[i], session->username};
+                for (const string& prereq : *remote) {
+                    if (workerFor(prereq) == i) lookup.push_back(prereq);
+                }
+                if (lookup.size() == 3) continue;
+                if (send(i, lookup)) {
+                    waiting[i].push_back(r);
+                } else {
+                    outcomes[r] = Status::ShardUnavailable;
+                }
+            }
+        }
+        collect([&outcomes, &requests](size_t r, const vector<string>* reply) {
+            Status status = Status::ShardUnavailable;
+            if (reply != nullptr && !reply->empty()) toStatus((*reply)[0], status);
+            if (!outcomes[r].ok() && outcomes[r].status != Status::PrerequisitesMissing) return;
+            if (status != Status::Ok) {
+                outcomes[r] = status;
+            } else if (reply->size() > 1) {
+                if (outcomes[r].ok()) outcomes[r] = Outcome(Status::PrerequisitesMissing, requests[r].code);
+                outcomes[r].items.insert(outcomes[r].items.end(), reply->begin() + 1, reply->end());
+            }
+        });
+
+        for (size_t r = first; r < last; r++) {
+            if (!outcomes[r].ok()) continue;
+            int owner = workerFor(requests[r].code);
+            if (send(owner, {"ENROLL", sessions.search(requests[r].session)->tokens[owner], requests[r].code})) {
+                waiting[owner].push_back(r);
+            } else {
+                outcomes[r] = Status::ShardUnavailable;
+            }
+        }
+        collect([&outcomes](size_t r, const vector<string>* reply) {
+            if (reply == nullptr || !getOutcome(*reply, outcomes[r])) outcomes[r] = Status::ShardUnavailable;
+        });
+    }
+    return outcomes;
+}
+
+Outcome ShardRouter::dropCourse(const SessionToken& session, const string& code) {
+    RouterSession* open = sessions.search(session);
+    if (open == nullptr) return Status::NotLoggedIn;
+    int owner = workerFor(code);
+    if (owner < 0) return Status::CourseNotFound;
+    Outcome outcome;
+    if (!getOutcome(call(owner, {"DROP", open->tokens[owner], code}), outcome)) return Status::ShardUnavailable;
+    return outcome;
+}
@@ -0,0 +1,99 @@
+#ifndef SHARD_ROUTER_H
+#define SHARD_ROUTER_H
+
+#include "System.h"
+#include <sys/types.h>
+
+// The catalog split by department across worker processes on this host.
+// The router divides the data files in the working directory into
+// shards/<n>/, one directory per worker, and forks the workers. Each runs a
+// CourseRegistrationSystem over its own directory, so the shards share no
+// memory and registrations run on as many cores as there are workers.
+// Departments go to workers round-robin in name order. Every worker holds all
+// accounts and the sealed term archives (both are read-only here). A
+// department's courses, its enrollments and the prerequisites within its
+// worker live with that worker alone.
+//
+// Router and worker talk over a socket pair, one request line and one reply
+// line at a time (a listing replies with one more line per course). Fields
+// are tab separated, with tab, newline and backslash escaped. A request never
+// waits for the one before it to be answered, so a batch keeps every worker
+// busy at once.
+//
+// A prerequisite in another worker's shard is looked up there: the router asks
+// that worker whether the student completed it, then forwards the enrollment.
+// Completions only change when a term closes, so the answer cannot go stale
+// between the two requests.
+//
+// shards/layout.txt records the worker count, each department's worker and
+// the prerequisites that cross shards. A router started again with the same
+// worker count picks the shards up as they were left. Any other count splits
+// the files in the working directory afresh. Accounts and courses are set up
+// before the split; the router only browses, enrolls and drops.
+class ShardRouter {
+public:
+    struct EnrollRequest {
+        SessionToken session;
+        string code;
+    };
+
+private:
+    static const int BATCH = 256; // Requests in flight at once, well inside a socket buffer
+
+    struct Worker {
+        pid_t pid;
+        int fd;          // -1 once the worker stops answering
+        string received; // Read but not yet taken as lines
+        size_t consumed; // Where the next line in received starts
+    };
+
+    struct RouterSession {
+        string username;
+        vector<SessionToken> tokens; // Per worker
+    };
+
+    vector<Worker> workers;
+    vector<string> outbound; // Per worker, requests not yet written
+    HashTable<int> departmentWorkers;              // Department -> worker
+    HashTable<vector<string>> remotePrerequisites; // Course -> prerequisites in other shards
+    HashTable<RouterSession> sessions;             // Router token -> the user's session on each worker
+
+    bool loadLayout(int workerCount);
+    void splitData(int workerCount);
+    void startWorker(int index);
+
+    bool send(int worker, const vector<string>& fields);
+    void flush();
+    bool receive(int worker, vector<string>& fields);
+    void fail(int worker);
+    vector<string> call(int worker, const vector<string>& fields); // Empty if the worker did not answer
+
+    void addRemotePrerequisites(CourseView& course);
+
+public:
+    // workerCount below 1 is taken as 1
+    explicit ShardRouter(int workerCount);
+    ~ShardRouter(); // Closes every connection and waits for the workers to exit
+
+    ShardRouter(const ShardRouter&) = delete;
+    ShardRouter& operator=(const ShardRouter&) = delete;
+
+    int workerCount() const { return static_cast<int>(workers.size()); }
+    int workerFor(string_view code); // -1 for a department no shard holds
+
+    // Sets the clock on every worker (see CourseRegistrationSystem::setClock)
+    void setClock(double seconds);
+
+    // Logs in on every worker; the token returned stands for all of them
+    Result<SessionToken> login(const string& username, const string& password);
+    Status logout(const SessionToken& session);
+
+    optional<CourseView> findCourse(const string& code);
+    vector<CourseView> listCourses(CourseOrder order); // Merged from every worker
+    Outcome enrollCourse(const SessionToken& session, const string& code);
+    // One outcome per request, in order. Requests to different workers run side by side.
+    vector<Outcome> enrollMany(const vector<EnrollRequest>& requests);
+    Outcome dropCourse(const SessionToken& session, const string& code);
+};
+
+#endif
@@ -1,716 +1,2246 @@
 #include "System.h"
-#include <iostream>
+#include "EnrollmentFile.h"
 #include <algorithm>
+#include <bit>
+#include <cmath>
+#include <filesystem>
 #include <fstream>
+#include <numeric>
 #include <sstream>
 
 using namespace std;
 
-CourseRegistrationSystem::CourseRegistrationSystem() {
-    currentUser = nullptr;
+namespace {
+
+// Trace arguments are the text the replayer parses back (see invokeTraceOp)
+string traceArg(const string& text) { return text; }
+string traceArg(int number) { return to_string(number); }
+string traceArg(uint64_t number) { return to_string(number); }
+string traceArg(double number) { return to_string(number); }
+string traceArg(CourseOrder order) { return to_string(static_cast<int>(order)); }
+
+// Quoted only when it has to be, with inner quotes doubled (RFC 4180)
+void appendCsvField(string& out, const string& field) {
+    if (field.find_first_of(",\"\r\n") == string::npos) {
+        out += field;
+        return;
+    }
+    out += '"';
+    for (char c : field) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+}
+
+// Calls the system makes to itself are not recorded again. Counted per
+// thread, so browse calls running side by side never look nested.
+static thread_local int traceDepth = 0;
+
+// Opened first thing in every public call. While recording, the outermost call
+// is written to the trace as it returns, so a login can be filed under the
+// token it produced; the time is when it started. Arguments are only turned
+// into text when there is a trace to write them to.
+
+class CourseRegistrationSystem::TraceScope {
+private:
+    CourseRegistrationSystem& sys;
+    TraceOp op;
+    const SessionToken* session;
+    SessionToken opened; // A login's new token, kept for the record
+    uint64_t atMicros;
+    bool recording;
+
+public:
+    vector<string> args;
+
+    template <typename... Args>
+    TraceScope(CourseRegistrationSystem& system, TraceOp traced, const SessionToken* token, const Args&... values)
+        : sys(system), op(traced), session(token), atMicros(0),
+          recording(traceDepth++ == 0 && system.recorder != nullptr) {
+        if (!recording) return;
+        atMicros = static_cast<uint64_t>(max(0.0, sys.clockSeconds() - sys.recordingStart) * 1e6);
+        (args.push_back(traceArg(values)), ...);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope() {
+        traceDepth--;
+        if (!recording) return;
+        static const SessionToken none;
+        lock_guard<mutex> lock(sys.recorderLock);
+        sys.recorder->write(op, atMicros, session != nullptr ? *session : none, args);
+    }
+
+    bool isRecording() const { return recording; }
+    void fileUnder(const SessionToken& token) {
+        if (!recording) return;
+        opened = token;
+        session = &opened;
+    }
+};
+
+// Defaults stay out of the way of interactive use and only bite under a registration rush
+CourseRegistrationSystem::CourseRegistrationSystem(bool readReplica)
+    : admission(50, 50, 5, 1, 1000) {
+    dirtyTables = 0;
+    enrollmentTailRecords = 0;
+    dataVersion = 0;
+    snapshotVersion = -1;
+    catalogVersion = 0;
+    holdDurationSeconds = 15 * 60;
+    minCreditHours = 0;
+    maxCreditHours = 18;
+    preferenceRoundOpen = false;
+    clockStart = chrono::steady_clock::now();
+    replica = readReplica;
+    journalSeq = 0;
+    journalOffset = 0;
+    lastSyncMs = 0;
+    lastApplyDelayMs = 0;
+    maxStalenessMs = 1000;
+    recordingStart = 0;
+    taskPool = nullptr;
     loadData(); // Load data on startup
+
+    if (replica) {
+        syncReplica();
+    } else {
+        // Each primary run starts a fresh journal; the header tells replicas to start over
+        ofstream journalFile("journal.log", ios::trunc);
+        journalFile << "JOURNAL," << wallClockMs() << "," << currentTerm << "\n";
+    }
 }
 
 CourseRegistrationSystem::~CourseRegistrationSystem() {
     saveData(); // Save data on exit
 }
 
-void CourseRegistrationSystem::seedData() {
-    // Only seed if no users exist (first run)
-    if (users.getHead() != nullptr) return;
-
-    // Create default admin account
-    users.insert(User("admin", "admin123", "System Administrator", "ADMIN001", true));
+// Dictionary-codes both sides, sorted so names front code well and each
+// student's course IDs climb in small deltas
+template <typename Func>
+EnrollmentGroups CourseRegistrationSystem::groupEnrollments(Func forEachEnrollment) {
+    HashTable<int> courseIds, userIds;
+    vector<string> codes, usernames;
+    vector<vector<uint32_t>> taken;
+    forEachEnrollment([&](const Enrollment& e) {
+        int* course = courseIds.search(e.courseCode);
+        if (course == nullptr) {
+            courseIds.insert(e.courseCode, static_cast<int>(codes.size()));
+            codes.push_back(e.courseCode);
+            course = courseIds.search(e.courseCode);
+        }
+        int* user = userIds.search(e.username);
+        if (user == nullptr) {
+            userIds.insert(e.username, static_cast<int>(usernames.size()));
+            usernames.push_back(e.username);
+            taken.emplace_back();
+            user = userIds.search(e.username);
+        }
+        taken[*user].push_back(static_cast<uint32_t>(*course));
+    });
 
-    // Create sample students
-    users.insert(User("Ali", "123", "Ali Ahmed", "02-134242-001", false));
-    users.insert(User("Sara", "123", "Sara Khan", "02-134242-002", false));
-    users.insert(User("Anas", "123", "Anas Khan", "02-134242-068", false));
-    users.insert(User("Adil", "123", "Adil Shabbir", "02-134242-033", false));
-    users.insert(User("Amjad", "123", "Amjad Ellahi", "02-134242-092", false));
+    auto sortedOrder = [](const vector<string>& names) {
+        vector<uint32_t> order(names.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&names](uint32_t a, uint32_t b) { return names[a] < names[b]; });
+        return order;
+    };
+    vector<uint32_t> courseOrder = sortedOrder(codes);
+    vector<uint32_t> rank(codes.size());
+    EnrollmentGroups groups;
+    for (uint32_t i = 0; i < courseOrder.size(); i++) {
+        groups.courseCodes.push_back(std::move(codes[courseOrder[i]]));
+        rank[courseOrder[i]] = i;
+    }
+    for (uint32_t user : sortedOrder(usernames)) {
+        vector<uint32_t> ids;
+        for (uint32_t course : taken[user]) ids.push_back(rank[course]);
+        sort(ids.begin(), ids.end());
+        groups.usernames.push_back(std::move(usernames[user]));
+        groups.courseIds.push_back(std::move(ids));
+    }
+    return groups;
+}
 
+void CourseRegistrationSystem::seedData() {
+    // Only seed if no users exist (first run); replicas never write data files
+    if (replica || users.getHead() != nullptr) return;
+
+    // Journaled like any other change, so a replica that started before the
+    // first run gets the seed data too
+    vector<string> records;
+
+    // Default admin account and sample students
+    const User seedUsers[] = {
+        User("admin", "admin123", "System Administrator", "ADMIN001", true),
+        User("Ali", "123", "Ali Ahmed", "02-134242-001", false),
+        User("Sara", "123", "Sara Khan", "02-134242-002", false),
+        User("Anas", "123", "Anas Khan", "02-134242-068", false),
+        User("Adil", "123", "Adil Shabbir", "02-134242-033", false),
+        User("Amjad", "123", "Amjad Ellahi", "02-134242-092", false)
+    };
+    for (const User& user : seedUsers) {
+        addUser(user);
+        records.push_back("USER_ADD," + user.getUsername() + "," + user.getPassword() + "," + user.getRollNo() +
+                          "," + (user.getIsAdmin() ? "1," : "0,") + user.getFullName());
+    }
 
     // Add sample courses
-    courses.insert(Course("CS101", "Introduction to Programming", 3, 30));
-    courses.insert(Course("CS201", "Data Structures and Algorithms", 4, 25));
-    courses.insert(Course("CS301", "Database Systems", 3, 20));
-    courses.insert(Course("CS401", "Software Engineering", 4, 15));
-    courses.insert(Course("MATH101", "Calculus I", 3, 35));
-    courses.insert(Course("ENG101", "English Composition", 2, 40));
+    const pair<Course, const char*> seedCourses[] = {
+        {Course("CS101", "Introduction to Programming", 3, 30), "MWF 9-10"},
+        {Course("CS201", "Data Structures and Algorithms", 4, 25), "TR 9-11"},
+        {Course("CS301", "Database Systems", 3, 20), "MW 11-13"},
+        {Course("CS401", "Software Engineering", 4, 15), "TR 11-13"},
+        {Course("MATH101", "Calculus I", 3, 35), "MWF 10-11"},
+        {Course("ENG101", "English Composition", 2, 40), "F 14-16"}
+    };
+    for (const auto& [seed, meetingTimes] : seedCourses) {
+        Course course = seed;
+        uint64_t slots = 0;
+        parseSchedule(meetingTimes, slots);
+        course.setTimeSlots(slots);
+        catalog.insert(course);
+        countCourse(course, 1);
+        records.push_back("COURSE_ADD," + string(course.getCode()) + "," + to_string(course.getCreditHours()) + "," +
+                          to_string(course.getTotalSeats()) + "," + meetingTimes + "," + course.getName());
+    }
 
     // Add prerequisites
-    prerequisites.addPrerequisite("CS201", "CS101");
-    prerequisites.addPrerequisite("CS301", "CS201");
-    prerequisites.addPrerequisite("CS401", "CS301");
+    const pair<const char*, const char*> seedPrerequisites[] = {
+        {"CS201", "CS101"}, {"CS301", "CS201"}, {"CS401", "CS301"}
+    };
+    for (const auto& [course, prereq] : seedPrerequisites) {
+        linkPrerequisite(course, prereq);
+        records.push_back(string("PREREQ_ADD,") + course + "," + prereq);
+    }
+    publishCatalog();
+
+    // Last term, already sealed: what the current enrollments build on
+    const vector<Enrollment> seedCompleted = {
+        Enrollment("Sara", "MATH101"), Enrollment("Anas", "CS101"),
+        Enrollment("Adil", "CS101"), Enrollment("Adil", "CS201"),
+        Enrollment("Amjad", "CS101"), Enrollment("Amjad", "CS201"), Enrollment("Amjad", "CS301")
+    };
+    const string lastTerm = "2026-SPRING";
+    currentTerm = lastTerm;
+    sealTerm(groupEnrollments([&seedCompleted](auto visit) {
+        for (const Enrollment& e : seedCompleted) visit(e);
+    }));
+    startTerm(DEFAULT_TERM);
+    saveTerms();
+    records.push_back("TERM_ARCHIVE," + lastTerm);
 
     // Enroll random courses for students
-    enrollments.insert(Enrollment("Ali", "CS101"));
-    enrollments.insert(Enrollment("Ali", "MATH101"));
-    enrollments.insert(Enrollment("Sara", "CS101"));
-    enrollments.insert(Enrollment("Sara", "ENG101"));
-    enrollments.insert(Enrollment("Anas", "CS201"));
-    enrollments.insert(Enrollment("Adil", "CS301"));
-    enrollments.insert(Enrollment("Amjad", "CS401"));
-    enrollments.insert(Enrollment("student", "CS101"));
+    const Enrollment seedEnrollments[] = {
+        Enrollment("Ali", "CS101"), Enrollment("Ali", "MATH101"),
+        Enrollment("Sara", "CS101"), Enrollment("Sara", "ENG101"),
+        Enrollment("Anas", "CS201"), Enrollment("Adil", "CS301"),
+        Enrollment("Amjad", "CS401"), Enrollment("student", "CS101")
+    };
+    for (const Enrollment& e : seedEnrollments) {
+        Course* course = catalog.search(e.courseCode);
+        if (course != nullptr && course->enrollStudent()) {
+            catalog.addEnrollment(e);
+            countEnrollment(e.username, *course, 1);
+            records.push_back("ENROLL," + e.username + "," + e.courseCode);
+        }
+    }
 
+    markDirty(TABLE_ALL);
     saveData(); // Save initial seed data
+    journal(records); // After the files, so a replica reading the records finds the archive
 }
 
-bool CourseRegistrationSystem::login(const string& username, const string& password) {
-    User* user = users.search(username, userComparator);
+Result<LoginSession> CourseRegistrationSystem::login(const string& username, const string& password) {
+    TraceScope trace(*this, TraceOp::Login, nullptr, username, password);
+    refreshReplica();
+    User* user = findUser(username);
     if (user != nullptr) {
         // Use KMP for password matching (demonstration purpose)
         if (kmpSearch(user->getPassword(), password) && user->getPassword().length() == password.length()) {
-            currentUser = user;
-            cout << "Login successful! Welcome, " << user->getFullName() << "\n";
-            if (user->getIsAdmin()) {
-                cout << "Logged in as Administrator.\n";
-            } else {
-                cout << "Logged in as Student.\n";
-            }
-            return true;
+            SessionToken token = sessions.open(username, clockSeconds());
+            trace.fileUnder(token);
+            return LoginSession{std::move(token), viewOf(*user)};
         }
     }
-    return false;
+    return Status::InvalidCredentials;
 }
 
-void CourseRegistrationSystem::logout() {
-    if (currentUser != nullptr) {
-        cout << "Logged out successfully.\n";
-        currentUser = nullptr;
-    }
+Status CourseRegistrationSystem::logout(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::Logout, &session);
+    return sessions.close(session) ? Status::Ok : Status::NotLoggedIn;
+}
+
+// Resolved afresh on every call, so no pointer into the user list outlives
+// the call that looked it up
+User* CourseRegistrationSystem::sessionUser(const SessionToken& session) {
+    const string* username = sessions.touch(session, clockSeconds());
+    return username != nullptr ? findUser(*username) : nullptr;
 }
 
-void CourseRegistrationSystem::registerUser(const string& username, const string& password, const string& fullName, const string& rollNo) {
+Status CourseRegistrationSystem::registerUser(const string& username, const string& password, const string& fullName, const string& rollNo) {
+    TraceScope trace(*this, TraceOp::RegisterUser, nullptr, username, password, fullName, rollNo);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
     // Validate inputs
-    if (username.empty()) {
-        cout << "Error: Username cannot be empty!\n";
-        return;
-    }
+    if (username.empty()) return Status::EmptyUsername;
+    if (password.empty()) return Status::EmptyPassword;
+    if (password.length() < 3) return Status::PasswordTooShort;
+    if (fullName.empty()) return Status::EmptyFullName;
+    if (rollNo.empty()) return Status::EmptyRollNo;
 
-    if (password.empty()) {
-        cout << "Error: Password cannot be empty!\n";
-        return;
-    }
+    // Check for spaces in username
+    if (username.find(' ') != string::npos) return Status::UsernameHasSpaces;
 
-    if (password.length() < 3) {
-        cout << "Error: Password must be at least 3 characters long!\n";
-        return;
-    }
+    if (findUser(username) != nullptr) return Status::UsernameTaken;
+    if (users.search(rollNo, rollNoComparator) != nullptr) return Status::RollNoTaken;
 
-    if (fullName.empty()) {
-        cout << "Error: Full name cannot be empty!\n";
-        return;
-    }
+    // A name reused after a delete starts with no history from the sealed terms
+    User user(username, password, fullName, rollNo, false, static_cast<int>(archives.size()));
+    addUser(user);
+    appendUser(user);
+    journal("USER_ADD," + username + "," + password + "," + rollNo + ",0," + fullName);
+    return Status::Ok;
+}
 
-    if (rollNo.empty()) {
-        cout << "Error: Roll number cannot be empty!\n";
-        return;
+string CourseRegistrationSystem::sessionUsername(const SessionToken& session) {
+    User* user = sessionUser(session);
+    return user ? user->getUsername() : "";
+}
+
+bool CourseRegistrationSystem::hasCourse(const string& code) {
+    refreshReplica();
+    return catalog.search(code) != nullptr;
+}
+
+bool CourseRegistrationSystem::isAdmin(const SessionToken& session) {
+    User* user = sessionUser(session);
+    return user != nullptr && user->getIsAdmin();
+}
+
+vector<CourseView> CourseRegistrationSystem::listCourses(CourseOrder order) {
+    TraceScope trace(*this, TraceOp::ViewAllCourses, nullptr, order);
+    CatalogView snapshot = publishedCatalog.load();
+
+    vector<CourseView> courses;
+    courses.reserve(snapshot->byCode.size());
+    for (size_t i = 0; i < snapshot->byCode.size(); i++) {
+        const CatalogEntry& entry = snapshot->byCode[order == CourseOrder::ByCode ? static_cast<int>(i) : snapshot->byName[i]];
+        courses.push_back({entry.code, entry.name, entry.creditHours, entry.timeSlots,
+                           entry.availableSeats->load(memory_order_relaxed), entry.totalSeats, entry.prerequisites});
     }
+    return courses;
+}
 
-    // Check for spaces in username
-    if (username.find(' ') != string::npos) {
-        cout << "Error: Username cannot contain spaces!\n";
-        return;
+optional<CourseView> CourseRegistrationSystem::findCourse(const string& code) {
+    TraceScope trace(*this, TraceOp::SearchCourse, nullptr, code);
+    CatalogView snapshot = publishedCatalog.load();
+    const CatalogEntry* entry = findCatalogEntry(*snapshot, code);
+    if (entry == nullptr) return nullopt;
+    return CourseView{entry->code, entry->name, entry->creditHours, entry->timeSlots,
+                      entry->availableSeats->load(memory_order_relaxed), entry->totalSeats, entry->prerequisites};
+}
+
+// Shard i goes to task i; shards share nothing, so visit may touch its own shard freely
+void CourseRegistrationSystem::forEachShardInParallel(const function<void(ShardedCatalog::Shard&, int)>& visit) {
+    vector<ShardedCatalog::Shard*> shards;
+    catalog.forEachShard([&shards](ShardedCatalog::Shard& shard) { shards.push_back(&shard); });
+    workPool().run(static_cast<int>(shards.size()), [&shards, &visit](int i) { visit(*shards[i], i); });
+}
+
+TaskPool& CourseRegistrationSystem::workPool() {
+    return taskPool ? *taskPool : sharedTaskPool();
+}
+
+void CourseRegistrationSystem::setTaskPool(TaskPool& pool) {
+    taskPool = &pool;
+}
+
+// Sets each course's open seats to its total less enrollments and holds, one
+// shard per task, then republishes the courses that moved. Returns how many did.
+int CourseRegistrationSystem::rebuildSeatCounts() {
+    vector<vector<Course*>> changed(catalog.shardCount());
+    forEachShardInParallel([&changed](ShardedCatalog::Shard& shard, int i) {
+        HashTable<int> enrolled;
+        for (Node<Enrollment>* current = shard.enrollments.getHead(); current != nullptr; current = current->next) {
+            (*enrolled.searchOrInsert(current->data.courseCode))++;
+        }
+        auto seatsOpen = [&enrolled](const Course& course) {
+            const int* count = enrolled.search(course.getCode());
+            return max(0, course.getTotalSeats() - (count ? *count : 0) - course.getHeldSeats());
+        };
+        vector<string> moved;
+        shard.courses.forEachInorder([&seatsOpen, &moved](const Course& course) {
+            if (seatsOpen(course) != course.getAvailableSeats()) moved.emplace_back(course.getCode());
+        });
+        for (const string& code : moved) {
+            Course* course = shard.courses.search(code);
+            course->setAvailableSeats(seatsOpen(*course));
+            changed[i].push_back(course);
+        }
+    });
+    int corrected = 0;
+    for (const vector<Course*>& part : changed) {
+        for (Course* course : part) syncOpenSeats(*course);
+        corrected += static_cast<int>(part.size());
     }
+    return corrected;
+}
 
-    User* existing = users.search(username, userComparator);
-    if (existing != nullptr) {
-        cout << "Error: Username already exists!\n";
-        return;
+// Rebuilds and publishes the catalog if course details or prerequisites changed
+// since the last publish. Every operation that changes them calls this before
+// returning, so readers only ever load the pointer. A reader keeps its copy
+// alive for as long as it holds it, so a later publish never pulls data out
+// from under it.
+void CourseRegistrationSystem::publishCatalog() {
+    CatalogView snapshot = publishedCatalog.load();
+    if (snapshot && snapshot->version == catalogVersion) return;
+
+    auto built = make_shared<CatalogSnapshot>();
+    built->version = catalogVersion;
+    catalog.forEachShard([&](ShardedCatalog::Shard& shard) {
+        shard.courses.forEachInorder([&](const Course& course) {
+            built->byCode.push_back({course.getKey(), string(course.getCode()), course.getName(), course.getCreditHours(),
+                                     course.getTotalSeats(), course.getTimeSlots(),
+                                     prerequisites.getPrerequisites(course.getCode()),
+                                     *seatCounters.search(course.getCode())});
+        });
+    });
+    built->byName.resize(built->byCode.size());
+    for (size_t i = 0; i < built->byName.size(); i++) built->byName[i] = static_cast<int>(i);
+    sort(built->byName.begin(), built->byName.end(), [&built](int a, int b) {
+        return built->byCode[a].name < built->byCode[b].name;
+    });
+
+    publishedCatalog.store(std::move(built));
+}
+
+const CatalogEntry* CourseRegistrationSystem::findCatalogEntry(const CatalogSnapshot& snapshot, const string& code) {
+    if (!CourseKey::fits(code)) return nullptr;
+    CourseKey key(code);
+    auto it = lower_bound(snapshot.byCode.begin(), snapshot.byCode.end(), key,
+                          [](const CatalogEntry& entry, const CourseKey& k) { return entry.key < k; });
+    return (it != snapshot.byCode.end() && it->key == key) ? &*it : nullptr;
+}
+
+Outcome CourseRegistrationSystem::enrollCourse(const SessionToken& session, const string& code) {
+    TraceScope trace(*this, TraceOp::EnrollCourse, &session, code);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (currentUser->getIsAdmin()) return Status::AdminNotAllowed;
+
+    Outcome admitted = admitRequest(*currentUser);
+    if (!admitted.ok()) return admitted;
+
+    Course* course = catalog.search(code);
+    if (course == nullptr) return Status::CourseNotFound;
+
+    // A held seat is simply confirmed
+    expireHolds();
+    if (seatHolds.search(holdKey(currentUser->getUsername(), code)) != nullptr) {
+        return confirmHold(session, code);
     }
 
-    User* existingRoll = users.search(rollNo, rollNoComparator);
-    if (existingRoll != nullptr) {
-        cout << "Error: User with this Roll No already exists!\n";
-        return;
+    if (isEnrolled(currentUser->getUsername(), code)) return Status::AlreadyEnrolled;
+    if (hasCompleted(currentUser->getUsername(), code)) return Status::AlreadyCompleted;
+
+    // Check prerequisites
+    if (!checkPrerequisites(currentUser->getUsername(), code)) {
+        Outcome missing(Status::PrerequisitesMissing, code);
+        missing.items = prerequisites.getPrerequisites(code);
+        return missing;
     }
 
-    users.insert(User(username, password, fullName, rollNo, false));
-    cout << "Registration successful! You can now login.\n";
-    saveData();
+    Outcome fit = checkFit(currentUser->getUsername(), *course);
+    if (!fit.ok()) return fit;
+
+    if (!addEnrollment(currentUser->getUsername(), course)) return Status::NoSeats;
+    recordAction(currentUser->getUsername(), UserAction(ActionType::Enroll, code));
+    return Outcome(Status::Ok, course->getName());
 }
 
-bool CourseRegistrationSystem::isCurrentUserAdmin() {
-    return currentUser != nullptr && currentUser->getIsAdmin();
+Outcome CourseRegistrationSystem::holdSeat(const SessionToken& session, const string& code) {
+    TraceScope trace(*this, TraceOp::HoldSeat, &session, code);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (currentUser->getIsAdmin()) return Status::AdminNotAllowed;
+
+    Outcome admitted = admitRequest(*currentUser);
+    if (!admitted.ok()) return admitted;
+
+    Course* course = catalog.search(code);
+    if (course == nullptr) return Status::CourseNotFound;
+
+    expireHolds();
+    string key = holdKey(currentUser->getUsername(), code);
+    if (seatHolds.search(key) != nullptr) return Status::AlreadyHeld;
+    if (isEnrolled(currentUser->getUsername(), code)) return Status::AlreadyEnrolled;
+    if (hasCompleted(currentUser->getUsername(), code)) return Status::AlreadyCompleted;
+    if (!checkPrerequisites(currentUser->getUsername(), code)) return Outcome(Status::PrerequisitesMissing, code);
+
+    Outcome fit = checkFit(currentUser->getUsername(), *course);
+    if (!fit.ok()) return fit;
+
+    if (!course->holdSeat()) return Status::NoSeats;
+    syncOpenSeats(*course);
+
+    uint64_t expiry = holdTimers.currentTick() + holdDurationSeconds;
+    seatHolds.insert(key, holdTimers.schedule(Enrollment(currentUser->getUsername(), code), expiry));
+    journal("HOLD," + currentUser->getUsername() + "," + code + "," + to_string(holdDurationSeconds));
+    Outcome held(Status::Ok, course->getName());
+    held.count = holdDurationSeconds / 60;
+    return held;
 }
 
-void CourseRegistrationSystem::viewAllCourses(int sortOption) {
-    vector<Course> courseList;
-    collectCourses(courses.getRoot(), courseList);
+Outcome CourseRegistrationSystem::confirmHold(const SessionToken& session, const string& code) {
+    TraceScope trace(*this, TraceOp::ConfirmHold, &session, code);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
 
-    if (courseList.empty()) {
-        cout << "No courses available.\n";
-        return;
-    }
+    expireHolds();
+    string key = holdKey(currentUser->getUsername(), code);
+    TimingWheel<Enrollment>::Timer** hold = seatHolds.search(key);
+    if (hold == nullptr) return Status::NoHold;
 
-    if (sortOption == 0) {
-        // Sort by code (default BST inorder)
-        cout << "\n--- All Courses (Sorted by Code) ---\n";
-    } else {
-        // Sort by name
-        cout << "\n--- All Courses (Sorted by Name) ---\n";
-        sortCoursesByName(courseList);
+    // A course taken since the hold was placed may now overlap it; the hold is left to expire
+    Course* course = catalog.search(code);
+    if (course != nullptr) {
+        Outcome fit = checkFit(currentUser->getUsername(), *course);
+        if (!fit.ok()) return fit;
     }
 
-    for (const auto& course : courseList) {
-        cout << "Code: " << course.getCode()
-             << " | Name: " << course.getName()
-             << " | Credit Hours: " << course.getCreditHours()
-             << " | Available Seats: " << course.getAvailableSeats()
-             << "/" << course.getTotalSeats();
-
-        vector<string> prereqs = prerequisites.getPrerequisites(course.getCode());
-        if (!prereqs.empty()) {
-            cout << " | Prerequisites: ";
-            for (size_t i = 0; i < prereqs.size(); ++i) {
-                cout << prereqs[i] << (i < prereqs.size() - 1 ? ", " : "");
-            }
-        } else {
-            cout << " | Prerequisites: None";
-        }
-        cout << "\n";
+    holdTimers.cancel(*hold);
+    seatHolds.remove(key);
+
+    if (course == nullptr || !course->convertHold()) return Status::CourseNotFound;
+
+    Enrollment enrollment(currentUser->getUsername(), code);
+    catalog.addEnrollment(enrollment);
+    countEnrollment(enrollment.username, *course, 1);
+    appendEnrollment(enrollment);
+    journal("ENROLL," + enrollment.username + "," + code);
+    recordAction(currentUser->getUsername(), UserAction(ActionType::Enroll, code));
+    return Outcome(Status::Ok, course->getName());
+}
+
+Outcome CourseRegistrationSystem::releaseHold(const SessionToken& session, const string& code) {
+    TraceScope trace(*this, TraceOp::ReleaseHold, &session, code);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+
+    expireHolds();
+    if (!dropHold(currentUser->getUsername(), code)) return Status::NoHold;
+    journal("UNHOLD," + currentUser->getUsername() + "," + code);
+    return Status::Ok;
+}
+
+// Ends a hold early, cancelling its timer and returning the seat; false if there was none
+bool CourseRegistrationSystem::dropHold(const string& username, const string& code) {
+    string key = holdKey(username, code);
+    TimingWheel<Enrollment>::Timer** hold = seatHolds.search(key);
+    if (hold == nullptr) return false;
+    holdTimers.cancel(*hold);
+    seatHolds.remove(key);
+
+    Course* course = catalog.search(code);
+    if (course != nullptr) {
+        course->releaseHold();
+        syncOpenSeats(*course);
     }
+    return true;
 }
 
-void CourseRegistrationSystem::collectCourses(BSTNode* node, vector<Course>& courseList) {
-    if (node != nullptr) {
-        collectCourses(node->left, courseList);
-        courseList.push_back(node->data);
-        collectCourses(node->right, courseList);
+double CourseRegistrationSystem::clockSeconds() {
+    if (setTime) return *setTime;
+    return chrono::duration<double>(chrono::steady_clock::now() - clockStart).count();
+}
+
+void CourseRegistrationSystem::setClock(double seconds) {
+    setTime = seconds;
+    tick();
+}
+
+void CourseRegistrationSystem::tick() {
+    refreshReplica();
+    expireHolds();
+}
+
+Status CourseRegistrationSystem::startRecording(const string& path) {
+    saveData(); // The trace embeds the files, so they must hold everything in memory
+    auto writer = make_unique<TraceWriter>(path);
+    if (!writer->isOpen()) return Status::CannotOpenFile;
+    recorder = std::move(writer);
+    recordingStart = clockSeconds();
+    return Status::Ok;
+}
+
+// Runs a student's request past admission control; refusals say when to come back
+Outcome CourseRegistrationSystem::admitRequest(const User& student) {
+    double now = clockSeconds();
+    AdmissionDecision decision = admission.admit(student.getUsername(), student.getRollNo(), now);
+    Outcome outcome;
+    switch (decision.result) {
+        case Admission::Admitted: return outcome;
+        case Admission::WindowClosed: outcome.status = Status::WindowClosed; break;
+        case Admission::RateLimited: outcome.status = Status::RateLimited; break;
+        case Admission::Queued: outcome.status = Status::Queued; break;
+        case Admission::Shed: outcome.status = Status::Shed; break;
+    }
+    outcome.waitSeconds = decision.retryAt - now;
+    return outcome;
+}
+
+// Whether the course fits the student's week and credit limit
+Outcome CourseRegistrationSystem::checkFit(const string& username, const Course& course) {
+    if (hasScheduleConflict(username, course)) {
+        Outcome conflict(Status::ScheduleConflict, string(course.getCode()));
+        conflict.detail = formatSchedule(course.getTimeSlots());
+        return conflict;
     }
+    if (exceedsCreditLimit(username, course)) {
+        Outcome over(Status::CreditLimitExceeded, string(course.getCode()));
+        over.count = creditLoad(username) + course.getCreditHours();
+        over.limit = maxCreditHours;
+        return over;
+    }
+    return Status::Ok;
 }
 
-void CourseRegistrationSystem::sortCoursesByName(vector<Course>& courseList) {
-    sort(courseList.begin(), courseList.end(), [](const Course& a, const Course& b) {
-        return a.getName() < b.getName();
+// Advances the hold clock to now; each expired hold returns its seat.
+// Cost is proportional to the elapsed ticks plus the holds that expire,
+// never to the number of holds still pending.
+void CourseRegistrationSystem::expireHolds() {
+    vector<string> expired;
+    holdTimers.advance(static_cast<uint64_t>(clockSeconds()), [this, &expired](const Enrollment& hold) {
+        Course* course = catalog.search(hold.courseCode);
+        if (course != nullptr) {
+            course->releaseHold();
+            syncOpenSeats(*course);
+        }
+        seatHolds.remove(holdKey(hold.username, hold.courseCode));
+        expired.push_back("UNHOLD," + hold.username + "," + hold.courseCode);
     });
+    journal(expired);
 }
 
-void CourseRegistrationSystem::searchCourse(const string& code) {
-    Course* course = courses.search(code);
-    if (course != nullptr) {
-        cout << "\n--- Course Details ---\n";
-        cout << "Code: " << course->getCode() << "\n";
-        cout << "Name: " << course->getName() << "\n";
-        cout << "Credit Hours: " << course->getCreditHours() << "\n";
-        cout << "Available Seats: " << course->getAvailableSeats() << "/" << course->getTotalSeats() << "\n";
-
-        vector<string> prereqs = prerequisites.getPrerequisites(course->getCode());
-        cout << "Prerequisites: ";
-        if (!prereqs.empty()) {
-            for (size_t i = 0; i < prereqs.size(); ++i) {
-                cout << prereqs[i] << (i < prereqs.size() - 1 ? ", " : "");
-            }
-        } else {
-            cout << "None";
+// Cancels the matching holds and their timers, returning each seat to its course
+void CourseRegistrationSystem::cancelHoldsIf(const function<bool(const Enrollment&)>& matches) {
+    vector<TimingWheel<Enrollment>::Timer*> holds;
+    seatHolds.forEach([&holds, &matches](TimingWheel<Enrollment>::Timer* timer) {
+        if (matches(timer->data)) holds.push_back(timer);
+    });
+    for (TimingWheel<Enrollment>::Timer* hold : holds) {
+        Course* course = catalog.search(hold->data.courseCode);
+        if (course != nullptr) {
+            course->releaseHold();
+            syncOpenSeats(*course);
         }
-        cout << "\n";
-    } else {
-        cout << "Course not found!\n";
+        seatHolds.remove(holdKey(hold->data.username, hold->data.courseCode));
+        holdTimers.cancel(hold);
     }
 }
 
-void CourseRegistrationSystem::enrollCourse(const string& code) {
-    if (currentUser == nullptr) {
-        cout << "Please login first!\n";
-        return;
+// Running totals: every change to courses, enrollments or payments passes through these
+void CourseRegistrationSystem::countCourse(const Course& course, int delta) {
+    DepartmentStats* stats = departmentStats.searchOrInsert(departmentOf(course.getCode()));
+    stats->courses += delta;
+    stats->totalSeats += delta * course.getTotalSeats();
+    catalogVersion++;
+    if (delta > 0) {
+        courseIndex.add(course.getCode());
+        syncOpenSeats(course);
+    } else {
+        courseIndex.remove(course.getCode());
+        seatCounters.remove(course.getCode()); // Snapshots still listing the course keep theirs
+        forgetPlans(plansByCourse, course.getCode());
     }
+}
 
-    if (currentUser->getIsAdmin()) {
-        cout << "Administrators cannot enroll in courses!\n";
-        return;
-    }
+// Also called right after every enroll/unenroll, so it keeps the open-seat bit current
+void CourseRegistrationSystem::countEnrollment(const string& username, const Course& course, int delta) {
+    departmentStats.searchOrInsert(departmentOf(course.getCode()))->enrollments += delta;
+    StudentLoad* load = studentLoads.searchOrInsert(username);
+    load->courses += delta;
+    load->creditHours += delta * course.getCreditHours();
+    bookSlots(username, course.getTimeSlots(), delta);
+    forgetPlans(plansByStudent, username);
+    int id = courseIndex.idOf(course.getCode());
+    if (id >= 0) {
+        CourseIndex::mark(*takenCourses.searchOrInsert(username), id, delta > 0);
+    }
+    syncOpenSeats(course);
+}
 
-    Course* course = courses.search(code);
-    if (course == nullptr) {
-        cout << "Course not found!\n";
-        return;
+void CourseRegistrationSystem::syncOpenSeats(const Course& course) {
+    courseIndex.setOpen(course.getCode(), course.getAvailableSeats() > 0);
+    SeatCounter* counter = seatCounters.searchOrInsert(course.getCode());
+    if (*counter == nullptr) *counter = make_shared<atomic<int>>();
+    (*counter)->store(course.getAvailableSeats(), memory_order_relaxed);
+}
+
+// Every prerequisite edge goes through here so the graph and the course index agree
+bool CourseRegistrationSystem::linkPrerequisite(const string& course, const string& prereq) {
+    if (!prerequisites.addPrerequisite(course, prereq)) return false;
+    courseIndex.addPrerequisite(course, prereq);
+    catalogVersion++;
+    forgetPlans(plansByCourse, course);
+    return true;
+}
+
+bool CourseRegistrationSystem::hasTaken(const string& username, const string& code) {
+    vector<uint64_t>* taken = takenCourses.search(username);
+    if (taken != nullptr && CourseIndex::test(*taken, courseIndex.idOf(code))) return true;
+    return hasCompleted(username, code);
+}
+
+// Drops every cached plan filed under owner (a course or a student); the plans'
+// other index entries go stale and are skipped when they are next cleared
+void CourseRegistrationSystem::forgetPlans(HashTable<vector<string>>& byOwner, string_view owner) {
+    vector<string>* keys = byOwner.search(owner);
+    if (keys == nullptr) return;
+    for (const string& key : *keys) degreePlans.remove(key);
+    byOwner.remove(owner);
+}
+
+// Builds (or returns the cached) plan for reaching target. Untaken prerequisites
+// are collected transitively, layered with Kahn's algorithm, and each course is
+// placed in the first term after its prerequisites that still has credit room.
+const DegreePlan* CourseRegistrationSystem::degreePlanFor(const string& username, const string& target) {
+    string key = holdKey(username, target);
+    DegreePlan* cached = degreePlans.search(key);
+    if (cached != nullptr && cached->maxCredits == maxCreditHours) return cached;
+    if (cached != nullptr) degreePlans.remove(key);
+
+    DegreePlan plan;
+    plan.maxCredits = maxCreditHours;
+
+    // Closure of untaken prerequisites, target included
+    vector<string> closure;
+    HashTable<int> position; // Code -> index in closure
+    vector<string> pending = {target};
+    while (!pending.empty()) {
+        string code = pending.back();
+        pending.pop_back();
+        if (position.search(code) != nullptr || hasTaken(username, code)) continue;
+        position.insert(code, static_cast<int>(closure.size()));
+        closure.push_back(code);
+        for (const string& prereq : prerequisites.getPrerequisites(code)) pending.push_back(prereq);
+    }
+
+    // Edges within the closure, prerequisite -> dependent
+    vector<int> unmet(closure.size(), 0);
+    vector<vector<int>> dependents(closure.size());
+    for (size_t i = 0; i < closure.size(); i++) {
+        for (const string& prereq : prerequisites.getPrerequisites(closure[i])) {
+            int* from = position.search(prereq);
+            if (from == nullptr) continue;
+            dependents[*from].push_back(static_cast<int>(i));
+            unmet[i]++;
+        }
     }
 
-    // Check if already enrolled
-    Node<Enrollment>* current = enrollments.getHead();
-    while (current != nullptr) {
-        if (current->data.username == currentUser->getUsername() &&
-            current->data.courseCode == code) {
-            cout << "You are already enrolled in this course!\n";
-            return;
+    vector<int> ready;
+    for (size_t i = 0; i < closure.size(); i++) {
+        if (unmet[i] == 0) ready.push_back(static_cast<int>(i));
+    }
+    vector<int> earliest(closure.size(), 0); // First term each course may go in
+    size_t placed = 0;
+    while (!ready.empty() && plan.feasible) {
+        vector<int> layer;
+        layer.swap(ready);
+        for (int i : layer) {
+            Course* course = catalog.search(closure[i]);
+            int credits = course ? course->getCreditHours() : 0;
+            if (course == nullptr || credits > maxCreditHours) {
+                plan.feasible = false;
+                plan.problem = course == nullptr ? closure[i] + " is not in the catalog"
+                                                 : closure[i] + " alone exceeds the credit limit";
+                break;
+            }
+            int term = earliest[i];
+            while (term < static_cast<int>(plan.terms.size()) && plan.termCredits[term] + credits > maxCreditHours) term++;
+            if (term == static_cast<int>(plan.terms.size())) {
+                plan.terms.emplace_back();
+                plan.termCredits.push_back(0);
+            }
+            plan.terms[term].push_back(closure[i]);
+            plan.termCredits[term] += credits;
+            placed++;
+            for (int next : dependents[i]) {
+                earliest[next] = max(earliest[next], term + 1);
+                if (--unmet[next] == 0) ready.push_back(next);
+            }
         }
-        current = current->next;
+    }
+    if (plan.feasible && placed < closure.size()) {
+        plan.feasible = false;
+        plan.problem = "the prerequisites of " + target + " form a cycle";
     }
 
-    // Check prerequisites
-    if (!checkPrerequisites(code)) {
-        cout << "You have not completed the prerequisites for this course!\n";
-        vector<string> prereqs = prerequisites.getPrerequisites(code);
-        cout << "Prerequisites: ";
-        for (const string& p : prereqs) cout << p << " ";
-        cout << "\n";
-        return;
+    // File the plan under everything that can invalidate it
+    for (const string& code : closure) {
+        vector<string>* keys = plansByCourse.searchOrInsert(code);
+        if (find(keys->begin(), keys->end(), key) == keys->end()) keys->push_back(key);
     }
+    vector<string>* keys = plansByStudent.searchOrInsert(username);
+    if (find(keys->begin(), keys->end(), key) == keys->end()) keys->push_back(key);
 
-    if (course->enrollStudent()) {
-        Enrollment enrollment(currentUser->getUsername(), code);
-        enrollments.insert(enrollment);
-        undoStack.push(enrollment);
-        cout << "Successfully enrolled in " << course->getName() << "!\n";
-        saveData();
-    } else {
-        cout << "No seats available!\n";
+    degreePlans.insert(key, std::move(plan));
+    return degreePlans.search(key);
+}
+
+// Adds (delta 1) or releases (delta -1) a course's hours on the student's weekly schedule
+void CourseRegistrationSystem::bookSlots(const string& username, uint64_t slots, int delta) {
+    if (slots == 0) return;
+    StudentSchedule* schedule = schedules.searchOrInsert(username);
+    for (uint64_t rest = slots; rest != 0; rest &= rest - 1) {
+        int slot = countr_zero(rest);
+        schedule->slotCounts[slot] = static_cast<unsigned char>(schedule->slotCounts[slot] + delta);
+        if (schedule->slotCounts[slot] == 0) {
+            schedule->busySlots &= ~(uint64_t(1) << slot);
+        } else {
+            schedule->busySlots |= uint64_t(1) << slot;
+        }
     }
 }
 
-void CourseRegistrationSystem::viewMyHistory() {
-    if (currentUser == nullptr) {
-        cout << "Please login first!\n";
-        return;
+int CourseRegistrationSystem::creditLoad(const string& username) {
+    StudentLoad* load = studentLoads.search(username);
+    return load ? load->creditHours : 0;
+}
+
+// Credit limits read the running total, so they cost one lookup per check
+bool CourseRegistrationSystem::exceedsCreditLimit(const string& username, const Course& course) {
+    return creditLoad(username) + course.getCreditHours() > maxCreditHours;
+}
+
+bool CourseRegistrationSystem::breaksCreditMinimum(const string& username, const Course& course) {
+    return creditLoad(username) - course.getCreditHours() < minCreditHours;
+}
+
+// One AND against the student's busy hours, however many courses they take
+bool CourseRegistrationSystem::hasScheduleConflict(const string& username, const Course& course) {
+    StudentSchedule* schedule = schedules.search(username);
+    return schedule != nullptr && (schedule->busySlots & course.getTimeSlots()) != 0;
+}
+
+void CourseRegistrationSystem::countPayment(const Payment& payment, int delta) {
+    for (PaymentStats* stats : {&paymentStats, paymentTotals.searchOrInsert(payment.username)}) {
+        if (payment.status == "Completed") {
+            stats->completedCount += delta;
+            stats->completedAmount += delta * payment.amount;
+        } else if (payment.status == "Voided") {
+            stats->voidedCount += delta;
+            stats->voidedAmount += delta * payment.amount;
+        }
     }
+}
 
-    if (currentUser->getIsAdmin()) {
-        cout << "Administrators do not have enrollment history!\n";
-        return;
+// Every payment enters through here so the per-user index and totals stay complete
+Payment* CourseRegistrationSystem::addPayment(Payment payment) {
+    string id = payment.transactionId;
+    paymentsByUser.searchOrInsert(payment.username)->push_back(id);
+    payments.insert(id, std::move(payment));
+    Payment* stored = payments.search(id);
+    countPayment(*stored, 1);
+    return stored;
+}
+
+// A deleted account's payments go with it; the caller records the purge
+void CourseRegistrationSystem::forgetPayments(const string& username) {
+    vector<string>* ids = paymentsByUser.search(username);
+    if (ids == nullptr) return;
+    for (const string& id : *ids) {
+        Payment* payment = payments.search(id);
+        if (payment == nullptr) continue;
+        countPayment(*payment, -1);
+        payments.remove(id);
+    }
+    paymentsByUser.remove(username);
+    paymentTotals.remove(username);
+}
+
+void CourseRegistrationSystem::setPaymentStatus(Payment& payment, const string& status) {
+    countPayment(payment, -1);
+    payment.status = status;
+    countPayment(payment, 1);
+}
+
+void CourseRegistrationSystem::addUser(User user) {
+    User* stored = users.insert(std::move(user));
+    userIndex.insert(stored->getUsername(), stored);
+}
+
+User* CourseRegistrationSystem::findUser(const string& username) {
+    User** user = userIndex.search(username);
+    return user ? *user : nullptr;
+}
+
+UserView CourseRegistrationSystem::viewOf(const User& user) {
+    return {user.getUsername(), user.getFullName(), user.getRollNo(), user.getIsAdmin()};
+}
+
+CourseView CourseRegistrationSystem::viewOf(const Course& course) {
+    return {string(course.getCode()), course.getName(), course.getCreditHours(), course.getTimeSlots(),
+            course.getAvailableSeats(), course.getTotalSeats(), prerequisites.getPrerequisites(course.getCode())};
+}
+
+bool CourseRegistrationSystem::isEnrolled(const string& username, const string& code) {
+    return catalog.hasEnrollment(username, code);
+}
+
+Outcome CourseRegistrationSystem::dropCourse(const SessionToken& session, const string& code) {
+    TraceScope trace(*this, TraceOp::DropCourse, &session, code);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (currentUser->getIsAdmin()) return Status::AdminNotAllowed;
+
+    Course* course = catalog.search(code);
+    if (course == nullptr) return Status::CourseNotFound;
+
+    if (isEnrolled(currentUser->getUsername(), code) && breaksCreditMinimum(currentUser->getUsername(), *course)) {
+        Outcome below(Status::CreditMinimum, string(course->getCode()));
+        below.limit = minCreditHours;
+        return below;
     }
 
-    cout << "\n--- My Enrolled Courses ---\n";
-    bool hasEnrollments = false;
-    Node<Enrollment>* current = enrollments.getHead();
-    while (current != nullptr) {
-        if (current->data.username == currentUser->getUsername()) {
-            Course* course = courses.search(current->data.courseCode);
-            if (course != nullptr) {
-                cout << "Code: " << course->getCode() << " | Name: " << course->getName() << "\n";
-                hasEnrollments = true;
-            }
+    if (!removeEnrollment(currentUser->getUsername(), course)) return Status::NotEnrolled;
+    recordAction(currentUser->getUsername(), UserAction(ActionType::Drop, code));
+    return Outcome(Status::Ok, course->getName());
+}
+
+Result<StudentRecord> CourseRegistrationSystem::myEnrollments(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::ViewMyHistory, &session);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (currentUser->getIsAdmin()) return Status::AdminNotAllowed;
+
+    StudentRecord record;
+    catalog.forEachEnrollment([&](const Enrollment& e) {
+        if (e.username == currentUser->getUsername()) {
+            Course* course = catalog.search(e.courseCode);
+            if (course != nullptr) record.courses.push_back(viewOf(*course));
         }
-        current = current->next;
+    });
+    record.creditHours = creditLoad(currentUser->getUsername());
+    record.minCreditHours = minCreditHours;
+    record.maxCreditHours = maxCreditHours;
+    return record;
+}
+
+// Every course the student could enroll in right now: open, not yet taken and
+// with all prerequisites completed. One word-parallel pass over the course index.
+Result<vector<CourseView>> CourseRegistrationSystem::eligibleCourses(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::ViewEligibleCourses, &session);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (currentUser->getIsAdmin()) return Status::AdminNotAllowed;
+
+    expireHolds();
+    static const vector<uint64_t> nothingTaken;
+    vector<uint64_t>* taken = takenCourses.search(currentUser->getUsername());
+    vector<int> ids;
+    courseIndex.eligible(taken ? *taken : nothingTaken, completedCourses(currentUser->getUsername()), ids);
+
+    vector<Course*> eligible;
+    eligible.reserve(ids.size());
+    for (int id : ids) {
+        Course* course = catalog.search(courseIndex.codeOf(id));
+        if (course != nullptr) eligible.push_back(course);
+    }
+    sort(eligible.begin(), eligible.end(), [](const Course* a, const Course* b) {
+        return a->getKey() < b->getKey();
+    });
+
+    vector<CourseView> views;
+    views.reserve(eligible.size());
+    for (const Course* course : eligible) views.push_back(viewOf(*course));
+    return views;
+}
+
+// Students may plan for themselves; admins (acting as advisors) for anyone
+Result<DegreePlan> CourseRegistrationSystem::degreePlan(const SessionToken& session, const string& username,
+                                                       const string& target) {
+    TraceScope trace(*this, TraceOp::ViewDegreePlan, &session, username, target);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (!currentUser->getIsAdmin() && currentUser->getUsername() != username) return Status::AccessDenied;
+
+    User* student = findUser(username);
+    if (student == nullptr || student->getIsAdmin()) return Status::StudentNotFound;
+    if (catalog.search(target) == nullptr) return Status::CourseNotFound;
+    if (hasCompleted(username, target)) return Status::AlreadyCompleted;
+    if (hasTaken(username, target)) return Status::AlreadyEnrolled;
+
+    return *degreePlanFor(username, target);
+}
+
+Result<UserAction> CourseRegistrationSystem::undoLastAction(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::UndoLastAction, &session);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (currentUser->getIsAdmin()) return Status::AdminNotAllowed;
+
+    UndoLog* log = undoLogFor(currentUser->getUsername());
+    UserAction action;
+    if (!log->undo.pop(action)) return Status::NothingToUndo;
+
+    if (!applyAction(currentUser->getUsername(), action, true)) return {Status::NoLongerApplies, action};
+    log->redo.push(action);
+    return action;
+}
+
+Result<UserAction> CourseRegistrationSystem::redoLastAction(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::RedoLastAction, &session);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (currentUser->getIsAdmin()) return Status::AdminNotAllowed;
+
+    UndoLog* log = undoLogFor(currentUser->getUsername());
+    UserAction action;
+    if (!log->redo.pop(action)) return Status::NothingToUndo;
+
+    if (!applyAction(currentUser->getUsername(), action, false)) return {Status::NoLongerApplies, action};
+    log->undo.push(action);
+    return action;
+}
+
+UndoLog* CourseRegistrationSystem::undoLogFor(const string& username) {
+    UndoLog* log = undoLogs.search(username);
+    if (log == nullptr) {
+        undoLogs.insert(username, UndoLog());
+        log = undoLogs.search(username);
     }
-    if (!hasEnrollments) {
-        cout << "No enrollments yet.\n";
+    return log;
+}
+
+// A new action invalidates anything that was waiting to be redone
+void CourseRegistrationSystem::recordAction(const string& username, const UserAction& action) {
+    UndoLog* log = undoLogFor(username);
+    log->undo.push(action);
+    log->redo.clear();
+}
+
+// Performs an action for the user, or its inverse when reverse is set
+bool CourseRegistrationSystem::applyAction(const string& username, const UserAction& action, bool reverse) {
+    if (action.type == ActionType::VoidPayment) {
+        Payment* payment = payments.search(action.target);
+        if (payment == nullptr || payment->username != username) return false;
+        setPaymentStatus(*payment, reverse ? "Completed" : "Voided");
+        appendPaymentStatus(*payment);
+        journal(statusRecord(*payment));
+        return true;
     }
+
+    Course* course = catalog.search(action.target);
+    if (course == nullptr) return false;
+
+    bool addsEnrollment = (action.type == ActionType::Enroll) != reverse;
+    if (addsEnrollment && (hasScheduleConflict(username, *course) || exceedsCreditLimit(username, *course))) return false;
+    if (!addsEnrollment && isEnrolled(username, action.target) && breaksCreditMinimum(username, *course)) return false;
+    return addsEnrollment ? addEnrollment(username, course) : removeEnrollment(username, course);
 }
 
-void CourseRegistrationSystem::undoLastAction() {
-    if (currentUser == nullptr) {
-        cout << "Please login first!\n";
-        return;
+bool CourseRegistrationSystem::addEnrollment(const string& username, Course* course) {
+    if (!course->enrollStudent()) return false;
+    Enrollment enrollment(username, string(course->getCode()));
+    catalog.addEnrollment(enrollment);
+    countEnrollment(username, *course, 1);
+    // Seat counts are rebuilt from enrollments on load, so one appended line is enough
+    appendEnrollment(enrollment);
+    journal("ENROLL," + username + "," + enrollment.courseCode);
+    return true;
+}
+
+bool CourseRegistrationSystem::removeEnrollment(const string& username, Course* course) {
+    if (!catalog.removeEnrollment(username, string(course->getCode()))) return false;
+    course->unenrollStudent();
+    countEnrollment(username, *course, -1);
+    appendEnrollmentDrops({Enrollment(username, string(course->getCode()))});
+    journal("DROP," + username + "," + string(course->getCode()));
+    return true;
+}
+
+// Admin Functions
+
+Status CourseRegistrationSystem::addCourse(const SessionToken& session, const string& code, const string& name,
+                                           int creditHours, int totalSeats, const string& meetingTimes) {
+    TraceScope trace(*this, TraceOp::AddCourse, &session, code, name, creditHours, totalSeats, meetingTimes);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+
+    // Validate inputs
+    if (code.empty()) return Status::EmptyCourseCode;
+    if (code.length() > CourseKey::MAX_LENGTH) return Status::CourseCodeTooLong;
+    if (!CourseKey::fits(code)) return Status::CourseCodeHasNul;
+    if (name.empty()) return Status::EmptyCourseName;
+    if (creditHours <= 0) return Status::CreditHoursNotPositive;
+    if (creditHours > 6) return Status::CreditHoursTooHigh;
+    if (totalSeats <= 0) return Status::SeatsNotPositive;
+
+    uint64_t slots = 0;
+    if (!parseSchedule(meetingTimes, slots)) return Status::InvalidMeetingTimes;
+
+    if (catalog.search(code) != nullptr) return Status::CourseExists;
+
+    // Check if course name already exists
+    CatalogView snapshot = publishedCatalog.load();
+    auto sameName = lower_bound(snapshot->byName.begin(), snapshot->byName.end(), name,
+                                [&snapshot](int i, const string& n) { return snapshot->byCode[i].name < n; });
+    if (sameName != snapshot->byName.end() && snapshot->byCode[*sameName].name == name) {
+        return Status::CourseNameExists;
+    }
+
+    Course course(code, name, creditHours, totalSeats, slots);
+    catalog.insert(course);
+    countCourse(course, 1);
+    publishCatalog();
+    appendCourse(course);
+    journal("COURSE_ADD," + code + "," + to_string(creditHours) + "," + to_string(totalSeats) + ","
+            + formatSchedule(slots) + "," + name);
+    return Status::Ok;
+}
+
+Status CourseRegistrationSystem::deleteCourse(const SessionToken& session, const string& code) {
+    TraceScope trace(*this, TraceOp::DeleteCourse, &session, code);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (catalog.search(code) == nullptr) return Status::CourseNotFound;
+
+    removeCourses({code});
+    return Status::Ok;
+}
+
+Outcome CourseRegistrationSystem::retireDepartment(const SessionToken& session, const string& department) {
+    TraceScope trace(*this, TraceOp::RetireDepartment, &session, department);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (department.empty()) return Status::EmptyDepartment;
+
+    // Inorder traversal yields codes already sorted
+    vector<Course> courseList;
+    catalog.collectCourses(courseList);
+    vector<string> codes;
+    for (const auto& course : courseList) {
+        if (departmentOf(course.getCode()) == department) {
+            codes.emplace_back(course.getCode());
+        }
     }
 
-    if (currentUser->getIsAdmin()) {
-        cout << "Undo is not available for administrators!\n";
-        return;
+    if (codes.empty()) return Outcome(Status::NoMatches, department);
+
+    removeCourses(codes);
+    Outcome retired(Status::Ok, department);
+    retired.count = static_cast<long long>(codes.size());
+    return retired;
+}
+
+// Cascade delete for a set of courses: one pass over the enrollments, the
+// holds and the prerequisite graph, however many courses are removed
+void CourseRegistrationSystem::removeCourses(const vector<string>& sortedCodes) {
+    auto isRemoved = [&sortedCodes](const string& code) {
+        return binary_search(sortedCodes.begin(), sortedCodes.end(), code);
+    };
+    cancelHoldsIf([&isRemoved](const Enrollment& hold) { return isRemoved(hold.courseCode); });
+
+    // Only the departments that own a removed course need their enrollments scanned
+    vector<Enrollment> dropped;
+    string lastDepartment;
+    for (const string& code : sortedCodes) {
+        string department = departmentOf(code);
+        if (department == lastDepartment) continue;
+        lastDepartment = department;
+        ShardedCatalog::Shard* shard = catalog.getShard(department);
+        if (shard != nullptr) {
+            ShardedCatalog::removeEnrollmentsIf(*shard,
+                                                [&isRemoved](const Enrollment& e) { return isRemoved(e.courseCode); },
+                                                [this, shard, &dropped](const Enrollment& e) {
+                                                    Course* course = shard->courses.search(e.courseCode);
+                                                    if (course != nullptr) {
+                                                        countEnrollment(e.username, *course, -1);
+                                                    }
+                                                    dropped.push_back(e);
+                                                });
+        }
+    }
+    prerequisites.removeCoursesIf(isRemoved);
+    for (const string& code : sortedCodes) {
+        Course* course = catalog.search(code);
+        if (course != nullptr) {
+            countCourse(*course, -1);
+        }
+        catalog.deleteCourse(code);
+        journal("COURSE_DEL," + code);
     }
 
-    Enrollment lastEnrollment("", "");
-    if (undoStack.pop(lastEnrollment)) {
-        if (lastEnrollment.username == currentUser->getUsername()) {
-            string enrollKey = lastEnrollment.username + ":" + lastEnrollment.courseCode;
-            if (enrollments.remove(enrollKey, enrollmentComparator)) {
-                Course* course = courses.search(lastEnrollment.courseCode);
-                if (course != nullptr) {
-                    course->unenrollStudent();
-                    cout << "Undo successful! Removed enrollment from " << course->getName() << "\n";
-                    saveData();
-                }
-            }
+    // Drop records, so a course added again under the same code starts empty
+    appendEnrollmentDrops(dropped);
+    publishCatalog();
+    markDirty(TABLE_COURSES | TABLE_PREREQUISITES);
+    saveData();
+}
+
+Outcome CourseRegistrationSystem::processPayment(const SessionToken& session, const string& transactionId, double amount) {
+    TraceScope trace(*this, TraceOp::ProcessPayment, &session, transactionId, amount);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+
+    // Validate inputs
+    if (transactionId.empty()) return Status::EmptyTransactionId;
+    if (amount <= 0) return Status::AmountNotPositive;
+    if (amount > 100000) return Status::AmountTooHigh;
+    if (payments.search(transactionId) != nullptr) return Status::TransactionExists;
+
+    Payment* newPayment = addPayment(Payment(transactionId, currentUser->getUsername(), amount, "Completed"));
+    appendPayment(*newPayment);
+    journal(paymentRecord(*newPayment));
+    return Outcome(Status::Ok, transactionId);
+}
+
+Result<Payment> CourseRegistrationSystem::paymentStatus(const SessionToken& session, const string& transactionId) {
+    TraceScope trace(*this, TraceOp::ViewPaymentStatus, &session, transactionId);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (transactionId.empty()) return Status::EmptyTransactionId;
+
+    Payment* payment = payments.search(transactionId);
+    if (payment == nullptr) return Status::PaymentNotFound;
+    if (!currentUser->getIsAdmin() && payment->username != currentUser->getUsername()) return Status::AccessDenied;
+    return *payment;
+}
+
+Status CourseRegistrationSystem::voidPayment(const SessionToken& session, const string& transactionId) {
+    TraceScope trace(*this, TraceOp::VoidPayment, &session, transactionId);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (currentUser->getIsAdmin()) return Status::AdminNotAllowed;
+
+    Payment* payment = payments.search(transactionId);
+    if (payment == nullptr) return Status::PaymentNotFound;
+    if (payment->username != currentUser->getUsername()) return Status::AccessDenied;
+    if (payment->status != "Completed") return Status::NotVoidable;
+
+    UserAction action(ActionType::VoidPayment, transactionId);
+    applyAction(currentUser->getUsername(), action, false);
+    recordAction(currentUser->getUsername(), action);
+    return Status::Ok;
+}
+
+Result<PaymentHistory> CourseRegistrationSystem::paymentHistory(const SessionToken& session, const string& username) {
+    TraceScope trace(*this, TraceOp::ViewPayments, &session, username);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (!currentUser->getIsAdmin() && currentUser->getUsername() != username) return Status::AccessDenied;
+
+    PaymentHistory history;
+    vector<string>* ids = paymentsByUser.search(username);
+    if (ids == nullptr) return history;
+    history.payments.reserve(ids->size());
+    for (const string& id : *ids) history.payments.push_back(*payments.search(id));
+    history.totals = *paymentTotals.search(username);
+    return history;
+}
+
+// Applies a bank reconciliation file in one pass. Each line is
+// "transactionId,username,amount,status": a known ID gets the bank's status,
+// an unknown one is recorded as a new payment, and repeats within the file
+// resolve to the last line. Lines are held to the same rules as processPayment
+// and rejected ones are reported with their reason. All changes reach the
+// ledger and the journal in a single append each.
+Result<ReconciliationReport> CourseRegistrationSystem::importReconciliation(const SessionToken& session,
+                                                                           const string& filename) {
+    TraceScope trace(*this, TraceOp::ImportReconciliation, &session, filename);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+
+    ifstream bankFile(filename);
+    if (!bankFile.is_open()) return Status::CannotOpenFile;
+
+    auto started = chrono::steady_clock::now();
+    int lines = 0, added = 0, updated = 0, unchanged = 0, mismatched = 0;
+    vector<pair<int, Status>> rejections;
+    string ledger;
+    vector<string> records;
+    string line;
+    int lineNumber = 0;
+    while (getline(bankFile, line)) {
+        lineNumber++;
+        if (line.empty()) continue;
+        lines++;
+        stringstream ss(line);
+        string t, u, amountStr, status;
+        getline(ss, t, ',');
+        getline(ss, u, ',');
+        getline(ss, amountStr, ',');
+        getline(ss, status, ',');
+        double amount = 0;
+        try {
+            amount = stod(amountStr);
+        } catch (...) {
+            rejections.emplace_back(lineNumber, Status::MalformedRecord);
+            continue;
+        }
+        Status invalid = Status::Ok;
+        if (t.empty()) invalid = Status::EmptyTransactionId;
+        else if (u.empty() || (status != "Completed" && status != "Voided")) invalid = Status::MalformedRecord;
+        else if (amount <= 0) invalid = Status::AmountNotPositive;
+        else if (amount > 100000) invalid = Status::AmountTooHigh;
+        if (invalid != Status::Ok) {
+            rejections.emplace_back(lineNumber, invalid);
+            continue;
+        }
+
+        Payment* payment = payments.search(t);
+        if (payment == nullptr && findUser(u) == nullptr) {
+            rejections.emplace_back(lineNumber, Status::UserNotFound);
+            continue;
+        } else if (payment == nullptr) {
+            payment = addPayment(Payment(t, u, amount, status));
+            records.push_back(paymentRecord(*payment));
+            added++;
+        } else if (payment->username != u || payment->amount != amount) {
+            mismatched++; // Left for a person to look at
+            continue;
+        } else if (payment->status != status) {
+            setPaymentStatus(*payment, status);
+            records.push_back(statusRecord(*payment));
+            updated++;
         } else {
-            cout << "No action to undo!\n";
+            unchanged++;
+            continue;
         }
-    } else {
-        cout << "No action to undo!\n";
+        ledger += records.back();
+        ledger += '\n';
     }
+
+    appendLedger(ledger);
+    journal(records);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    int rejected = static_cast<int>(rejections.size());
+    return ReconciliationReport{lines, added, updated, unchanged, mismatched, rejected, std::move(rejections), seconds};
 }
 
-// Admin Functions
+Outcome CourseRegistrationSystem::updateCourse(const SessionToken& session, const string& code, const string& newName,
+                                               int newCreditHours, int newTotalSeats, const string& newTimes) {
+    TraceScope trace(*this, TraceOp::UpdateCourse, &session, code, newName, newCreditHours, newTotalSeats, newTimes);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+
+    Course* course = catalog.search(code);
+    if (course == nullptr) return Status::CourseNotFound;
+
+    // Seats already enrolled or held cannot be taken away
+    expireHolds();
+    int taken = course->getTotalSeats() - course->getAvailableSeats();
+    if (newTotalSeats > 0 && newTotalSeats < taken) {
+        Outcome refused(Status::SeatsBelowTaken, code);
+        refused.limit = taken;
+        return refused;
+    }
+
+    // Times that do not parse are reported back and the current ones kept
+    Outcome updated;
+    uint64_t newSlots = course->getTimeSlots();
+    if (!newTimes.empty() && !parseSchedule(newTimes, newSlots)) {
+        newSlots = course->getTimeSlots();
+        updated.detail = formatSchedule(newSlots);
+    }
+
+    applyCourseUpdate(course, newName.empty() ? course->getName() : newName,
+                      newCreditHours > 0 ? newCreditHours : course->getCreditHours(),
+                      newTotalSeats > 0 ? newTotalSeats : course->getTotalSeats(), newSlots);
+    publishCatalog();
+    markDirty(TABLE_COURSES);
+    saveData();
+    journal("COURSE_UPD," + code + "," + to_string(course->getCreditHours()) + ","
+            + to_string(course->getTotalSeats()) + "," + formatSchedule(course->getTimeSlots()) + ","
+            + course->getName());
+    return updated;
+}
 
-void CourseRegistrationSystem::addCourse(const string& code, const string& name, int creditHours, int totalSeats) {
-    if (currentUser == nullptr || !currentUser->getIsAdmin()) {
-        cout << "Access denied! Admin privileges required.\n";
-        return;
+// Applies new course details and carries the change into seats and running totals
+void CourseRegistrationSystem::applyCourseUpdate(Course* course, const string& name, int creditHours, int totalSeats,
+                                                 uint64_t slots) {
+    int seatDiff = totalSeats - course->getTotalSeats();
+    int creditDiff = creditHours - course->getCreditHours();
+    uint64_t oldSlots = course->getTimeSlots();
+
+    course->setName(name);
+    course->setCreditHours(creditHours);
+    course->setTotalSeats(totalSeats);
+    course->setAvailableSeats(course->getAvailableSeats() + seatDiff);
+    course->setTimeSlots(slots);
+    catalogVersion++;
+    departmentStats.searchOrInsert(departmentOf(course->getCode()))->totalSeats += seatDiff;
+    syncOpenSeats(*course);
+
+    if (creditDiff != 0) {
+        forgetPlans(plansByCourse, course->getCode());
+    }
+
+    // Everyone enrolled in the course carries the new credit hours and meeting times
+    if (creditDiff != 0 || slots != oldSlots) {
+        string_view code = course->getCode();
+        ShardedCatalog::Shard* shard = catalog.getShard(departmentOf(code));
+        for (Node<Enrollment>* current = shard->enrollments.getHead(); current != nullptr; current = current->next) {
+            if (current->data.courseCode == code) {
+                studentLoads.searchOrInsert(current->data.username)->creditHours += creditDiff;
+                bookSlots(current->data.username, oldSlots, -1);
+                bookSlots(current->data.username, slots, 1);
+            }
+        }
     }
+}
 
-    // Validate inputs
-    if (code.empty()) {
-        cout << "Error: Course code cannot be empty!\n";
-        return;
-    }
+Status CourseRegistrationSystem::setHoldDuration(const SessionToken& session, int minutes) {
+    TraceScope trace(*this, TraceOp::SetHoldDuration, &session, minutes);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (minutes <= 0 || minutes > 24 * 60) return Status::InvalidHoldDuration;
 
-    if (name.empty()) {
-        cout << "Error: Course name cannot be empty!\n";
-        return;
-    }
+    holdDurationSeconds = minutes * 60;
+    return Status::Ok;
+}
 
-    if (creditHours <= 0) {
-        cout << "Error: Credit hours must be a positive number!\n";
-        return;
-    }
+// Limits apply to future enrollments and drops; current loads are left as they are
+Status CourseRegistrationSystem::setCreditLimits(const SessionToken& session, int minHours, int maxHours) {
+    TraceScope trace(*this, TraceOp::SetCreditLimits, &session, minHours, maxHours);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (minHours < 0 || maxHours <= 0 || minHours > maxHours) return Status::InvalidCreditLimits;
 
-    if (creditHours > 6) {
-        cout << "Error: Credit hours cannot exceed 6!\n";
-        return;
+    minCreditHours = minHours;
+    maxCreditHours = maxHours;
+    return Status::Ok;
+}
+
+// Students whose roll number starts with the prefix may enroll or hold seats once the
+// window opens; earlier windows are served first when requests have to queue
+Outcome CourseRegistrationSystem::setRegistrationWindow(const SessionToken& session, const string& rollNoPrefix,
+                                                       int opensInMinutes) {
+    TraceScope trace(*this, TraceOp::SetRegistrationWindow, &session, rollNoPrefix, opensInMinutes);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (opensInMinutes < 0 || opensInMinutes > 30 * 24 * 60) return Status::InvalidWindow;
+
+    admission.setWindow(rollNoPrefix, clockSeconds() + opensInMinutes * 60.0);
+    Outcome set(Status::Ok, rollNoPrefix);
+    set.waitSeconds = opensInMinutes * 60.0;
+    return set;
+}
+
+Result<AdmissionReport> CourseRegistrationSystem::admissionMetrics(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::ViewAdmissionMetrics, &session);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+
+    double now = clockSeconds();
+    AdmissionReport report{admission.metrics(), admission.queueDepth(), {}};
+    for (const RegistrationWindow& window : admission.getWindows()) {
+        report.windows.push_back({window.rollPrefix, window.opensAt - now});
     }
+    return report;
+}
 
-    if (totalSeats <= 0) {
-        cout << "Error: Total seats must be a positive number!\n";
-        return;
+// Lottery allocation: students rank courses while the round is open, then one
+// seeded pass assigns the seats and commits them as a single batch
+
+Outcome CourseRegistrationSystem::submitPreferences(const SessionToken& session, const vector<string>& codes) {
+    TraceScope trace(*this, TraceOp::SubmitPreferences, &session);
+    if (trace.isRecording()) trace.args = codes;
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (currentUser->getIsAdmin()) return Status::AdminNotAllowed;
+    if (!preferenceRoundOpen) return Status::NoPreferenceRound;
+
+    if (codes.empty() || codes.size() > static_cast<size_t>(MAX_PREFERENCES)) {
+        Outcome count(Status::PreferenceCount);
+        count.count = static_cast<long long>(codes.size());
+        count.limit = MAX_PREFERENCES;
+        return count;
+    }
+
+    for (size_t i = 0; i < codes.size(); i++) {
+        if (catalog.search(codes[i]) == nullptr) return Outcome(Status::CourseNotFound, codes[i]);
+        if (find(codes.begin(), codes.begin() + i, codes[i]) != codes.begin() + i) {
+            return Outcome(Status::DuplicatePreference, codes[i]);
+        }
     }
 
-    Course* existing = courses.search(code);
+    const string& username = currentUser->getUsername();
+    vector<string>* existing = lotteryPreferences.search(username);
     if (existing != nullptr) {
-        cout << "Error: Course with this code already exists!\n";
-        return;
+        *existing = codes;
+    } else {
+        lotteryPreferences.insert(username, codes);
+        lotteryEntrants.push_back(username);
     }
+    Outcome saved;
+    saved.count = static_cast<long long>(codes.size());
+    return saved;
+}
 
-    // Check if course name already exists
-    vector<Course> courseList;
-    collectCourses(courses.getRoot(), courseList);
-    for (const auto& c : courseList) {
-        if (c.getName() == name) {
-            cout << "Error: Course with this name already exists!\n";
-            return;
-        }
+Outcome CourseRegistrationSystem::openPreferenceRound(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::OpenPreferenceRound, &session);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+
+    if (preferenceRoundOpen) {
+        Outcome open(Status::RoundAlreadyOpen);
+        open.count = static_cast<long long>(lotteryEntrants.size());
+        return open;
     }
 
-    courses.insert(Course(code, name, creditHours, totalSeats));
-    cout << "Course added successfully!\n";
-    saveData();
+    for (const string& username : lotteryEntrants) lotteryPreferences.remove(username);
+    lotteryEntrants.clear();
+    preferenceRoundOpen = true;
+    Outcome opened;
+    opened.limit = MAX_PREFERENCES;
+    return opened;
 }
 
-void CourseRegistrationSystem::deleteCourse(const string& code) {
-    if (currentUser == nullptr || !currentUser->getIsAdmin()) {
-        cout << "Access denied! Admin privileges required.\n";
-        return;
+// Snapshot of everything the allocator looks at. Entrants are sorted so the
+// input does not depend on submission order, only on what was submitted.
+LotteryInput CourseRegistrationSystem::buildLotteryInput(uint64_t seed) {
+    LotteryInput input;
+    input.seed = seed;
+    input.maxCreditHours = maxCreditHours;
+
+    vector<Course> courseList;
+    catalog.collectCourses(courseList);
+    HashTable<int> courseAt;
+    for (const Course& course : courseList) {
+        courseAt.insert(string(course.getCode()), static_cast<int>(input.courses.size()));
+        input.courses.push_back({string(course.getCode()), course.getAvailableSeats(), course.getCreditHours(),
+                                 course.getTimeSlots(), {}});
+    }
+    for (LotteryCourse& course : input.courses) {
+        for (const string& prereq : prerequisites.getPrerequisites(course.code)) {
+            int* at = courseAt.search(prereq);
+            if (at != nullptr) course.prerequisites.push_back(*at);
+        }
     }
 
-    Course* course = courses.search(code);
-    if (course == nullptr) {
-        cout << "Course not found!\n";
-        return;
+    vector<string> entrants = lotteryEntrants;
+    sort(entrants.begin(), entrants.end());
+    HashTable<int> studentAt;
+    for (const string& username : entrants) {
+        if (findUser(username) == nullptr) continue; // Deleted since submitting
+        LotteryStudent student{username, creditLoad(username), 0, {}, {}, {}};
+        StudentSchedule* schedule = schedules.search(username);
+        if (schedule != nullptr) student.busySlots = schedule->busySlots;
+        vector<string_view>* completed = completedByStudent.search(username);
+        if (completed != nullptr) {
+            for (string_view code : *completed) {
+                int* at = courseAt.search(string(code));
+                if (at != nullptr) student.completed.push_back(*at);
+            }
+        }
+        for (const string& code : *lotteryPreferences.search(username)) {
+            int* at = courseAt.search(code);
+            if (at != nullptr) student.preferences.push_back(*at);
+        }
+        studentAt.insert(username, static_cast<int>(input.students.size()));
+        input.students.push_back(std::move(student));
     }
 
-    // Remove all enrollments for this course
-    Node<Enrollment>* current = enrollments.getHead();
-    vector<string> toRemove;
-    while (current != nullptr) {
-        if (current->data.courseCode == code) {
-            toRemove.push_back(current->data.username + ":" + code);
+    catalog.forEachEnrollment([&](const Enrollment& e) {
+        int* student = studentAt.search(e.username);
+        int* course = courseAt.search(e.courseCode);
+        if (student != nullptr && course != nullptr) input.students[*student].taken.push_back(*course);
+    });
+    return input;
+}
+
+Result<LotteryReport> CourseRegistrationSystem::runSeatLottery(const SessionToken& session, uint64_t seed) {
+    TraceScope trace(*this, TraceOp::RunSeatLottery, &session, seed);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (!preferenceRoundOpen) return Status::NoPreferenceRound;
+
+    expireHolds(); // Lapsed holds go back into the pool
+    LotteryInput input = buildLotteryInput(seed);
+    auto started = chrono::steady_clock::now();
+    LotteryResult result = allocateSeats(input);
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - started).count();
+
+    // Commit as one batch: the enrollments file is rewritten once and the
+    // journal gets every record in a single append
+    vector<Course*> courses;
+    for (const LotteryCourse& course : input.courses) courses.push_back(catalog.search(course.code));
+    // An assignment the course can no longer seat is left out and audited as refused
+    vector<string> records;
+    records.reserve(result.assignments.size());
+    vector<LotteryAssignment> refused;
+    markDirty(TABLE_ENROLLMENTS);
+    for (const LotteryAssignment& assignment : result.assignments) {
+        const string& username = input.students[assignment.student].username;
+        Course* course = courses[assignment.course];
+        if (course == nullptr || !course->enrollStudent()) {
+            refused.push_back(assignment);
+            continue;
         }
-        current = current->next;
+        catalog.addEnrollment(Enrollment(username, string(course->getCode())));
+        countEnrollment(username, *course, 1);
+        records.push_back("ENROLL," + username + "," + string(course->getCode()));
     }
+    saveData();
+    journal(records);
+    writeLotteryAudit(input, result, refused);
+
+    preferenceRoundOpen = false;
+    int requested = 0;
+    for (const LotteryStudent& student : input.students) requested += static_cast<int>(student.preferences.size());
+    return LotteryReport{seed, records.size(), refused.size(), requested, input.students.size(), elapsed,
+                         result.digest};
+}
 
-    for (const string& key : toRemove) {
-        enrollments.remove(key, enrollmentComparator);
+// The audit records the full allocator input, so a replay needs nothing from
+// the live system and must reproduce the digest exactly. The header counts
+// the seats actually committed; refused assignments follow as R lines.
+void CourseRegistrationSystem::writeLotteryAudit(const LotteryInput& input, const LotteryResult& result,
+                                                 const vector<LotteryAssignment>& refused) {
+    ofstream audit("lottery_audit.txt");
+    if (!audit.is_open()) return;
+    auto joinIndices = [&audit](const vector<int>& list) {
+        for (size_t i = 0; i < list.size(); i++) audit << (i ? ";" : "") << list[i];
+    };
+    audit << "LOTTERY2," << input.seed << "," << input.maxCreditHours << "," << result.digest << ","
+          << result.assignments.size() - refused.size() << "\n";
+    for (const LotteryCourse& course : input.courses) {
+        audit << "C," << course.code << "," << course.seats << "," << course.creditHours << ","
+              << course.timeSlots << ",";
+        joinIndices(course.prerequisites);
+        audit << "\n";
+    }
+    for (const LotteryStudent& student : input.students) {
+        audit << "S," << student.username << "," << student.creditHours << "," << student.busySlots << ",";
+        joinIndices(student.taken);
+        audit << ",";
+        joinIndices(student.completed);
+        audit << ",";
+        joinIndices(student.preferences);
+        audit << "\n";
+    }
+    for (const LotteryAssignment& assignment : refused) {
+        audit << "R," << assignment.student << "," << assignment.course << "\n";
     }
+}
 
-    if (courses.deleteCourse(code)) {
-        cout << "Course deleted successfully!\n";
-        saveData();
-    } else {
-        cout << "Failed to delete course!\n";
+bool CourseRegistrationSystem::readLotteryAudit(LotteryInput& input, uint64_t& digest) {
+    ifstream audit("lottery_audit.txt");
+    if (!audit.is_open()) return false;
+    auto splitIndices = [](const string& text) {
+        vector<int> list;
+        stringstream ss(text);
+        string item;
+        while (getline(ss, item, ';')) list.push_back(stoi(item));
+        return list;
+    };
+
+    try {
+        string line, tag, field;
+        if (!getline(audit, line)) return false;
+        stringstream header(line);
+        getline(header, tag, ',');
+        // Audits from before terms (plain LOTTERY) have no completed list;
+        // prerequisites then counted the courses taken
+        bool hasCompleted = tag == "LOTTERY2";
+        if (!hasCompleted && tag != "LOTTERY") return false;
+        getline(header, field, ',');
+        input.seed = stoull(field);
+        getline(header, field, ',');
+        input.maxCreditHours = stoi(field);
+        getline(header, field, ',');
+        digest = stoull(field);
+
+        while (getline(audit, line)) {
+            stringstream ss(line);
+            getline(ss, tag, ',');
+            if (tag == "C") {
+                LotteryCourse course;
+                getline(ss, course.code, ',');
+                getline(ss, field, ',');
+                course.seats = stoi(field);
+                getline(ss, field, ',');
+                course.creditHours = stoi(field);
+                getline(ss, field, ',');
+                course.timeSlots = stoull(field);
+                getline(ss, field);
+                course.prerequisites = splitIndices(field);
+                input.courses.push_back(std::move(course));
+            } else if (tag == "S") {
+                LotteryStudent student;
+                getline(ss, student.username, ',');
+                getline(ss, field, ',');
+                student.creditHours = stoi(field);
+                getline(ss, field, ',');
+                student.busySlots = stoull(field);
+                getline(ss, field, ',');
+                student.taken = splitIndices(field);
+                if (hasCompleted) {
+                    getline(ss, field, ',');
+                    student.completed = splitIndices(field);
+                } else {
+                    student.completed = student.taken;
+                }
+                getline(ss, field);
+                student.preferences = splitIndices(field);
+                input.students.push_back(std::move(student));
+            }
+        }
+    } catch (...) {
+        return false;
     }
+    return true;
 }
 
-void CourseRegistrationSystem::processPayment(const string& transactionId, double amount) {
-    if (currentUser == nullptr) {
-        cout << "Please login first!\n";
-        return;
-    }
+Result<LotteryCheck> CourseRegistrationSystem::verifyLotteryAudit(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::VerifyLotteryAudit, &session);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
 
-    // Validate inputs
-    if (transactionId.empty()) {
-        cout << "Error: Transaction ID cannot be empty!\n";
-        return;
-    }
+    LotteryInput input;
+    uint64_t recorded = 0;
+    if (!readLotteryAudit(input, recorded)) return Status::NoAudit;
 
-    if (amount <= 0) {
-        cout << "Error: Amount must be a positive number!\n";
-        return;
-    }
+    LotteryResult replay = allocateSeats(input);
+    return LotteryCheck{input.seed, input.students.size(), replay.assignments.size(), recorded, replay.digest};
+}
 
-    if (amount > 100000) {
-        cout << "Error: Amount exceeds maximum limit!\n";
-        return;
-    }
+bool CourseRegistrationSystem::hasCompleted(const string& username, const string& code) {
+    vector<string_view>* completed = completedByStudent.search(username);
+    return completed != nullptr && binary_search(completed->begin(), completed->end(), string_view(code));
+}
 
-    Payment* existing = payments.search(transactionId);
-    if (existing != nullptr) {
-        cout << "Error: Transaction ID already exists!\n";
-        return;
+vector<uint64_t> CourseRegistrationSystem::completedCourses(const string& username) {
+    vector<uint64_t> completed;
+    vector<string_view>* codes = completedByStudent.search(username);
+    if (codes == nullptr) return completed;
+    for (string_view code : *codes) {
+        int id = courseIndex.idOf(string(code));
+        if (id >= 0) CourseIndex::mark(completed, id, true);
     }
+    return completed;
+}
 
-    Payment newPayment(transactionId, currentUser->getUsername(), amount, "Completed");
-    payments.insert(transactionId, newPayment);
-    cout << "Payment processed successfully! Transaction ID: " << transactionId << "\n";
-    saveData();
+// Adds a sealed term to the history and its completions to the per-student
+// sets. Only accounts that existed in that term are credited, so the users
+// must be loaded first.
+void CourseRegistrationSystem::openArchive(const string& term) {
+    int index = static_cast<int>(archives.size());
+    archives.push_back(make_unique<TermArchive>(term));
+    archives.back()->forEachCompletion([this, index](string_view username, string_view code) {
+        User* user = findUser(string(username));
+        if (user == nullptr || user->getFirstArchive() > index) return;
+        completedByStudent.searchOrInsert(string(username))->push_back(code);
+    });
+    completedByStudent.forEach([](vector<string_view>& codes) {
+        sort(codes.begin(), codes.end());
+        codes.erase(unique(codes.begin(), codes.end()), codes.end());
+    });
 }
 
-void CourseRegistrationSystem::viewPaymentStatus(const string& transactionId) {
-    if (currentUser == nullptr) {
-        cout << "Please login first!\n";
-        return;
+// Writes the active term's archive; credit hours are frozen as they stand now
+bool CourseRegistrationSystem::sealTerm(const EnrollmentGroups& groups) {
+    vector<int> creditHours;
+    creditHours.reserve(groups.courseCodes.size());
+    for (const string& code : groups.courseCodes) {
+        Course* course = catalog.search(code);
+        creditHours.push_back(course != nullptr ? course->getCreditHours() : 0);
     }
+    return TermArchive::write(termArchivePath(currentTerm), currentTerm, groups, creditHours);
+}
 
-    if (transactionId.empty()) {
-        cout << "Error: Transaction ID cannot be empty!\n";
-        return;
-    }
+// Opens the next term once the current one is sealed: its archive joins the
+// history and everything that belonged to it (enrollments, holds, undo
+// history, the preference round) is emptied. Courses and accounts carry over.
+void CourseRegistrationSystem::startTerm(const string& term) {
+    cancelHoldsIf([](const Enrollment&) { return true; });
+
+    catalog.clearEnrollments([this](const Enrollment& e) {
+        Course* course = catalog.search(e.courseCode);
+        if (course == nullptr) return;
+        course->unenrollStudent();
+        countEnrollment(e.username, *course, -1);
+    });
+    undoLogs.forEach([](UndoLog& log) {
+        log.undo.clear();
+        log.redo.clear();
+    });
+    for (const string& username : lotteryEntrants) lotteryPreferences.remove(username);
+    lotteryEntrants.clear();
+    preferenceRoundOpen = false;
 
-    Payment* payment = payments.search(transactionId);
-    if (payment != nullptr) {
-        if (currentUser->getIsAdmin() || payment->username == currentUser->getUsername()) {
-            cout << "\n--- Payment Details ---\n";
-            cout << "Transaction ID: " << payment->transactionId << "\n";
-            cout << "User: " << payment->username << "\n";
-            cout << "Amount: $" << payment->amount << "\n";
-            cout << "Status: " << payment->status << "\n";
-        } else {
-            cout << "Access denied! You can only view your own payments.\n";
-        }
-    } else {
-        cout << "Payment record not found!\n";
-    }
+    openArchive(currentTerm);
+    currentTerm = term;
+    markDirty(TABLE_ENROLLMENTS);
 }
 
-void CourseRegistrationSystem::updateCourse(const string& code) {
-    if (currentUser == nullptr || !currentUser->getIsAdmin()) {
-        cout << "Access denied! Admin privileges required.\n";
-        return;
-    }
+void CourseRegistrationSystem::saveTerms() {
+    if (replica) return;
+    ofstream termsFile(TERMS_FILE);
+    for (const auto& archive : archives) termsFile << archive->term() << "\n";
+    termsFile << currentTerm << "\n";
+}
 
-    Course* course = courses.search(code);
-    if (course == nullptr) {
-        cout << "Course not found!\n";
-        return;
-    }
+Outcome CourseRegistrationSystem::closeTerm(const SessionToken& session, const string& nextTerm) {
+    TraceScope trace(*this, TraceOp::CloseTerm, &session, nextTerm);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (!isValidTermName(nextTerm)) return Status::InvalidTermName;
+    if (nextTerm == currentTerm) return Outcome(Status::TermExists, nextTerm);
+    for (const auto& archive : archives) {
+        if (archive->term() == nextTerm) return Outcome(Status::TermExists, nextTerm);
+    }
+
+    expireHolds();
+    EnrollmentGroups groups = groupEnrollments([this](auto visit) { catalog.forEachEnrollment(visit); });
+    if (!sealTerm(groups)) return Outcome(Status::CannotOpenFile, termArchivePath(currentTerm));
+
+    Outcome closed(Status::Ok, currentTerm);
+    closed.detail = nextTerm;
+    for (const vector<uint32_t>& ids : groups.courseIds) closed.count += static_cast<long long>(ids.size());
+
+    // The archive is on disk before terms.txt names it, and terms.txt is
+    // rewritten before the live enrollments are, so a crash in between
+    // leaves either the old term intact or the new one complete
+    startTerm(nextTerm);
+    saveTerms();
+    saveData();
+    journal("TERM_CLOSE," + nextTerm);
+    return closed;
+}
 
-    cout << "\n--- Update Course ---\n";
-    cout << "Current Name: " << course->getName() << "\n";
-    cout << "Enter new name (or press enter to keep): ";
-    cin.ignore();
-    string newName;
-    getline(cin, newName);
-    if (!newName.empty()) {
-        course->setName(newName);
-    }
+Result<TermReport> CourseRegistrationSystem::termArchives(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::ViewTermArchives, &session);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
 
-    cout << "Current Credit Hours: " << course->getCreditHours() << "\n";
-    cout << "Enter new credit hours (or 0 to keep): ";
-    int newCreditHours;
-    cin >> newCreditHours;
-    if (newCreditHours > 0) {
-        course->setCreditHours(newCreditHours);
+    TermReport report{currentTerm, {}};
+    for (const auto& archive : archives) {
+        report.archived.push_back({archive->term(), archive->isValid(), archive->studentCount(),
+                                   archive->enrollmentCount(), archive->byteSize(), archive->isMapped()});
     }
+    return report;
+}
+
+Result<Transcript> CourseRegistrationSystem::transcript(const SessionToken& session, const string& username) {
+    TraceScope trace(*this, TraceOp::ViewTranscript, &session, username);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr) return Status::NotLoggedIn;
+    if (!currentUser->getIsAdmin() && currentUser->getUsername() != username) return Status::AccessDenied;
+
+    User* student = findUser(username);
+    if (student == nullptr || student->getIsAdmin()) return Status::StudentNotFound;
+
+    Transcript result{{}, 0};
+    for (size_t i = student->getFirstArchive(); i < archives.size(); i++) {
+        const auto& archive = archives[i];
+        TranscriptTerm term{archive->term(), {}, 0};
+        archive->forEachCourse(username, [&term](string_view code, int creditHours) {
+            term.courses.emplace_back(string(code), creditHours);
+            term.creditHours += creditHours;
+        });
+        if (term.courses.empty()) continue;
+        result.creditHours += term.creditHours;
+        result.terms.push_back(std::move(term));
+    }
+    return result;
+}
 
-    cout << "Current Total Seats: " << course->getTotalSeats() << "\n";
-    cout << "Enter new total seats (or 0 to keep): ";
-    int newTotalSeats;
-    cin >> newTotalSeats;
-    if (newTotalSeats > 0) {
-        int diff = newTotalSeats - course->getTotalSeats();
-        course->setTotalSeats(newTotalSeats);
-        course->setAvailableSeats(course->getAvailableSeats() + diff);
+// Footprint of every major structure, walked on demand. Indexes over records
+// counted elsewhere (lookup tables, per-user lists) are charged as overhead of
+// the records they index, so "records" never counts anything twice.
+Result<MemoryReport> CourseRegistrationSystem::memoryReport(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::ViewMemoryReport, &session);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    refreshReplica();
+    expireHolds();
+
+    MemoryReport report;
+    vector<pair<string, MemoryStats>>& rows = report.rows;
+
+    MemoryStats userStats = users.memoryUsage();
+    userStats.addIndex(userIndex.memoryUsage());
+    rows.emplace_back("Users", userStats);
+
+    rows.emplace_back("Courses", catalog.courseMemory());
+    rows.emplace_back("Enrollments", catalog.enrollmentMemory());
+
+    MemoryStats paymentMemory = payments.memoryUsage();
+    paymentMemory.addIndex(paymentsByUser.memoryUsage());
+    paymentMemory.addIndex(paymentTotals.memoryUsage());
+    rows.emplace_back("Payments", paymentMemory);
+
+    rows.emplace_back("Prerequisite edges", prerequisites.memoryUsage());
+    rows.emplace_back("Course index", courseIndex.memoryUsage());
+
+    MemoryStats holdMemory = holdTimers.memoryUsage();
+    holdMemory.addIndex(seatHolds.memoryUsage());
+    rows.emplace_back("Seat holds", holdMemory);
+
+    rows.emplace_back("Undo logs", undoLogs.memoryUsage());
+    rows.emplace_back("Sessions", sessions.memoryUsage());
+
+    MemoryStats totals = departmentStats.memoryUsage();
+    totals += studentLoads.memoryUsage();
+    totals += schedules.memoryUsage();
+    totals += takenCourses.memoryUsage();
+    rows.emplace_back("Running totals", totals);
+
+    MemoryStats planMemory = degreePlans.memoryUsage();
+    planMemory.addIndex(plansByCourse.memoryUsage());
+    planMemory.addIndex(plansByStudent.memoryUsage());
+    rows.emplace_back("Degree plans", planMemory);
+
+    MemoryStats snapshots;
+    CatalogView catalogView = publishedCatalog.load();
+    if (catalogView) {
+        heapUsage(catalogView->byCode, snapshots);
+        snapshots.nodes += catalogView->byCode.size();
+        MemoryStats byName;
+        heapUsage(catalogView->byName, byName);
+        snapshots.addIndex(byName);
+    }
+    snapshots.addIndex(seatCounters.memoryUsage()); // Shared by every catalog snapshot
+    if (enrollmentSnapshot) {
+        heapUsage(*enrollmentSnapshot, snapshots);
+        snapshots.nodes += enrollmentSnapshot->size();
+    }
+    rows.emplace_back("Snapshots", snapshots);
+
+    rows.emplace_back("Admission control", admission.memoryUsage());
+
+    MemoryStats lottery = lotteryPreferences.memoryUsage();
+    MemoryStats entrants;
+    heapUsage(lotteryEntrants, entrants);
+    lottery.addIndex(entrants);
+    rows.emplace_back("Lottery preferences", lottery);
+
+    // Mapped archives sit in the page cache; only files read in are on the heap
+    MemoryStats archiveMemory;
+    for (const auto& archive : archives) {
+        archiveMemory.nodes += archive->enrollmentCount();
+        archiveMemory.overheadBytes += sizeof(TermArchive) + ALLOCATION_HEADER;
+        archiveMemory.allocations++;
+        if (!archive->isMapped() && archive->byteSize() > 0) {
+            archiveMemory.payloadBytes += archive->byteSize();
+            archiveMemory.overheadBytes += ALLOCATION_HEADER;
+            archiveMemory.allocations++;
+        }
     }
+    archiveMemory.addIndex(completedByStudent.memoryUsage());
+    rows.emplace_back("Term archives", archiveMemory);
 
-    cout << "Course updated successfully!\n";
-    saveData();
+    report.heapTracked = heapTrackingEnabled();
+    report.heap = heapCounters();
+    return report;
 }
 
-void CourseRegistrationSystem::viewAllUsers() {
-    if (currentUser == nullptr || !currentUser->getIsAdmin()) {
-        cout << "Access denied! Admin privileges required.\n";
-        return;
-    }
+Result<vector<UserView>> CourseRegistrationSystem::allUsers(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::ViewAllUsers, &session);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
 
-    cout << "\n--- All Users ---\n";
-    Node<User>* current = users.getHead();
-    while (current != nullptr) {
-        cout << "Username: " << current->data.getUsername()
-             << " | Name: " << current->data.getFullName()
-             << " | Roll No: " << current->data.getRollNo()
-             << " | Type: " << (current->data.getIsAdmin() ? "Admin" : "Student") << "\n";
-        current = current->next;
+    vector<UserView> views;
+    for (Node<User>* current = users.getHead(); current != nullptr; current = current->next) {
+        views.push_back(viewOf(current->data));
     }
+    return views;
 }
 
-void CourseRegistrationSystem::deleteUser(const string& username) {
-    if (currentUser == nullptr || !currentUser->getIsAdmin()) {
-        cout << "Access denied! Admin privileges required.\n";
-        return;
-    }
+Status CourseRegistrationSystem::deleteUser(const SessionToken& session, const string& username) {
+    TraceScope trace(*this, TraceOp::DeleteUser, &session, username);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (username == currentUser->getUsername()) return Status::CannotDeleteSelf;
+    if (findUser(username) == nullptr) return Status::UserNotFound;
 
-    if (username == currentUser->getUsername()) {
-        cout << "Cannot delete your own account!\n";
-        return;
-    }
+    removeStudents({username});
+    return Status::Ok;
+}
 
-    User* user = users.search(username, userComparator);
-    if (user == nullptr) {
-        cout << "User not found!\n";
-        return;
-    }
+Outcome CourseRegistrationSystem::removeCohort(const SessionToken& session, const string& rollNoPrefix) {
+    TraceScope trace(*this, TraceOp::RemoveCohort, &session, rollNoPrefix);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (rollNoPrefix.empty()) return Status::EmptyRollNoPrefix;
 
-    // Remove all enrollments for this user
-    Node<Enrollment>* current = enrollments.getHead();
-    vector<string> toRemove;
+    vector<string> usernames;
+    Node<User>* current = users.getHead();
     while (current != nullptr) {
-        if (current->data.username == username) {
-            toRemove.push_back(username + ":" + current->data.courseCode);
-            // Return seats
-            Course* course = courses.search(current->data.courseCode);
-            if (course != nullptr) {
-                course->unenrollStudent();
-            }
+        const User& user = current->data;
+        if (!user.getIsAdmin() && user.getRollNo().compare(0, rollNoPrefix.length(), rollNoPrefix) == 0) {
+            usernames.push_back(user.getUsername());
         }
         current = current->next;
     }
 
-    for (const string& key : toRemove) {
-        enrollments.remove(key, enrollmentComparator);
-    }
+    if (usernames.empty()) return Outcome(Status::NoMatches, rollNoPrefix);
 
-    if (users.remove(username, userComparator)) {
-        cout << "User deleted successfully!\n";
-        saveData();
-    } else {
-        cout << "Failed to delete user!\n";
-    }
+    sort(usernames.begin(), usernames.end());
+    removeStudents(usernames);
+    Outcome removed(Status::Ok, rollNoPrefix);
+    removed.count = static_cast<long long>(usernames.size());
+    return removed;
 }
 
-void CourseRegistrationSystem::viewCourseEnrollments(const string& code) {
-    if (currentUser == nullptr || !currentUser->getIsAdmin()) {
-        cout << "Access denied! Admin privileges required.\n";
-        return;
-    }
-
-    Course* course = courses.search(code);
-    if (course == nullptr) {
-        cout << "Course not found!\n";
-        return;
-    }
-
-    cout << "\n--- Enrollments for " << course->getName() << " ---\n";
-    bool hasEnrollments = false;
-    Node<Enrollment>* current = enrollments.getHead();
-    while (current != nullptr) {
-        if (current->data.courseCode == code) {
-            User* user = users.search(current->data.username, userComparator);
-            if (user != nullptr) {
-                cout << "Username: " << user->getUsername()
-                     << " | Name: " << user->getFullName()
-                     << " | Roll No: " << user->getRollNo() << "\n";
-                hasEnrollments = true;
-            }
+// Cascade delete for a set of users: their enrollments are unlinked and their
+// seats returned in one pass over the enrollment list, their held seats in
+// one pass over the holds, and their payments, preferences, admission state
+// and completed-course sets dropped by key
+void CourseRegistrationSystem::removeStudents(const vector<string>& sortedUsernames) {
+    auto isRemoved = [&sortedUsernames](const string& username) {
+        return binary_search(sortedUsernames.begin(), sortedUsernames.end(), username);
+    };
+    cancelHoldsIf([&isRemoved](const Enrollment& hold) { return isRemoved(hold.username); });
+
+    // Shards are unlinked in parallel; the shared running totals are settled afterwards on this thread
+    vector<vector<pair<string, Course*>>> dropped(catalog.shardCount());
+    forEachShardInParallel([&isRemoved, &dropped](ShardedCatalog::Shard& shard, int i) {
+        ShardedCatalog::removeEnrollmentsIf(shard, [&isRemoved](const Enrollment& e) { return isRemoved(e.username); },
+                                            [&shard, &dropped, i](const Enrollment& e) {
+                                                Course* course = shard.courses.search(e.courseCode);
+                                                if (course != nullptr) {
+                                                    course->unenrollStudent();
+                                                    dropped[i].emplace_back(e.username, course);
+                                                }
+                                            });
+    });
+    vector<Enrollment> records;
+    for (const auto& part : dropped) {
+        for (const auto& [username, course] : part) {
+            countEnrollment(username, *course, -1);
+            records.emplace_back(username, string(course->getCode()));
         }
-        current = current->next;
     }
-    if (!hasEnrollments) {
-        cout << "No enrollments yet.\n";
+    appendEnrollmentDrops(records);
+    users.removeIf([&isRemoved](const User& u) { return isRemoved(u.getUsername()); },
+                   [this](const User& u) { userIndex.remove(u.getUsername()); });
+    lotteryEntrants.erase(remove_if(lotteryEntrants.begin(), lotteryEntrants.end(), isRemoved),
+                          lotteryEntrants.end());
+    // Everything keyed by username goes, so a later account with the same name inherits none of it
+    string purged;
+    for (const string& username : sortedUsernames) {
+        undoLogs.remove(username);
+        forgetPlans(plansByStudent, username);
+        studentLoads.remove(username);
+        schedules.remove(username);
+        takenCourses.remove(username);
+        completedByStudent.remove(username);
+        lotteryPreferences.remove(username);
+        admission.forget(username);
+        if (paymentsByUser.search(username) != nullptr) {
+            forgetPayments(username);
+            purged += "PAY_PURGE," + username + "\n";
+        }
+        journal("USER_DEL," + username);
     }
+    appendLedger(purged);
+    sessions.closeIf(isRemoved);
+
+    markDirty(TABLE_USERS);
+    saveData();
 }
 
-void CourseRegistrationSystem::viewAllEnrollments() {
-    if (currentUser == nullptr || !currentUser->getIsAdmin()) {
-        cout << "Access denied! Admin privileges required.\n";
-        return;
-    }
+Result<CourseRoster> CourseRegistrationSystem::courseEnrollments(const SessionToken& session, const string& code) {
+    TraceScope trace(*this, TraceOp::ViewCourseEnrollments, &session, code);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+
+    Course* course = catalog.search(code);
+    if (course == nullptr) return Status::CourseNotFound;
 
-    cout << "\n--- All Enrollments ---\n";
-    Node<Enrollment>* current = enrollments.getHead();
-    bool hasEnrollments = false;
+    CourseRoster roster{course->getName(), {}};
+    ShardedCatalog::Shard* shard = catalog.getShard(departmentOf(code));
+    Node<Enrollment>* current = shard ? shard->enrollments.getHead() : nullptr;
     while (current != nullptr) {
-        User* user = users.search(current->data.username, userComparator);
-        Course* course = courses.search(current->data.courseCode);
-        if (user != nullptr && course != nullptr) {
-            cout << "Student: " << user->getFullName()
-                 << " | Course: " << course->getName()
-                 << " (" << course->getCode() << ")\n";
-            hasEnrollments = true;
+        if (current->data.courseCode == code) {
+            User* user = findUser(current->data.username);
+            if (user != nullptr) roster.students.push_back(viewOf(*user));
         }
         current = current->next;
     }
-    if (!hasEnrollments) {
-        cout << "No enrollments yet.\n";
-    }
+    return roster;
 }
 
-void CourseRegistrationSystem::addPrerequisite(const string& course, const string& prereq) {
-    if (currentUser == nullptr || !currentUser->getIsAdmin()) {
-        cout << "Access denied! Admin privileges required.\n";
-        return;
-    }
+// The pinned snapshot itself: the caller iterates it without copying and it
+// stays valid however the live data moves on
+Result<EnrollmentSnapshot> CourseRegistrationSystem::allEnrollments(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::ViewAllEnrollments, &session);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    return pinEnrollmentSnapshot();
+}
 
-    // Validate inputs
-    if (course.empty()) {
-        cout << "Error: Course code cannot be empty!\n";
-        return;
+// Returns the report snapshot for the current data version, building it in one
+// pass (hash lookups for users, the owning shard for courses) only when
+// something has changed since the last one was pinned
+EnrollmentSnapshot CourseRegistrationSystem::pinEnrollmentSnapshot() {
+    if (enrollmentSnapshot && snapshotVersion == dataVersion) {
+        return enrollmentSnapshot;
+    }
+
+    // Each shard is scanned on its own task; concatenating in shard order keeps the serial order
+    vector<vector<EnrollmentRow>> parts(catalog.shardCount());
+    forEachShardInParallel([this, &parts](ShardedCatalog::Shard& shard, int i) {
+        for (Node<Enrollment>* current = shard.enrollments.getHead(); current != nullptr; current = current->next) {
+            User* user = findUser(current->data.username);
+            Course* course = shard.courses.search(current->data.courseCode);
+            if (user != nullptr && course != nullptr) {
+                parts[i].push_back({user->getFullName(), course->getName(), string(course->getCode())});
+            }
+        }
+    });
+    auto rows = make_shared<vector<EnrollmentRow>>();
+    for (auto& part : parts) {
+        rows->insert(rows->end(), make_move_iterator(part.begin()), make_move_iterator(part.end()));
     }
 
-    if (prereq.empty()) {
-        cout << "Error: Prerequisite code cannot be empty!\n";
-        return;
-    }
+    enrollmentSnapshot = rows;
+    snapshotVersion = dataVersion;
+    return enrollmentSnapshot;
+}
 
-    // Check if course exists
-    if (courses.search(course) == nullptr) {
-        cout << "Error: Course '" << course << "' does not exist!\n";
-        return;
+// Seat counts are kept up to date on every change; this is the repair for data
+// edited by hand, and the same pass load uses to rebuild them
+Outcome CourseRegistrationSystem::recountSeats(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::RecountSeats, &session);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+
+    expireHolds();
+    Outcome recounted(Status::Ok);
+    recounted.count = rebuildSeatCounts();
+    if (recounted.count > 0) {
+        markDirty(TABLE_COURSES);
+        saveData();
     }
+    return recounted;
+}
 
-    // Check if prerequisite course exists
-    if (courses.search(prereq) == nullptr) {
-        cout << "Error: Prerequisite course '" << prereq << "' does not exist!\n";
-        return;
-    }
+// Formats the pinned report snapshot in chunks on the pool and writes them in
+// order, so the file matches a serial export row for row
+Outcome CourseRegistrationSystem::exportEnrollments(const SessionToken& session, const string& filename) {
+    TraceScope trace(*this, TraceOp::ExportEnrollments, &session, filename);
+    refreshReplica();
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file.is_open()) return Outcome(Status::CannotOpenFile, filename);
+
+    EnrollmentSnapshot snapshot = pinEnrollmentSnapshot();
+    const size_t CHUNK_ROWS = 4096;
+    int chunks = static_cast<int>((snapshot->size() + CHUNK_ROWS - 1) / CHUNK_ROWS);
+    vector<string> text(chunks);
+    workPool().run(chunks, [&snapshot, &text, CHUNK_ROWS](int chunk) {
+        string& out = text[chunk];
+        size_t end = min(snapshot->size(), (chunk + 1) * CHUNK_ROWS);
+        for (size_t i = chunk * CHUNK_ROWS; i < end; i++) {
+            const EnrollmentRow& row = (*snapshot)[i];
+            appendCsvField(out, row.fullName);
+            out += ',';
+            appendCsvField(out, row.courseCode);
+            out += ',';
+            appendCsvField(out, row.courseName);
+            out += '\n';
+        }
+    });
+    file << "Student,Course Code,Course Name\n";
+    for (const string& part : text) file.write(part.data(), static_cast<streamsize>(part.size()));
+    file.close();
+    if (!file) return Outcome(Status::CannotOpenFile, filename);
+
+    Outcome exported(Status::Ok, filename);
+    exported.count = static_cast<long long>(snapshot->size());
+    return exported;
+}
 
-    // Check for self-reference
-    if (course == prereq) {
-        cout << "Error: A course cannot be its own prerequisite!\n";
-        return;
-    }
+Status CourseRegistrationSystem::addPrerequisite(const SessionToken& session, const string& course, const string& prereq) {
+    TraceScope trace(*this, TraceOp::AddPrerequisite, &session, course, prereq);
+    if (rejectOnReplica()) return Status::ReadOnlyReplica;
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
 
-    // Check for duplicate prerequisite
-    if (prerequisites.hasPrerequisite(course, prereq)) {
-        cout << "Error: This prerequisite already exists for the course!\n";
-        return;
-    }
+    // Validate inputs
+    if (course.empty()) return Status::EmptyCourseCode;
+    if (prereq.empty()) return Status::EmptyPrerequisite;
+    if (catalog.search(course) == nullptr) return Status::CourseNotFound;
+    if (catalog.search(prereq) == nullptr) return Status::PrerequisiteNotFound;
+    if (course == prereq) return Status::SelfPrerequisite;
+    if (prerequisites.hasPrerequisite(course, prereq)) return Status::PrerequisiteExists;
 
     // Check for circular dependency (if prereq requires course)
-    if (prerequisites.hasPrerequisite(prereq, course)) {
-        cout << "Error: Circular dependency detected! '" << prereq << "' already requires '" << course << "'.\n";
-        return;
-    }
+    if (prerequisites.hasPrerequisite(prereq, course)) return Status::CircularPrerequisite;
 
-    if (prerequisites.addPrerequisite(course, prereq)) {
-        cout << "Prerequisite added successfully!\n";
-        saveData();
-    } else {
-        cout << "Failed to add prerequisite!\n";
-    }
+    if (!linkPrerequisite(course, prereq)) return Status::PrerequisiteExists;
+    publishCatalog();
+    appendPrerequisite(course, prereq);
+    journal("PREREQ_ADD," + course + "," + prereq);
+    return Status::Ok;
 }
 
-bool CourseRegistrationSystem::checkPrerequisites(const string& courseCode) {
+bool CourseRegistrationSystem::checkPrerequisites(const string& username, const string& courseCode) {
     vector<string> prereqs = prerequisites.getPrerequisites(courseCode);
     if (prereqs.empty()) return true;
 
+    // Only courses from closed terms count; being enrolled in a prerequisite
+    // this term is not enough
     for (const string& prereq : prereqs) {
-        bool completed = false;
-        // Check if user has enrolled in the prerequisite (simplified check)
-        // In a real system, we would check for a passing grade.
-        Node<Enrollment>* current = enrollments.getHead();
-        while (current != nullptr) {
-            if (current->data.username == currentUser->getUsername() &&
-                current->data.courseCode == prereq) {
-                completed = true;
-                break;
-            }
-            current = current->next;
-        }
-        if (!completed) return false;
+        if (!hasCompleted(username, prereq)) return false;
     }
     return true;
 }
 
 void CourseRegistrationSystem::saveData() {
-    // Save Users
+    if (replica) return; // Replicas only read the primary's files
+    if (dirtyTables & TABLE_USERS) saveUsers();
+    if (dirtyTables & TABLE_COURSES) saveCourses();
+    if (dirtyTables & TABLE_ENROLLMENTS) saveEnrollments();
+    if (dirtyTables & TABLE_PAYMENTS) savePayments();
+    if (dirtyTables & TABLE_PREREQUISITES) savePrerequisites();
+    dirtyTables = 0;
+}
+
+void CourseRegistrationSystem::saveUsers() {
     ofstream userFile("users.txt");
     if (userFile.is_open()) {
         Node<User>* current = users.getHead();
@@ -719,41 +2249,180 @@ void CourseRegistrationSystem::saveData() {
                      << current->data.getPassword() << ","
                      << current->data.getFullName() << ","
                      << current->data.getRollNo() << ","
-                     << current->data.getIsAdmin() << "\n";
+                     << current->data.getIsAdmin() << ","
+                     << current->data.getFirstArchive() << "\n";
             current = current->next;
         }
         userFile.close();
     }
+}
 
-    // Save Courses
+void CourseRegistrationSystem::saveCourses() {
     ofstream courseFile("courses.txt");
     if (courseFile.is_open()) {
         vector<Course> courseList;
-        collectCourses(courses.getRoot(), courseList);
+        catalog.collectCourses(courseList);
         for (const auto& course : courseList) {
             courseFile << course.getCode() << ","
                        << course.getName() << ","
                        << course.getCreditHours() << ","
                        << course.getTotalSeats() << ","
-                       << course.getAvailableSeats() << "\n";
+                       << course.getAvailableSeats() << ","
+                       << formatSchedule(course.getTimeSlots()) << "\n";
         }
         courseFile.close();
     }
+}
 
-    // Save Enrollments
-    ofstream enrollFile("enrollments.txt");
-    if (enrollFile.is_open()) {
-        Node<Enrollment>* current = enrollments.getHead();
-        while (current != nullptr) {
-            enrollFile << current->data.username << ","
-                       << current->data.courseCode << "\n";
-            current = current->next;
-        }
+// enrollments.dat is the compact snapshot (see EnrollmentFile.h). enrollments.txt
+// only collects enrollments appended since, so a full save empties it.
+void CourseRegistrationSystem::saveEnrollments() {
+    EnrollmentGroups groups = groupEnrollments([this](auto visit) { catalog.forEachEnrollment(visit); });
+    EnrollmentFileWriter writer("enrollments.dat.tmp", groups.courseCodes, groups.usernames.size());
+    if (!writer.isOpen()) return;
+    for (size_t user = 0; user < groups.usernames.size(); user++) {
+        writer.putStudent(groups.usernames[user], groups.courseIds[user]);
+    }
+    if (!writer.finish()) return;
+
+    // Replace the snapshot whole, then drop the appended records it now covers
+    error_code failed;
+    filesystem::rename("enrollments.dat.tmp", "enrollments.dat", failed);
+    if (failed) return;
+    ofstream("enrollments.txt", ios::trunc);
+    enrollmentTailRecords = 0;
+}
+
+// payments.txt is an append-only ledger; a full save compacts it to one record per payment
+void CourseRegistrationSystem::savePayments() {
+    ofstream paymentFile("payments.txt");
+    if (paymentFile.is_open()) {
+        payments.forEach([&paymentFile](const Payment& payment) {
+            paymentFile << paymentRecord(payment) << "\n";
+        });
+        paymentFile.close();
+    }
+}
+
+void CourseRegistrationSystem::savePrerequisites() {
+    ofstream prereqFile("prerequisites.txt");
+    if (prereqFile.is_open()) {
+        prerequisites.forEachEdge([&prereqFile](const string& course, const string& prereq) {
+            prereqFile << course << "," << prereq << "\n";
+        });
+        prereqFile.close();
+    }
+}
+
+// Append helpers add one new record to the end of its file. If the table is
+// already waiting for a full rewrite, that rewrite will pick the record up.
+
+void CourseRegistrationSystem::appendUser(const User& user) {
+    dataVersion++;
+    if (replica || (dirtyTables & TABLE_USERS)) return;
+    ofstream userFile("users.txt", ios::app);
+    if (userFile.is_open()) {
+        userFile << user.getUsername() << ","
+                 << user.getPassword() << ","
+                 << user.getFullName() << ","
+                 << user.getRollNo() << ","
+                 << user.getIsAdmin() << ","
+                 << user.getFirstArchive() << "\n";
+    }
+}
+
+void CourseRegistrationSystem::appendCourse(const Course& course) {
+    dataVersion++;
+    if (replica || (dirtyTables & TABLE_COURSES)) return;
+    ofstream courseFile("courses.txt", ios::app);
+    if (courseFile.is_open()) {
+        courseFile << course.getCode() << ","
+                   << course.getName() << ","
+                   << course.getCreditHours() << ","
+                   << course.getTotalSeats() << ","
+                   << course.getAvailableSeats() << ","
+                   << formatSchedule(course.getTimeSlots()) << "\n";
+    }
+}
+
+// enrollments.txt is the tail of changes since the snapshot: "user,code" for an
+// enrollment and "DROP,user,code" for one removed. Adds and drops both cost one
+// appended line; the snapshot is only rewritten when the tail is folded in.
+void CourseRegistrationSystem::appendEnrollment(const Enrollment& enrollment) {
+    appendEnrollmentTail(enrollment.username + "," + enrollment.courseCode + "\n", 1);
+}
+
+void CourseRegistrationSystem::appendEnrollmentDrops(const vector<Enrollment>& dropped) {
+    string records;
+    for (const Enrollment& e : dropped) records += "DROP," + e.username + "," + e.courseCode + "\n";
+    appendEnrollmentTail(records, static_cast<int>(dropped.size()));
+}
+
+// Folds the tail in once it holds more records than the snapshot, so a
+// change costs amortized O(1) writes and loading never replays a long tail
+void CourseRegistrationSystem::appendEnrollmentTail(const string& records, int count) {
+    static const int MIN_TAIL_RECORDS = 4096;
+    dataVersion++;
+    if (replica || (dirtyTables & TABLE_ENROLLMENTS) || count == 0) return;
+    ofstream enrollFile("enrollments.txt", ios::app);
+    if (enrollFile.is_open()) enrollFile << records;
+    enrollmentTailRecords += count;
+    if (enrollmentTailRecords > max(MIN_TAIL_RECORDS, catalog.enrollmentCount())) {
         enrollFile.close();
+        markDirty(TABLE_ENROLLMENTS);
+        saveData();
+    }
+}
+
+// Ledger records use the same text as the journal: "PAY,id,user,amount,status"
+// for a new payment and "PAY_STATUS,id,status" for every later status change.
+// "PAY_PURGE,user" drops the payments of a deleted account recorded before it.
+string CourseRegistrationSystem::paymentRecord(const Payment& payment) {
+    return "PAY," + payment.transactionId + "," + payment.username + "," + to_string(payment.amount) + "," +
+           payment.status;
+}
+
+string CourseRegistrationSystem::statusRecord(const Payment& payment) {
+    return "PAY_STATUS," + payment.transactionId + "," + payment.status;
+}
+
+void CourseRegistrationSystem::appendPayment(const Payment& payment) {
+    appendLedger(paymentRecord(payment) + "\n");
+}
+
+void CourseRegistrationSystem::appendPaymentStatus(const Payment& payment) {
+    appendLedger(statusRecord(payment) + "\n");
+}
+
+void CourseRegistrationSystem::appendLedger(const string& records) {
+    dataVersion++;
+    if (replica || records.empty() || (dirtyTables & TABLE_PAYMENTS)) return;
+    ofstream paymentFile("payments.txt", ios::app);
+    if (paymentFile.is_open()) {
+        paymentFile << records;
+    }
+}
+
+void CourseRegistrationSystem::appendPrerequisite(const string& course, const string& prereq) {
+    dataVersion++;
+    if (replica || (dirtyTables & TABLE_PREREQUISITES)) return;
+    ofstream prereqFile("prerequisites.txt", ios::app);
+    if (prereqFile.is_open()) {
+        prereqFile << course << "," << prereq << "\n";
     }
 }
 
 void CourseRegistrationSystem::loadData() {
+    // Load Terms: every line but the last names a sealed archive
+    vector<string> terms;
+    ifstream termsFile(TERMS_FILE);
+    bool hasTerms = termsFile.is_open();
+    string term;
+    while (getline(termsFile, term)) {
+        if (isValidTermName(term)) terms.push_back(term);
+    }
+    currentTerm = terms.empty() ? DEFAULT_TERM : terms.back();
+
     // Load Users
     ifstream userFile("users.txt");
     if (userFile.is_open()) {
@@ -762,18 +2431,19 @@ void CourseRegistrationSystem::loadData() {
             if (line.empty()) continue; // Skip empty lines
             try {
                 stringstream ss(line);
-                string u, p, n, r, adminStr;
+                string u, p, n, r, adminStr, firstStr;
                 getline(ss, u, ',');
                 getline(ss, p, ',');
                 getline(ss, n, ',');
                 getline(ss, r, ',');
                 getline(ss, adminStr, ',');
+                getline(ss, firstStr, ','); // Missing in files from before accounts tracked it
 
                 // Validate data before inserting
                 if (u.empty() || p.empty() || n.empty() || r.empty()) continue;
 
                 bool isAdmin = (adminStr == "1");
-                users.insert(User(u, p, n, r, isAdmin));
+                addUser(User(u, p, n, r, isAdmin, firstStr.empty() ? 0 : stoi(firstStr)));
             } catch (...) {
                 // Skip malformed lines
                 continue;
@@ -782,6 +2452,11 @@ void CourseRegistrationSystem::loadData() {
         userFile.close();
     }
 
+    // Sealed terms credit completions to the accounts just loaded
+    for (size_t i = 0; i + 1 < terms.size(); i++) {
+        openArchive(terms[i]);
+    }
+
     // Load Courses
     ifstream courseFile("courses.txt");
     if (courseFile.is_open()) {
@@ -790,15 +2465,16 @@ void CourseRegistrationSystem::loadData() {
             if (line.empty()) continue; // Skip empty lines
             try {
                 stringstream ss(line);
-                string c, n, chStr, tsStr, asStr;
+                string c, n, chStr, tsStr, asStr, timesStr;
                 getline(ss, c, ',');
                 getline(ss, n, ',');
                 getline(ss, chStr, ',');
                 getline(ss, tsStr, ',');
                 getline(ss, asStr, ',');
+                getline(ss, timesStr, ','); // Absent in files written before meeting times
 
                 // Validate data before inserting
-                if (c.empty() || n.empty() || chStr.empty() || tsStr.empty() || asStr.empty()) continue;
+                if (!CourseKey::fits(c) || n.empty() || chStr.empty() || tsStr.empty() || asStr.empty()) continue;
 
                 int creditHours = stoi(chStr);
                 int totalSeats = stoi(tsStr);
@@ -806,11 +2482,14 @@ void CourseRegistrationSystem::loadData() {
 
                 // Validate numeric values
                 if (creditHours <= 0 || totalSeats <= 0 || availableSeats < 0) continue;
-                if (availableSeats > totalSeats) availableSeats = totalSeats;
 
-                Course course(c, n, creditHours, totalSeats);
-                course.setAvailableSeats(availableSeats);
-                courses.insert(course);
+                uint64_t slots = 0;
+                if (!parseSchedule(timesStr, slots)) slots = 0;
+
+                // Available seats are rebuilt from the enrollments file below
+                Course course(c, n, creditHours, totalSeats, slots);
+                catalog.insert(course);
+                countCourse(course, 1);
             } catch (...) {
                 // Skip malformed lines
                 continue;
@@ -819,27 +2498,435 @@ void CourseRegistrationSystem::loadData() {
         courseFile.close();
     }
 
-    // Load Enrollments
+    // Load Enrollments: the compact snapshot first
+    EnrollmentFileReader snapshot("enrollments.dat");
+    if (snapshot.isValid()) {
+        vector<Course*> courses; // Resolved once per dictionary entry
+        for (const string& code : snapshot.courseCodes) courses.push_back(catalog.search(code));
+        string username;
+        vector<uint32_t> ids;
+        while (snapshot.next(username, ids)) {
+            for (uint32_t id : ids) {
+                if (courses[id] == nullptr) continue; // The course is gone, and its enrollments with it
+                if (catalog.addEnrollment(Enrollment(username, snapshot.courseCodes[id]))) {
+                    countEnrollment(username, *courses[id], 1);
+                }
+            }
+        }
+    }
+
+    // Then changes appended since the snapshot (or a whole file from before snapshots existed).
+    // A crash between replacing the snapshot and emptying the tail leaves records
+    // the snapshot already holds; applied again they change nothing, since an
+    // enrollment is only added once and the last record for a pair decides.
     ifstream enrollFile("enrollments.txt");
     if (enrollFile.is_open()) {
         string line;
+        bool appended = false;
         while (getline(enrollFile, line)) {
             if (line.empty()) continue; // Skip empty lines
             try {
                 stringstream ss(line);
-                string u, c;
+                string u, c, dropped;
                 getline(ss, u, ',');
                 getline(ss, c, ',');
+                getline(ss, dropped, ','); // Set only on "DROP,user,code"
+                bool isDrop = u == "DROP" && !dropped.empty();
+                if (isDrop) {
+                    u = std::move(c);
+                    c = std::move(dropped);
+                }
 
                 // Validate data before inserting
                 if (u.empty() || c.empty()) continue;
 
-                enrollments.insert(Enrollment(u, c));
+                appended = true;
+                Course* course = catalog.search(c);
+                if (course == nullptr) continue;
+                if (isDrop) {
+                    if (catalog.removeEnrollment(u, c)) countEnrollment(u, *course, -1);
+                } else if (catalog.addEnrollment(Enrollment(u, c))) {
+                    countEnrollment(u, *course, 1);
+                }
             } catch (...) {
                 // Skip malformed lines
                 continue;
             }
         }
         enrollFile.close();
+        // Fold them into the snapshot right away. Left for a later save, the table
+        // would stay dirty, new enrollments would not be appended, and a crash
+        // before that save would lose them.
+        if (appended && !replica) saveEnrollments();
+    }
+    rebuildSeatCounts();
+
+    // Load Payments
+    ifstream paymentFile("payments.txt");
+    if (paymentFile.is_open()) {
+        string line;
+        while (getline(paymentFile, line)) {
+            if (line.empty()) continue; // Skip empty lines
+            try {
+                stringstream ss(line);
+                string t, u, amountStr, status;
+                getline(ss, t, ',');
+                if (t == "PAY_PURGE") {
+                    getline(ss, u, ',');
+                    forgetPayments(u); // Only payments recorded before the account was deleted
+                    continue;
+                }
+                if (t == "PAY_STATUS") {
+                    getline(ss, t, ',');
+                    getline(ss, status, ',');
+                    Payment* payment = payments.search(t);
+                    if (payment != nullptr && !status.empty()) setPaymentStatus(*payment, status);
+                    continue;
+                }
+                if (t == "PAY") getline(ss, t, ','); // Older files have untagged payment lines
+                getline(ss, u, ',');
+                getline(ss, amountStr, ',');
+                getline(ss, status, ',');
+
+                // Validate data before inserting
+                if (t.empty() || u.empty() || amountStr.empty() || status.empty()) continue;
+                if (payments.search(t) != nullptr) continue; // Skip duplicate transactions
+
+                addPayment(Payment(t, u, stod(amountStr), status));
+            } catch (...) {
+                // Skip malformed lines
+                continue;
+            }
+        }
+        paymentFile.close();
+    }
+
+    // Load Prerequisites
+    ifstream prereqFile("prerequisites.txt");
+    if (prereqFile.is_open()) {
+        string line;
+        while (getline(prereqFile, line)) {
+            if (line.empty()) continue; // Skip empty lines
+            stringstream ss(line);
+            string c, p;
+            getline(ss, c, ',');
+            getline(ss, p, ',');
+
+            // Validate data before inserting
+            if (c.empty() || p.empty()) continue;
+
+            linkPrerequisite(c, p);
+        }
+        prereqFile.close();
+    }
+    publishCatalog();
+
+    // Before terms, prerequisites counted every enrollment on file, so those
+    // enrollments are the only course history there is. They are sealed as a
+    // closed term of their own and the default term opens empty, just as
+    // closeTerm would leave it.
+    if (!hasTerms && !replica) {
+        bool hasEnrollments = false;
+        catalog.forEachEnrollment([&hasEnrollments](const Enrollment&) { hasEnrollments = true; });
+        if (hasEnrollments) {
+            currentTerm = LEGACY_TERM;
+            if (sealTerm(groupEnrollments([this](auto visit) { catalog.forEachEnrollment(visit); }))) {
+                startTerm(DEFAULT_TERM);
+                saveTerms();
+                saveData();
+            } else {
+                currentTerm = DEFAULT_TERM;
+            }
+        }
+    }
+}
+
+// Replication (log shipping)
+// The primary appends one record per mutation to journal.log:
+//   seq,timestampMs,OP,fields...   (free-text names always come last)
+// A replica loads the data files, then replays the journal on top of them.
+// Every record is applied idempotently, so replaying records whose effect is
+// already in the data files is harmless. Seat holds are never saved to the
+// files; HOLD and UNHOLD records carry them, and a replicated hold still runs
+// out on its own if the primary stops before journaling its end.
+
+long long CourseRegistrationSystem::wallClockMs() {
+    return chrono::duration_cast<chrono::milliseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void CourseRegistrationSystem::journal(const string& record) {
+    if (replica) return;
+    ofstream journalFile("journal.log", ios::app);
+    if (journalFile.is_open()) {
+        journalFile << ++journalSeq << "," << wallClockMs() << "," << record << "\n";
+    }
+}
+
+void CourseRegistrationSystem::journal(const vector<string>& records) {
+    if (replica || records.empty()) return;
+    ofstream journalFile("journal.log", ios::app);
+    if (journalFile.is_open()) {
+        long long now = wallClockMs();
+        for (const string& record : records) {
+            journalFile << ++journalSeq << "," << now << "," << record << "\n";
+        }
+    }
+}
+
+bool CourseRegistrationSystem::rejectOnReplica() {
+    return replica;
+}
+
+void CourseRegistrationSystem::refreshReplica() {
+    if (replica && wallClockMs() - lastSyncMs >= maxStalenessMs) {
+        syncReplica();
+    }
+}
+
+void CourseRegistrationSystem::syncReplica() {
+    lastSyncMs = wallClockMs();
+    ifstream journalFile("journal.log");
+    if (!journalFile.is_open()) return;
+
+    string line;
+    if (!getline(journalFile, line) || journalFile.eof()) return; // Header not fully written yet
+    if (line != journalSession) {
+        // The primary restarted: follow its new journal from the first record
+        journalSession = line;
+        journalOffset = journalFile.tellg();
+        journalSeq = 0;
+        // A journal begun in an earlier term than the loaded files replays nothing
+        // new until the term the files are in was opened
+        string started = line.substr(line.rfind(',') + 1);
+        if (count(line.begin(), line.end(), ',') >= 2 && started != currentTerm) awaitingTerm = currentTerm;
+    }
+
+    journalFile.seekg(journalOffset);
+    while (getline(journalFile, line)) {
+        if (journalFile.eof()) break; // Last record is still being written
+        journalOffset = journalFile.tellg();
+        if (!line.empty()) applyJournalRecord(line);
+    }
+    publishCatalog();
+}
+
+void CourseRegistrationSystem::applyJournalRecord(const string& record) {
+    stringstream ss(record);
+    string seqStr, timeStr, op;
+    getline(ss, seqStr, ',');
+    getline(ss, timeStr, ',');
+    getline(ss, op, ',');
+
+    try {
+        journalSeq = stoll(seqStr);
+        lastApplyDelayMs = wallClockMs() - stoll(timeStr);
+
+        if (op == "TERM_CLOSE") {
+            string next;
+            getline(ss, next, ',');
+            if (next == awaitingTerm) {
+                awaitingTerm.clear();
+            } else if (awaitingTerm.empty() && next != currentTerm) {
+                startTerm(next);
+            }
+            return;
+        }
+        if (!awaitingTerm.empty()) return;
+
+        if (op == "ENROLL" || op == "DROP") {
+            string u, c;
+            getline(ss, u, ',');
+            getline(ss, c, ',');
+            Course* course = catalog.search(c);
+            if (course == nullptr) return;
+            if (op == "ENROLL") {
+                // A confirmed hold gives its seat back to be taken as the enrollment
+                if (!isEnrolled(u, c)) {
+                    dropHold(u, c);
+                    addEnrollment(u, course);
+                }
+            } else {
+                removeEnrollment(u, course);
+            }
+        } else if (op == "HOLD") {
+            string u, c, secondsStr;
+            getline(ss, u, ',');
+            getline(ss, c, ',');
+            getline(ss, secondsStr, ',');
+            Course* course = catalog.search(c);
+            string key = holdKey(u, c);
+            // Counted from when the primary placed it, not from when it arrived here
+            double remaining = stoi(secondsStr) - lastApplyDelayMs / 1000.0;
+            expireHolds();
+            if (course != nullptr && remaining > 0 && seatHolds.search(key) == nullptr && course->holdSeat()) {
+                syncOpenSeats(*course);
+                uint64_t expiry = holdTimers.currentTick() + static_cast<uint64_t>(ceil(remaining));
+                seatHolds.insert(key, holdTimers.schedule(Enrollment(u, c), expiry));
+            }
+        } else if (op == "UNHOLD") {
+            string u, c;
+            getline(ss, u, ',');
+            getline(ss, c, ',');
+            dropHold(u, c);
+        } else if (op == "TERM_ARCHIVE") {
+            string term;
+            getline(ss, term, ',');
+            bool open = any_of(archives.begin(), archives.end(),
+                               [&term](const unique_ptr<TermArchive>& archive) { return archive->term() == term; });
+            if (!open && isValidTermName(term)) openArchive(term);
+        } else if (op == "USER_ADD") {
+            string u, p, r, adminStr, n;
+            getline(ss, u, ',');
+            getline(ss, p, ',');
+            getline(ss, r, ',');
+            getline(ss, adminStr, ',');
+            getline(ss, n);
+            if (findUser(u) == nullptr) {
+                addUser(User(u, p, n, r, adminStr == "1", static_cast<int>(archives.size())));
+            }
+        } else if (op == "USER_DEL") {
+            string u;
+            getline(ss, u, ',');
+            if (findUser(u) != nullptr) removeStudents({u});
+        } else if (op == "COURSE_ADD" || op == "COURSE_UPD") {
+            string c, chStr, tsStr, timesStr, n;
+            getline(ss, c, ',');
+            getline(ss, chStr, ',');
+            getline(ss, tsStr, ',');
+            getline(ss, timesStr, ',');
+            getline(ss, n);
+            uint64_t slots = 0;
+            parseSchedule(timesStr, slots);
+            Course* course = catalog.search(c);
+            if (course == nullptr) {
+                Course added(c, n, stoi(chStr), stoi(tsStr), slots);
+                catalog.insert(added);
+                countCourse(added, 1);
+            } else if (op == "COURSE_UPD") {
+                applyCourseUpdate(course, n, stoi(chStr), stoi(tsStr), slots);
+            }
+        } else if (op == "COURSE_DEL") {
+            string c;
+            getline(ss, c, ',');
+            if (catalog.search(c) != nullptr) removeCourses({c});
+        } else if (op == "PAY") {
+            string t, u, amountStr, status;
+            getline(ss, t, ',');
+            getline(ss, u, ',');
+            getline(ss, amountStr, ',');
+            getline(ss, status, ',');
+            if (payments.search(t) == nullptr) {
+                addPayment(Payment(t, u, stod(amountStr), status));
+            }
+        } else if (op == "PAY_STATUS") {
+            string t, status;
+            getline(ss, t, ',');
+            getline(ss, status, ',');
+            Payment* payment = payments.search(t);
+            if (payment != nullptr) setPaymentStatus(*payment, status);
+        } else if (op == "PREREQ_ADD") {
+            string c, p;
+            getline(ss, c, ',');
+            getline(ss, p, ',');
+            linkPrerequisite(c, p);
+        }
+    } catch (...) {
+        // Skip malformed records
+    }
+    dataVersion++;
+}
+
+Result<ReplicationStatus> CourseRegistrationSystem::replicationStatus(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::ViewReplicationStatus, &session);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (!replica) return ReplicationStatus{false, journalSeq, 0, 0, 0, 0};
+
+    refreshReplica();
+
+    // Count complete records the primary has written beyond our position
+    int pending = 0;
+    ifstream journalFile("journal.log");
+    if (journalFile.is_open()) {
+        journalFile.seekg(journalOffset);
+        string line;
+        while (getline(journalFile, line) && !journalFile.eof()) pending++;
+    }
+    return ReplicationStatus{true, journalSeq, maxStalenessMs, pending, lastApplyDelayMs, wallClockMs() - lastSyncMs};
+}
+
+// Every figure here comes from the running totals, so no enrollment or payment is rescanned
+Result<Dashboard> CourseRegistrationSystem::statistics(const SessionToken& session) {
+    TraceScope trace(*this, TraceOp::ViewStatistics, &session);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    refreshReplica();
+
+    Dashboard dashboard;
+    dashboard.payments = paymentStats;
+    catalog.forEachShard([this, &dashboard](ShardedCatalog::Shard& shard) {
+        DepartmentStats* stats = departmentStats.search(shard.department);
+        if (stats == nullptr) return;
+        dashboard.departments.emplace_back(shard.department, *stats);
+        dashboard.departments.back().second.students = shard.studentCourses.size();
+    });
+
+    vector<vector<CourseFill>> fills(catalog.shardCount());
+    forEachShardInParallel([&fills](ShardedCatalog::Shard& shard, int i) {
+        shard.courses.forEachInorder([&fills, i](const Course& course) {
+            int enrolled = course.getTotalSeats() - course.getAvailableSeats() - course.getHeldSeats();
+            fills[i].push_back({string(course.getCode()), enrolled, course.getTotalSeats()});
+        });
+    });
+    for (auto& part : fills) {
+        dashboard.courses.insert(dashboard.courses.end(), make_move_iterator(part.begin()), make_move_iterator(part.end()));
+    }
+
+    for (Node<User>* current = users.getHead(); current != nullptr; current = current->next) {
+        StudentLoad* load = studentLoads.search(current->data.getUsername());
+        if (!current->data.getIsAdmin() && load != nullptr && load->courses > 0) {
+            dashboard.students.emplace_back(current->data.getUsername(), *load);
+        }
     }
+    return dashboard;
+}
+
+Result<DepartmentStats> CourseRegistrationSystem::departmentStatistics(const SessionToken& session,
+                                                                       const string& department) {
+    TraceScope trace(*this, TraceOp::ViewDepartmentStats, &session, department);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    if (department.empty()) return Status::EmptyDepartment;
+    refreshReplica();
+
+    DepartmentStats* stats = departmentStats.search(department);
+    if (stats == nullptr || catalog.getShard(department) == nullptr) return Status::NoMatches;
+    DepartmentStats result = *stats;
+    result.students = catalog.studentsIn(department);
+    return result;
+}
+
+Result<CourseFill> CourseRegistrationSystem::courseStatistics(const SessionToken& session, const string& code) {
+    TraceScope trace(*this, TraceOp::ViewCourseStats, &session, code);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    refreshReplica();
+
+    Course* course = catalog.search(code);
+    if (course == nullptr) return Status::CourseNotFound;
+    int enrolled = course->getTotalSeats() - course->getAvailableSeats() - course->getHeldSeats();
+    return CourseFill{string(course->getCode()), enrolled, course->getTotalSeats()};
+}
+
+Result<StudentLoad> CourseRegistrationSystem::studentStatistics(const SessionToken& session, const string& username) {
+    TraceScope trace(*this, TraceOp::ViewStudentStats, &session, username);
+    User* currentUser = sessionUser(session);
+    if (currentUser == nullptr || !currentUser->getIsAdmin()) return Status::AdminRequired;
+    refreshReplica();
+
+    User* student = findUser(username);
+    if (student == nullptr || student->getIsAdmin()) return Status::StudentNotFound;
+    StudentLoad* load = studentLoads.search(username);
+    return load != nullptr ? *load : StudentLoad();
 }
@@ -2,71 +2,545 @@
 #define SYSTEM_H
 
 #include "DataStructures.h"
+#include "EnrollmentFile.h"
+#include "TermArchive.h"
+#include "TaskPool.h"
+#include "Admission.h"
+#include "Lottery.h"
+#include "Session.h"
+#include "Trace.h"
+#include "MemoryTracking.h"
+#include "Results.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 
+// Persisted datasets, tracked separately so a save only touches what changed
+enum DataTable {
+    TABLE_USERS = 1 << 0,
+    TABLE_COURSES = 1 << 1,
+    TABLE_ENROLLMENTS = 1 << 2,
+    TABLE_PAYMENTS = 1 << 3,
+    TABLE_PREREQUISITES = 1 << 4,
+    TABLE_ALL = TABLE_USERS | TABLE_COURSES | TABLE_ENROLLMENTS | TABLE_PAYMENTS | TABLE_PREREQUISITES
+};
+
+// Active term of a data directory that has never closed one
+const string DEFAULT_TERM = "2026-FALL";
+
+// Enrollments kept before terms existed are sealed under this name on first load
+const string LEGACY_TERM = "PRE-TERMS";
+
+// Per-user undo/redo history; bounded so memory stays flat however long the system runs
+struct UndoLog {
+    static const int CAPACITY = 20;
+    RingBuffer<UserAction, CAPACITY> undo;
+    RingBuffer<UserAction, CAPACITY> redo;
+};
+
+inline void heapUsage(const UndoLog& log, MemoryStats& stats) {
+    auto visit = [&stats](const UserAction& action) { heapUsage(action, stats); };
+    log.undo.forEach(visit);
+    log.redo.forEach(visit);
+}
+
+// Running totals for the admin dashboard, updated on every change so reading them is O(1)
+struct DepartmentStats {
+    int courses;
+    int totalSeats;
+    int enrollments;
+    int students; // Distinct students, filled in from the catalog when read
+    DepartmentStats() : courses(0), totalSeats(0), enrollments(0), students(0) {}
+};
+
+struct StudentLoad {
+    int courses;
+    int creditHours;
+    StudentLoad() : courses(0), creditHours(0) {}
+};
+
+// Hours a student is already committed to; counts let overlapping loaded data unwind cleanly
+struct StudentSchedule {
+    uint64_t busySlots;
+    unsigned char slotCounts[SCHEDULE_SLOTS];
+    StudentSchedule() : busySlots(0), slotCounts() {}
+};
+
+struct PaymentStats {
+    int completedCount;
+    double completedAmount;
+    int voidedCount;
+    double voidedAmount;
+    PaymentStats() : completedCount(0), completedAmount(0.0), voidedCount(0), voidedAmount(0.0) {}
+};
+
+// Term-by-term route to a target course, cached per (student, target)
+struct DegreePlan {
+    int maxCredits; // Credit limit the plan was built under
+    bool feasible;
+    string problem; // Why the plan is infeasible
+    vector<vector<string>> terms;
+    vector<int> termCredits;
+    DegreePlan() : maxCredits(0), feasible(true) {}
+};
+
+inline void heapUsage(const DegreePlan& plan, MemoryStats& stats) {
+    heapUsage(plan.problem, stats);
+    heapUsage(plan.terms, stats);
+    heapUsage(plan.termCredits, stats);
+}
+
+// One row of the enrollment report, resolved against users and courses when the snapshot is built
+struct EnrollmentRow {
+    string fullName;
+    string courseName;
+    string courseCode;
+};
+
+inline void heapUsage(const EnrollmentRow& row, MemoryStats& stats) {
+    heapUsage(row.fullName, stats);
+    heapUsage(row.courseName, stats);
+    heapUsage(row.courseCode, stats);
+}
+
+// Immutable, versioned view of all enrollments. Holders keep their snapshot alive
+// while the live data moves on; it is freed when the last holder lets go.
+using EnrollmentSnapshot = shared_ptr<const vector<EnrollmentRow>>;
+
+// Open seats of one course, stored to on every seat change. Snapshots share it,
+// so a reader sees current seats without touching the live catalog.
+using SeatCounter = shared_ptr<atomic<int>>;
+
+// Immutable copy of the browsable catalog: course details and prerequisite text in
+// two flat arrays. Open seats change far more often, so each entry points at the
+// course's seat counter instead of holding a copy.
+struct CatalogEntry {
+    CourseKey key;
+    string code;
+    string name;
+    int creditHours;
+    int totalSeats;
+    uint64_t timeSlots;
+    vector<string> prerequisites;
+    SeatCounter availableSeats;
+};
+
+inline void heapUsage(const CatalogEntry& entry, MemoryStats& stats) {
+    heapUsage(entry.code, stats);
+    heapUsage(entry.name, stats);
+    heapUsage(entry.prerequisites, stats);
+}
+
+struct CatalogSnapshot {
+    long long version;
+    vector<CatalogEntry> byCode;
+    vector<int> byName; // Indexes into byCode, ordered by course name
+};
+
+using CatalogView = shared_ptr<const CatalogSnapshot>;
+
+// Views handed to front ends. They are copies, so they stay valid whatever
+// the system does after the call returns.
+
+struct UserView {
+    string username;
+    string fullName;
+    string rollNo;
+    bool isAdmin;
+};
+
+struct LoginSession {
+    SessionToken token; // Passed back on every call made as this user
+    UserView user;
+};
+
+struct CourseView {
+    string code;
+    string name;
+    int creditHours;
+    uint64_t timeSlots;
+    int availableSeats;
+    int totalSeats;
+    vector<string> prerequisites;
+};
+
+enum class CourseOrder { ByCode, ByName };
+
+struct StudentRecord {
+    vector<CourseView> courses; // Enrolled courses, in catalog order
+    int creditHours;
+    int minCreditHours; // Limits the load is held to
+    int maxCreditHours;
+};
+
+struct CourseRoster {
+    string courseName;
+    vector<UserView> students;
+};
+
+struct PaymentHistory {
+    vector<Payment> payments; // Oldest first
+    PaymentStats totals;
+};
+
+struct ReconciliationReport {
+    int lines;
+    int added;
+    int updated;
+    int unchanged;
+    int mismatched; // Disagree with the ledger on username or amount; left alone
+    int rejected;   // Malformed, or failing the checks a payment made in person must pass
+    vector<pair<int, Status>> rejections; // File line number and reason for each rejected line
+    double seconds;
+};
+
+struct WindowView {
+    string rollPrefix;
+    double opensIn; // Seconds from now; negative once the window is open
+};
+
+struct AdmissionReport {
+    AdmissionMetrics metrics;
+    int queueDepth;
+    vector<WindowView> windows;
+};
+
+struct LotteryReport {
+    uint64_t seed;
+    size_t assigned; // Enrollments committed
+    size_t refused;  // Drawn but no longer seatable, so left out
+    int requested; // Ranked choices over all students
+    size_t students;
+    long long elapsedMs;
+    uint64_t digest;
+};
+
+struct LotteryCheck {
+    uint64_t seed;
+    size_t students;
+    size_t assigned;
+    uint64_t recordedDigest;
+    uint64_t replayDigest;
+};
+
+struct ReplicationStatus {
+    bool replica;
+    long long lastRecord; // Written on a primary, applied on a replica
+    int maxStalenessMs;
+    int pending;          // Records the primary has written beyond ours
+    long long applyLagMs;
+    long long sinceSyncMs;
+};
+
+struct CourseFill {
+    string code;
+    int enrolled;
+    int totalSeats;
+};
+
+struct Dashboard {
+    PaymentStats payments;
+    vector<pair<string, DepartmentStats>> departments;
+    vector<CourseFill> courses;
+    vector<pair<string, StudentLoad>> students; // Students carrying at least one course
+};
+
+// Completed courses per archived term, oldest term first
+struct TranscriptTerm {
+    string term;
+    vector<pair<string, int>> courses; // Code and credit hours as of that term
+    int creditHours;
+};
+
+struct Transcript {
+    vector<TranscriptTerm> terms; // Only terms with completed courses
+    int creditHours;
+};
+
+struct TermSummary {
+    string term;
+    bool readable; // False if the archive file is missing or damaged
+    size_t students;
+    size_t enrollments;
+    size_t bytes;
+    bool mapped; // Otherwise read into memory
+};
+
+struct TermReport {
+    string activeTerm;
+    vector<TermSummary> archived; // Oldest first
+};
+
+struct MemoryReport {
+    vector<pair<string, MemoryStats>> rows;
+    bool heapTracked;
+    HeapCounters heap; // Meaningful only when heapTracked
+};
+
 class CourseRegistrationSystem {
 private:
     LinkedList<User> users;
-    BST courses;
-    LinkedList<Enrollment> enrollments;
-    Stack<Enrollment> undoStack;
+    HashTable<User*> userIndex; // Username -> record in users
+    ShardedCatalog catalog; // Courses and their enrollments, partitioned by department
+    HashTable<UndoLog> undoLogs; // Keyed by username
+    TimingWheel<Enrollment> holdTimers; // One tick per second since startup
+    HashTable<TimingWheel<Enrollment>::Timer*> seatHolds; // "user:course" -> expiry timer
+    int holdDurationSeconds;
+    chrono::steady_clock::time_point clockStart;
+    optional<double> setTime; // Clock reading while driven by setClock()
     HashTable<Payment> payments; // Added Payment Hash Table
     Graph prerequisites; // Added Graph for prerequisites
-    User* currentUser;
+    HashTable<DepartmentStats> departmentStats; // Keyed by department prefix
+    HashTable<StudentLoad> studentLoads;        // Keyed by username
+    HashTable<StudentSchedule> schedules;       // Keyed by username
+    CourseIndex courseIndex;                    // Dense course IDs for the eligibility query
+    HashTable<vector<uint64_t>> takenCourses;   // Username -> bitset of enrolled course IDs
+    HashTable<DegreePlan> degreePlans;          // "user:target" -> cached plan
+    HashTable<vector<string>> plansByCourse;    // Course -> keys of cached plans that route through it
+    HashTable<vector<string>> plansByStudent;   // Username -> keys of that student's cached plans
+    int minCreditHours; // Per-student load limits, checked against studentLoads
+    int maxCreditHours;
+    PaymentStats paymentStats;
+    HashTable<vector<string>> paymentsByUser; // Username -> transaction IDs, oldest first
+    HashTable<PaymentStats> paymentTotals;    // Username -> that student's sums
+    SessionTable sessions; // Token -> username; any number of users may be logged in at once
+    int dirtyTables; // DataTable flags waiting to be rewritten by saveData()
+    int enrollmentTailRecords; // Records in enrollments.txt not yet folded into enrollments.dat
+    long long dataVersion; // Bumped on every committed change
+    EnrollmentSnapshot enrollmentSnapshot;
+    long long snapshotVersion;
+    long long catalogVersion; // Bumped when course details or prerequisites change
+    atomic<CatalogView> publishedCatalog; // Swapped whole; readers never see a partial build
+    HashTable<SeatCounter> seatCounters;  // Course code -> its live open-seat count
+    TaskPool* taskPool; // Runs per-shard scans in parallel; nullptr for the shared pool
+    AdmissionController admission; // Registration windows, rate limits and the ticket queue
+    bool preferenceRoundOpen; // Students may submit lottery preferences
+    HashTable<vector<string>> lotteryPreferences; // Username -> ranked course codes
+    vector<string> lotteryEntrants; // Usernames with preferences, first submission order
 
-    // Helper functions
-    static bool userComparator(const User& u, const string& username) {
-        return u.getUsername() == username;
-    }
+    // Only the active term lives in the structures above; closed terms are
+    // sealed archives, read just for prerequisite and transcript queries
+    string currentTerm;
+    vector<unique_ptr<TermArchive>> archives; // Oldest first
+    // Every course each student completed in a closed term, sorted. Views point
+    // into the archives; built as they open, so a check is one lookup, not one per term.
+    HashTable<vector<string_view>> completedByStudent;
+
+    // Log shipping: the primary journals every mutation to journal.log and
+    // read replicas replay it on top of the data files
+    bool replica;
+    long long journalSeq;      // Last record written (primary) or applied (replica)
+    string journalSession;     // Header line of the primary run being followed
+    string awaitingTerm;       // Records before this term opened are already in the loaded files
+    long long journalOffset;   // Replica read position in journal.log
+    long long lastSyncMs;
+    long long lastApplyDelayMs;
+    int maxStalenessMs;        // Reads on a replica are never older than this (browsing: as of the last tick)
+
+    // Trace recording: each public call made while recording becomes one
+    // record, written when the call returns
+    class TraceScope;
+    unique_ptr<TraceWriter> recorder;
+    mutex recorderLock;    // Browse calls may finish on several threads at once
+    double recordingStart; // Clock reading when recording began
 
+    // Helper functions
     static bool rollNoComparator(const User& u, const string& rollNo) {
         return u.getRollNo() == rollNo;
     }
 
-    static bool enrollmentComparator(const Enrollment& e, const string& key) {
-        return e.username + ":" + e.courseCode == key;
+    static string holdKey(const string& username, const string& code) {
+        return username + ":" + code;
+    }
+
+    void countCourse(const Course& course, int delta);
+    void countEnrollment(const string& username, const Course& course, int delta);
+    void countPayment(const Payment& payment, int delta);
+    Payment* addPayment(Payment payment);
+    void forgetPayments(const string& username);
+    void setPaymentStatus(Payment& payment, const string& status);
+    void bookSlots(const string& username, uint64_t slots, int delta);
+    void syncOpenSeats(const Course& course);
+    bool linkPrerequisite(const string& course, const string& prereq);
+    bool hasTaken(const string& username, const string& code); // Enrolled now or completed before
+    bool hasCompleted(const string& username, const string& code);
+    vector<uint64_t> completedCourses(const string& username); // Bitset of course IDs
+    template <typename Func>
+    static EnrollmentGroups groupEnrollments(Func forEachEnrollment);
+    bool sealTerm(const EnrollmentGroups& groups);
+    void startTerm(const string& term);
+    void openArchive(const string& term);
+    void saveTerms();
+    const DegreePlan* degreePlanFor(const string& username, const string& target);
+    void forgetPlans(HashTable<vector<string>>& byOwner, string_view owner);
+    bool hasScheduleConflict(const string& username, const Course& course);
+    int creditLoad(const string& username);
+    bool exceedsCreditLimit(const string& username, const Course& course);
+    bool breaksCreditMinimum(const string& username, const Course& course);
+    void applyCourseUpdate(Course* course, const string& name, int creditHours, int totalSeats, uint64_t slots);
+    void addUser(User user);
+    User* findUser(const string& username);
+    EnrollmentSnapshot pinEnrollmentSnapshot();
+    void publishCatalog();
+    TaskPool& workPool();
+    void forEachShardInParallel(const function<void(ShardedCatalog::Shard&, int)>& visit);
+    int rebuildSeatCounts();
+    const CatalogEntry* findCatalogEntry(const CatalogSnapshot& snapshot, const string& code);
+    bool isEnrolled(const string& username, const string& code);
+    void expireHolds();
+    void cancelHoldsIf(const function<bool(const Enrollment&)>& matches);
+    bool dropHold(const string& username, const string& code);
+    double clockSeconds();
+    User* sessionUser(const SessionToken& session); // nullptr if not logged in
+    Outcome admitRequest(const User& student);
+    Outcome checkFit(const string& username, const Course& course);
+    static UserView viewOf(const User& user);
+    CourseView viewOf(const Course& course);
+    LotteryInput buildLotteryInput(uint64_t seed);
+    static void writeLotteryAudit(const LotteryInput& input, const LotteryResult& result,
+                                  const vector<LotteryAssignment>& refused);
+    static bool readLotteryAudit(LotteryInput& input, uint64_t& digest);
+    void removeCourses(const vector<string>& sortedCodes);
+    void removeStudents(const vector<string>& sortedUsernames);
+
+    UndoLog* undoLogFor(const string& username);
+    void recordAction(const string& username, const UserAction& action);
+    bool applyAction(const string& username, const UserAction& action, bool reverse);
+    bool addEnrollment(const string& username, Course* course);
+    bool removeEnrollment(const string& username, Course* course);
+
+
+    // Persistence helpers
+    void markDirty(int tables) {
+        dirtyTables |= tables;
+        dataVersion++;
     }
+    void appendUser(const User& user);
+    void appendCourse(const Course& course);
+    void appendEnrollment(const Enrollment& enrollment);
+    void appendEnrollmentDrops(const vector<Enrollment>& dropped);
+    void appendEnrollmentTail(const string& records, int count);
+    void appendPayment(const Payment& payment);
+    void appendPaymentStatus(const Payment& payment);
+    void appendLedger(const string& records);
+    static string paymentRecord(const Payment& payment);
+    static string statusRecord(const Payment& payment);
+    void appendPrerequisite(const string& course, const string& prereq);
+    static long long wallClockMs();
+    void journal(const string& record);
+    void journal(const vector<string>& records); // One file open for a whole batch
+    bool rejectOnReplica();
+    void refreshReplica();
+    void syncReplica();
+    void applyJournalRecord(const string& record);
 
-    static void sortCoursesByName(vector<Course>& courseList);
-    void collectCourses(BSTNode* node, vector<Course>& courseList);
+    void saveUsers();
+    void saveCourses();
+    void saveEnrollments();
+    void savePayments();
+    void savePrerequisites();
 
 public:
-    CourseRegistrationSystem();
+    explicit CourseRegistrationSystem(bool readReplica = false);
     ~CourseRegistrationSystem();
 
-    // Common functions
-    bool login(const string& username, const string& password);
-    void logout();
-    void registerUser(const string& username, const string& password, const string& fullName, const string& rollNo);
+    // Calls made as a user take the token login returned; an unknown, closed
+    // or expired token is answered with Status::NotLoggedIn
+    Result<LoginSession> login(const string& username, const string& password);
+    Status logout(const SessionToken& session);
+    Status registerUser(const string& username, const string& password, const string& fullName, const string& rollNo);
     void seedData();
-    bool isCurrentUserAdmin();  // Check if current user is admin
+    bool isAdmin(const SessionToken& session);
+    // The clock behind hold expiry, admission control and session timeouts reads
+    // seconds since startup. Once set here it stands still until set again, so a
+    // replay or a test decides exactly when time passes.
+    void setClock(double seconds);
+    // The upkeep browsing leaves out so that it only reads: lapsed holds give
+    // back their seats and a replica catches up with its primary. The front
+    // end runs it before each request, and setClock runs it when time moves.
+    void tick();
+    // Appends every public call from now on to a trace (see Trace.h), starting
+    // from the data files as they are saved now
+    Status startRecording(const string& path);
+    // Parallel work runs on the process-wide pool unless given one of its own here
+    void setTaskPool(TaskPool& pool);
+    string sessionUsername(const SessionToken& session); // Empty once the session has ended or expired
+    bool hasCourse(const string& code);
 
     // Student functions
-    void viewAllCourses(int sortOption); // 0: by code, 1: by name
-    void searchCourse(const string& code);
-    void enrollCourse(const string& code);
-    void viewMyHistory();
-    void undoLastAction();
+    // Browsing reads only the published catalog and the seat counters, so any
+    // number of threads may browse while one thread makes changes
+    vector<CourseView> listCourses(CourseOrder order);
+    optional<CourseView> findCourse(const string& code);
+    Outcome enrollCourse(const SessionToken& session, const string& code);
+    Outcome holdSeat(const SessionToken& session, const string& code);
+    Outcome confirmHold(const SessionToken& session, const string& code);
+    Outcome releaseHold(const SessionToken& session, const string& code);
+    Outcome dropCourse(const SessionToken& session, const string& code);
+    Result<StudentRecord> myEnrollments(const SessionToken& session);
+    Result<vector<CourseView>> eligibleCourses(const SessionToken& session);
+    Result<DegreePlan> degreePlan(const SessionToken& session, const string& username, const string& target);
+    // Ranked, most wanted first
+    Outcome submitPreferences(const SessionToken& session, const vector<string>& codes);
+    Result<UserAction> undoLastAction(const SessionToken& session); // The action, also when it no longer applies
+    Result<UserAction> redoLastAction(const SessionToken& session);
 
     // Admin functions
-    void addCourse(const string& code, const string& name, int creditHours, int totalSeats);
-    void deleteCourse(const string& code);
-    void updateCourse(const string& code);
-    void viewAllUsers();
-    void deleteUser(const string& username);
-    void viewCourseEnrollments(const string& code);
-    void viewAllEnrollments();
+    Status addCourse(const SessionToken& session, const string& code, const string& name, int creditHours,
+                     int totalSeats, const string& meetingTimes);
+    Status deleteCourse(const SessionToken& session, const string& code);
+    // Blank name or meeting times, or non-positive numbers, keep the current value
+    Outcome updateCourse(const SessionToken& session, const string& code, const string& newName, int newCreditHours,
+                         int newTotalSeats, const string& newTimes);
+    Result<vector<UserView>> allUsers(const SessionToken& session);
+    Status deleteUser(const SessionToken& session, const string& username);
+    Outcome retireDepartment(const SessionToken& session, const string& department); // Bulk course delete, e.g. "ENG"
+    Outcome removeCohort(const SessionToken& session, const string& rollNoPrefix); // Bulk student delete, e.g. "02-134242"
+    Result<CourseRoster> courseEnrollments(const SessionToken& session, const string& code);
+    Result<EnrollmentSnapshot> allEnrollments(const SessionToken& session);
+    Status setHoldDuration(const SessionToken& session, int minutes);
+    Status setCreditLimits(const SessionToken& session, int minHours, int maxHours);
+    Outcome setRegistrationWindow(const SessionToken& session, const string& rollNoPrefix, int opensInMinutes);
+    Result<AdmissionReport> admissionMetrics(const SessionToken& session);
+    Outcome openPreferenceRound(const SessionToken& session);
+    Result<LotteryReport> runSeatLottery(const SessionToken& session, uint64_t seed);
+    Result<LotteryCheck> verifyLotteryAudit(const SessionToken& session);
+    Result<ReplicationStatus> replicationStatus(const SessionToken& session);
+    Result<Dashboard> statistics(const SessionToken& session); // Registration dashboard
+    // One row of the dashboard each, read straight from the running totals
+    Result<DepartmentStats> departmentStatistics(const SessionToken& session, const string& department);
+    Result<CourseFill> courseStatistics(const SessionToken& session, const string& code);
+    Result<StudentLoad> studentStatistics(const SessionToken& session, const string& username);
+    Result<MemoryReport> memoryReport(const SessionToken& session); // Per-structure footprint, for sizing hosts
+    // Archives the active term and opens the next
+    Outcome closeTerm(const SessionToken& session, const string& nextTerm);
+    Result<TermReport> termArchives(const SessionToken& session);
+    // Recounts every course's open seats from its enrollments; count is the courses corrected
+    Outcome recountSeats(const SessionToken& session);
+    // Student,Course Code,Course Name per enrollment, in report order; count is the rows written
+    Outcome exportEnrollments(const SessionToken& session, const string& filename);
+    // Students see their own; admins anyone's
+    Result<Transcript> transcript(const SessionToken& session, const string& username);
 
     // Payment functions
-    void processPayment(const string& transactionId, double amount);
-    void viewPaymentStatus(const string& transactionId);
+    Outcome processPayment(const SessionToken& session, const string& transactionId, double amount);
+    Result<Payment> paymentStatus(const SessionToken& session, const string& transactionId);
+    Status voidPayment(const SessionToken& session, const string& transactionId);
+    // Students see their own; admins anyone's
+    Result<PaymentHistory> paymentHistory(const SessionToken& session, const string& username);
+    // Bank file: id,username,amount,status
+    Result<ReconciliationReport> importReconciliation(const SessionToken& session, const string& filename);
 
     // Prerequisite functions
-    void addPrerequisite(const string& course, const string& prereq);
-    bool checkPrerequisites(const string& courseCode);
+    Status addPrerequisite(const SessionToken& session, const string& course, const string& prereq);
+    bool checkPrerequisites(const string& username, const string& courseCode);
 
     // File Handling
-    void saveData();
+    void saveData(); // Rewrites only the tables marked dirty
     void loadData();
 };
 
@@ -0,0 +1,147 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Work-stealing pool for the heavy admin jobs.
+// Every participant owns a deque: it takes its own newest job first and, once
+// that runs dry, steals the oldest job of another participant. The thread that
+// calls run() is participant 0 and works through the batch too, so a batch
+// always finishes, even on a pool with no worker threads.
+class TaskPool {
+private:
+    struct Batch {
+        function<void(int)> task;
+        atomic<int> remaining;
+        Batch(function<void(int)> t, int count) : task(std::move(t)), remaining(count) {}
+    };
+
+    struct Job {
+        Batch* batch;
+        int index;
+    };
+
+    struct Queue {
+        mutex lock;
+        deque<Job> jobs;
+    };
+
+    vector<unique_ptr<Queue>> queues; // queues[0] belongs to the caller of run()
+    vector<thread> workers;
+    mutex sleepLock;
+    condition_variable wake;  // Workers wait here for new jobs
+    condition_variable done;  // run() waits here for its batch
+    atomic<int> pending;      // Jobs queued but not yet taken
+    bool stopping;
+
+    bool take(size_t self, Job& job) {
+        {
+            Queue& own = *queues[self];
+            lock_guard<mutex> guard(own.lock);
+            if (!own.jobs.empty()) {
+                job = own.jobs.back();
+                own.jobs.pop_back();
+                return true;
+            }
+        }
+        for (size_t step = 1; step < queues.size(); step++) {
+            Queue& victim = *queues[(self + step) % queues.size()];
+            lock_guard<mutex> guard(victim.lock);
+            if (!victim.jobs.empty()) {
+                job = victim.jobs.front();
+                victim.jobs.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Runs one job if any can be found; false when every queue is empty
+    bool runOne(size_t self) {
+        Job job{};
+        if (!take(self, job)) return false;
+        pending--;
+        job.batch->task(job.index);
+        if (--job.batch->remaining == 0) {
+            lock_guard<mutex> guard(sleepLock);
+            done.notify_all();
+        }
+        return true;
+    }
+
+    void workerLoop(size_t self) {
+        while (true) {
+            if (runOne(self)) continue;
+            unique_lock<mutex> guard(sleepLock);
+            wake.wait(guard, [this] { return stopping || pending > 0; });
+            if (stopping) return;
+        }
+    }
+
+public:
+    // threads counts every participant, the calling thread included
+    explicit TaskPool(unsigned threads = thread::hardware_concurrency()) : pending(0), stopping(false) {
+        if (threads == 0) threads = 1;
+        for (unsigned i = 0; i < threads; i++) queues.push_back(make_unique<Queue>());
+        for (unsigned i = 1; i < threads; i++) workers.emplace_back(&TaskPool::workerLoop, this, i);
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    ~TaskPool() {
+        {
+            lock_guard<mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (thread& worker : workers) worker.join();
+    }
+
+    unsigned size() const { return static_cast<unsigned>(queues.size()); }
+
+    // Calls task(i) for every i in [0, count) across the pool; returns when all are done
+    void run(int count, function<void(int)> task) {
+        if (count <= 0) return;
+        if (count == 1 || queues.size() == 1) {
+            for (int i = 0; i < count; i++) task(i);
+            return;
+        }
+
+        Batch batch(std::move(task), count);
+        for (int i = 0; i < count; i++) {
+            Queue& target = *queues[i % queues.size()];
+            lock_guard<mutex> guard(target.lock);
+            target.jobs.push_back({&batch, i});
+        }
+        {
+            lock_guard<mutex> guard(sleepLock);
+            pending += count;
+        }
+        wake.notify_all();
+
+        while (batch.remaining > 0) {
+            if (runOne(0)) continue;
+            unique_lock<mutex> guard(sleepLock);
+            done.wait(guard, [&batch] { return batch.remaining == 0; });
+        }
+    }
+};
+
+// One pool for the whole process, started by the first batch that needs it.
+// Systems, replicas and replays all share it instead of each starting a
+// thread per core; run() may be called from several threads at once.
+inline TaskPool& sharedTaskPool() {
+    static TaskPool pool;
+    return pool;
+}
+
+#endif
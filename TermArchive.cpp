@@ -0,0 +1,171 @@
+#include "TermArchive.h"
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CRS_HAVE_MMAP 1
+#endif
+
+using namespace std;
+
+namespace {
+
+void put32(string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) out.push_back(static_cast<char>((value >> shift) & 0xFF));
+}
+
+}
+
+string termArchivePath(const string& term) {
+    return "term_" + term + ".dat";
+}
+
+bool isValidTermName(const string& term) {
+    if (term.empty() || term.size() > 32) return false;
+    for (char c : term) {
+        if (!isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_') return false;
+    }
+    return true;
+}
+
+vector<string> termArchiveFiles() {
+    vector<string> names;
+    ifstream termsFile(TERMS_FILE);
+    string line;
+    while (getline(termsFile, line)) {
+        if (isValidTermName(line)) names.push_back(termArchivePath(line));
+    }
+    if (!names.empty()) names.pop_back(); // The active term has no archive yet
+    return names;
+}
+
+bool TermArchive::write(const string& path, const string& term, const EnrollmentGroups& groups,
+                        const vector<int>& creditHours) {
+    uint32_t courseCount = static_cast<uint32_t>(groups.courseCodes.size());
+    uint32_t studentCount = static_cast<uint32_t>(groups.usernames.size());
+    uint32_t enrollmentCount = 0;
+    for (const vector<uint32_t>& ids : groups.courseIds) enrollmentCount += static_cast<uint32_t>(ids.size());
+
+    // Everything but the strings is fixed width, so string offsets are known up front
+    string out = "CRSTERM1";
+    size_t strings = HEADER_SIZE + COURSE_ENTRY * courseCount + STUDENT_ENTRY * studentCount + 4 * enrollmentCount;
+    string pool = term;
+    put32(out, studentCount);
+    put32(out, courseCount);
+    put32(out, enrollmentCount);
+    put32(out, static_cast<uint32_t>(strings));
+    put32(out, static_cast<uint32_t>(term.size()));
+    for (uint32_t c = 0; c < courseCount; c++) {
+        put32(out, static_cast<uint32_t>(strings + pool.size()));
+        put32(out, static_cast<uint32_t>(groups.courseCodes[c].size()));
+        put32(out, static_cast<uint32_t>(c < creditHours.size() ? creditHours[c] : 0));
+        pool += groups.courseCodes[c];
+    }
+    uint32_t first = 0;
+    for (uint32_t s = 0; s < studentCount; s++) {
+        put32(out, static_cast<uint32_t>(strings + pool.size()));
+        put32(out, static_cast<uint32_t>(groups.usernames[s].size()));
+        put32(out, first);
+        put32(out, static_cast<uint32_t>(groups.courseIds[s].size()));
+        first += static_cast<uint32_t>(groups.courseIds[s].size());
+        pool += groups.usernames[s];
+    }
+    for (const vector<uint32_t>& ids : groups.courseIds) {
+        for (uint32_t id : ids) put32(out, id);
+    }
+    out += pool;
+
+    string temporary = path + ".tmp";
+    {
+        ofstream file(temporary, ios::binary | ios::trunc);
+        file.write(out.data(), static_cast<streamsize>(out.size()));
+        if (!file.good()) return false;
+    }
+    error_code failed;
+    filesystem::rename(temporary, path, failed);
+    return !failed;
+}
+
+TermArchive::TermArchive(const string& term)
+    : name(term), data(nullptr), size(0), mapped(false), valid(false), students(0), courses(0), enrollments(0) {
+    string path = termArchivePath(term);
+#ifdef CRS_HAVE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                data = static_cast<const char*>(view);
+                size = static_cast<size_t>(info.st_size);
+                mapped = true;
+            }
+        }
+        close(fd);
+    }
+#endif
+    if (!mapped) {
+        // No mmap here (or it failed): read the file instead
+        ifstream file(path, ios::binary);
+        buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    if (size < HEADER_SIZE || string_view(data, 8) != "CRSTERM1") return;
+    students = field(8);
+    courses = field(12);
+    enrollments = field(16);
+    size_t tables = HEADER_SIZE + COURSE_ENTRY * static_cast<size_t>(courses) +
+                    STUDENT_ENTRY * static_cast<size_t>(students) + 4 * static_cast<size_t>(enrollments);
+    valid = tables <= size;
+}
+
+TermArchive::~TermArchive() {
+#ifdef CRS_HAVE_MMAP
+    if (mapped) munmap(const_cast<char*>(data), size);
+#endif
+}
+
+uint32_t TermArchive::field(size_t offset) const {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data + offset);
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+string_view TermArchive::text(size_t offset, size_t length) const {
+    if (offset > size || length > size - offset) return {};
+    return string_view(data + offset, length);
+}
+
+bool TermArchive::findStudent(string_view username, uint32_t& first, uint32_t& count) const {
+    if (!valid) return false;
+    size_t table = HEADER_SIZE + COURSE_ENTRY * static_cast<size_t>(courses);
+    uint32_t lo = 0, hi = students;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        size_t entry = table + STUDENT_ENTRY * mid;
+        int order = text(field(entry), field(entry + 4)).compare(username);
+        if (order == 0) {
+            first = field(entry + 8);
+            count = field(entry + 12);
+            return static_cast<uint64_t>(first) + count <= enrollments;
+        }
+        if (order < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return false;
+}
+
+bool TermArchive::hasCompleted(string_view username, string_view code) const {
+    bool found = false;
+    forEachCourse(username, [&found, code](string_view taken, int) {
+        if (taken == code) found = true;
+    });
+    return found;
+}
@@ -0,0 +1,110 @@
+#ifndef TERM_ARCHIVE_H
+#define TERM_ARCHIVE_H
+
+#include "EnrollmentFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// Sealed record of a closed term (term_<name>.dat): which courses each
+// student completed. Written once when the term closes and never changed.
+// Every table is fixed width and sorted by key, so the file is memory-mapped
+// and searched in place; opening it reads nothing but the header.
+//
+// File layout (little-endian uint32 after the magic):
+//   "CRSTERM1" studentCount courseCount enrollmentCount termOffset termLength
+//   courses:  courseCount x {codeOffset codeLength creditHours}, sorted by code
+//   students: studentCount x {nameOffset nameLength firstCourse courseCount}, sorted by name
+//   course lists: enrollmentCount x course index, ascending within each student
+//   strings: the term name, course codes and usernames (offsets are from the file start)
+
+// Which terms exist: one name per line in terms.txt, oldest first; the last is the active term
+const char* const TERMS_FILE = "terms.txt";
+
+string termArchivePath(const string& term);
+
+// Term names become file names, so they are limited to letters, digits, '-' and '_'
+bool isValidTermName(const string& term);
+
+// Names of every archive terms.txt lists, for copying a data directory whole
+vector<string> termArchiveFiles();
+
+class TermArchive {
+private:
+    static const size_t HEADER_SIZE = 28; // Magic and five fields
+    static const size_t COURSE_ENTRY = 12;
+    static const size_t STUDENT_ENTRY = 16;
+
+    string name;
+    const char* data;
+    size_t size;
+    bool mapped; // Otherwise data points into buffer
+    string buffer;
+    bool valid;
+    uint32_t students;
+    uint32_t courses;
+    uint32_t enrollments;
+
+    uint32_t field(size_t offset) const;
+    string_view text(size_t offset, size_t length) const; // Empty if out of bounds
+    bool findStudent(string_view username, uint32_t& first, uint32_t& count) const;
+
+    template <typename Func>
+    void visitCourses(uint32_t first, uint32_t count, Func visit) const {
+        size_t lists = HEADER_SIZE + COURSE_ENTRY * static_cast<size_t>(courses) +
+                       STUDENT_ENTRY * static_cast<size_t>(students);
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t course = field(lists + 4 * (static_cast<size_t>(first) + i));
+            if (course >= courses) return;
+            size_t entry = HEADER_SIZE + COURSE_ENTRY * static_cast<size_t>(course);
+            visit(text(field(entry), field(entry + 4)), static_cast<int>(field(entry + 8)));
+        }
+    }
+
+public:
+    // Writes to a temporary name and renames, so a crash never leaves half an archive.
+    // creditHours runs parallel to groups.courseCodes.
+    static bool write(const string& path, const string& term, const EnrollmentGroups& groups,
+                      const vector<int>& creditHours);
+
+    // Opens termArchivePath(term); a missing or damaged file leaves it invalid, holding nothing
+    explicit TermArchive(const string& term);
+    ~TermArchive();
+    TermArchive(const TermArchive&) = delete;
+    TermArchive& operator=(const TermArchive&) = delete;
+
+    bool isValid() const { return valid; }
+    bool isMapped() const { return mapped; }
+    size_t byteSize() const { return size; }
+    size_t studentCount() const { return students; }
+    size_t enrollmentCount() const { return enrollments; }
+    const string& term() const { return name; }
+
+    bool hasCompleted(string_view username, string_view code) const;
+
+    // Visits (code, creditHours) for each course the student completed, in code order
+    template <typename Func>
+    void forEachCourse(string_view username, Func visit) const {
+        uint32_t first, count;
+        if (findStudent(username, first, count)) visitCourses(first, count, visit);
+    }
+
+    // Visits (username, code) for every completion, in username then code order.
+    // The views point into the archive and last as long as it does.
+    template <typename Func>
+    void forEachCompletion(Func visit) const {
+        if (!valid) return;
+        size_t table = HEADER_SIZE + COURSE_ENTRY * static_cast<size_t>(courses);
+        for (uint32_t s = 0; s < students; s++) {
+            size_t entry = table + STUDENT_ENTRY * s;
+            uint32_t first = field(entry + 8), count = field(entry + 12);
+            if (static_cast<uint64_t>(first) + count > enrollments) return;
+            string_view username = text(field(entry), field(entry + 4));
+            visitCourses(first, count, [&](string_view code, int) { visit(username, code); });
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,194 @@
+#include "Trace.h"
+#include "System.h"
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
+using namespace std;
+
+const char* traceOpName(TraceOp op) {
+    static const char* const names[] = {
+        "login", "logout", "registerUser",
+        "viewAllCourses", "searchCourse", "enrollCourse", "dropCourse", "viewMyHistory", "undoLastAction",
+        "redoLastAction", "processPayment", "voidPayment", "viewPaymentStatus", "holdSeat", "confirmHold",
+        "releaseHold", "viewEligibleCourses", "viewDegreePlan", "submitPreferences", "viewPayments",
+        "addCourse", "deleteCourse", "updateCourse", "viewAllUsers", "deleteUser", "viewCourseEnrollments",
+        "viewAllEnrollments", "addPrerequisite", "retireDepartment", "removeCohort", "setHoldDuration",
+        "viewReplicationStatus", "viewStatistics", "setCreditLimits", "setRegistrationWindow",
+        "viewAdmissionMetrics", "openPreferenceRound", "runSeatLottery", "verifyLotteryAudit",
+        "importReconciliation", "viewMemoryReport", "closeTerm", "viewTermArchives", "viewTranscript",
+        "recountSeats", "exportEnrollments", "viewDepartmentStats", "viewCourseStats", "viewStudentStats"
+    };
+    static_assert(size(names) == static_cast<size_t>(TraceOp::Count), "every TraceOp needs a name");
+    return names[static_cast<int>(op)];
+}
+
+bool invokeTraceOp(CourseRegistrationSystem& sys, SessionToken& session, const TraceRecord& record) {
+    const vector<string>& a = record.args;
+    auto arg = [&a](size_t i) -> const string& {
+        static const string missing;
+        return i < a.size() ? a[i] : missing;
+    };
+
+    switch (record.op) {
+        case TraceOp::Login: {
+            Result<LoginSession> login = sys.login(arg(0), arg(1));
+            if (!login.ok()) return false;
+            session = login.value.token;
+            return true;
+        }
+        case TraceOp::Logout: sys.logout(session); break;
+        case TraceOp::RegisterUser: sys.registerUser(arg(0), arg(1), arg(2), arg(3)); break;
+        case TraceOp::ViewAllCourses: sys.listCourses(static_cast<CourseOrder>(stoi(arg(0)))); break;
+        case TraceOp::SearchCourse: sys.findCourse(arg(0)); break;
+        case TraceOp::EnrollCourse: sys.enrollCourse(session, arg(0)); break;
+        case TraceOp::DropCourse: sys.dropCourse(session, arg(0)); break;
+        case TraceOp::ViewMyHistory: sys.myEnrollments(session); break;
+        case TraceOp::UndoLastAction: sys.undoLastAction(session); break;
+        case TraceOp::RedoLastAction: sys.redoLastAction(session); break;
+        case TraceOp::ProcessPayment: sys.processPayment(session, arg(0), stod(arg(1))); break;
+        case TraceOp::VoidPayment: sys.voidPayment(session, arg(0)); break;
+        case TraceOp::ViewPaymentStatus: sys.paymentStatus(session, arg(0)); break;
+        case TraceOp::HoldSeat: sys.holdSeat(session, arg(0)); break;
+        case TraceOp::ConfirmHold: sys.confirmHold(session, arg(0)); break;
+        case TraceOp::ReleaseHold: sys.releaseHold(session, arg(0)); break;
+        case TraceOp::ViewEligibleCourses: sys.eligibleCourses(session); break;
+        case TraceOp::ViewDegreePlan: sys.degreePlan(session, arg(0), arg(1)); break;
+        case TraceOp::SubmitPreferences: sys.submitPreferences(session, a); break;
+        case TraceOp::ViewPayments: sys.paymentHistory(session, arg(0)); break;
+        case TraceOp::AddCourse: sys.addCourse(session, arg(0), arg(1), stoi(arg(2)), stoi(arg(3)), arg(4)); break;
+        case TraceOp::DeleteCourse: sys.deleteCourse(session, arg(0)); break;
+        case TraceOp::UpdateCourse:
+            sys.updateCourse(session, arg(0), arg(1), stoi(arg(2)), stoi(arg(3)), arg(4));
+            break;
+        case TraceOp::ViewAllUsers: sys.allUsers(session); break;
+        case TraceOp::DeleteUser: sys.deleteUser(session, arg(0)); break;
+        case TraceOp::ViewCourseEnrollments: sys.courseEnrollments(session, arg(0)); break;
+        case TraceOp::ViewAllEnrollments: sys.allEnrollments(session); break;
+        case TraceOp::AddPrerequisite: sys.addPrerequisite(session, arg(0), arg(1)); break;
+        case TraceOp::RetireDepartment: sys.retireDepartment(session, arg(0)); break;
+        case TraceOp::RemoveCohort: sys.removeCohort(session, arg(0)); break;
+        case TraceOp::SetHoldDuration: sys.setHoldDuration(session, stoi(arg(0))); break;
+        case TraceOp::ViewReplicationStatus: sys.replicationStatus(session); break;
+        case TraceOp::ViewStatistics: sys.statistics(session); break;
+        case TraceOp::SetCreditLimits: sys.setCreditLimits(session, stoi(arg(0)), stoi(arg(1))); break;
+        case TraceOp::SetRegistrationWindow: sys.setRegistrationWindow(session, arg(0), stoi(arg(1))); break;
+        case TraceOp::ViewAdmissionMetrics: sys.admissionMetrics(session); break;
+        case TraceOp::OpenPreferenceRound: sys.openPreferenceRound(session); break;
+        case TraceOp::RunSeatLottery: sys.runSeatLottery(session, stoull(arg(0))); break;
+        case TraceOp::VerifyLotteryAudit: sys.verifyLotteryAudit(session); break;
+        case TraceOp::ImportReconciliation: sys.importReconciliation(session, arg(0)); break;
+        case TraceOp::ViewMemoryReport: sys.memoryReport(session); break;
+        case TraceOp::CloseTerm: sys.closeTerm(session, arg(0)); break;
+        case TraceOp::ViewTermArchives: sys.termArchives(session); break;
+        case TraceOp::ViewTranscript: sys.transcript(session, arg(0)); break;
+        case TraceOp::RecountSeats: sys.recountSeats(session); break;
+        case TraceOp::ExportEnrollments: sys.exportEnrollments(session, arg(0)); break;
+        case TraceOp::ViewDepartmentStats: sys.departmentStatistics(session, arg(0)); break;
+        case TraceOp::ViewCourseStats: sys.courseStatistics(session, arg(0)); break;
+        case TraceOp::ViewStudentStats: sys.studentStatistics(session, arg(0)); break;
+        case TraceOp::Count: break;
+    }
+    return true;
+}
+
+namespace {
+
+struct CallTimes {
+    vector<double> micros;
+    int failed = 0;
+};
+
+// Restores the working directory however the replay ends
+struct ReplayScope {
+    filesystem::path savedDir;
+    filesystem::path scratchDir;
+
+    ReplayScope(const filesystem::path& scratch) : savedDir(filesystem::current_path()), scratchDir(scratch) {}
+
+    ~ReplayScope() {
+        error_code ignored;
+        filesystem::current_path(savedDir, ignored);
+        filesystem::remove_all(scratchDir, ignored);
+    }
+};
+
+}
+
+Result<ReplayReport> replayTrace(const string& path, bool paced) {
+    TraceReader reader(path);
+    if (!reader.isValid()) return Status::CannotOpenFile;
+
+    // The replay gets its own directory holding the recorded data files, so
+    // it starts from the same state and never touches the live ones
+    filesystem::path launchDir = filesystem::current_path();
+    filesystem::path scratch = filesystem::temp_directory_path() /
+        ("crs-replay-" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+    filesystem::create_directories(scratch);
+    ReplayScope scope(scratch);
+    for (const auto& [name, data] : reader.dataFiles) {
+        if (data.empty()) continue; // The file did not exist when recording started
+        ofstream file(scratch / filesystem::path(name).filename(), ios::binary);
+        file.write(data.data(), static_cast<streamsize>(data.size()));
+    }
+    filesystem::current_path(scratch);
+
+    ReplayReport report{paced, 0, 0, 0, 0, {}};
+    vector<CallTimes> timings(static_cast<size_t>(TraceOp::Count));
+    auto wallStart = chrono::steady_clock::now();
+    {
+        auto started = chrono::steady_clock::now();
+        CourseRegistrationSystem sys;
+        sys.seedData();
+        report.startupMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+
+        sys.setClock(0); // Replayed calls see the recorded time, not how fast they run
+        auto origin = chrono::steady_clock::now();
+        vector<SessionToken> sessions(1); // By trace number; 0 is no session
+        TraceRecord record;
+        while (reader.next(record)) {
+            if (paced) this_thread::sleep_until(origin + chrono::microseconds(record.atMicros));
+            sys.setClock(record.atMicros / 1e6);
+            // Files named in the trace were relative to where it was recorded
+            if ((record.op == TraceOp::ImportReconciliation || record.op == TraceOp::ExportEnrollments) &&
+                !record.args.empty() &&
+                filesystem::path(record.args[0]).is_relative()) {
+                record.args[0] = (launchDir / record.args[0]).string();
+            }
+            CallTimes& timing = timings[static_cast<size_t>(record.op)];
+            // Numbers are handed out in order, so a valid trace never skips ahead
+            if (record.session > sessions.size()) {
+                timing.failed++;
+                continue;
+            }
+            if (record.session == sessions.size()) sessions.emplace_back();
+            SessionToken& session = sessions[record.session];
+            auto callStart = chrono::steady_clock::now();
+            try {
+                bool loggedIn = invokeTraceOp(sys, session, record);
+                if (record.op == TraceOp::Login && loggedIn) report.sessions++;
+            } catch (const exception&) {
+                timing.failed++;
+                continue;
+            }
+            timing.micros.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - callStart).count());
+            report.replayed++;
+        }
+    }
+    report.wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - wallStart).count();
+
+    for (size_t op = 0; op < timings.size(); op++) {
+        vector<double>& micros = timings[op].micros;
+        if (micros.empty() && timings[op].failed == 0) continue;
+        sort(micros.begin(), micros.end());
+        double total = 0;
+        for (double m : micros) total += m;
+        auto percentile = [&micros](double p) {
+            return micros.empty() ? 0.0 : micros[static_cast<size_t>(p * (micros.size() - 1))];
+        };
+        report.ops.push_back({static_cast<TraceOp>(op), micros.size(), timings[op].failed, total / 1000,
+                              micros.empty() ? 0.0 : total / micros.size(), percentile(0.5), percentile(0.99),
+                              micros.empty() ? 0.0 : micros.back()});
+    }
+    return report;
+}
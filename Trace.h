@@ -0,0 +1,208 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "Results.h"
+#include "Session.h"
+#include "TermArchive.h"
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// Operation traces: CourseRegistrationSystem::startRecording() ("--record FILE"
+// in the console) captures every public API call, whichever front end makes
+// it; "--replay FILE" re-runs them against a fresh instance and times each one.
+//
+// File layout (all integers are LEB128 varints):
+//   "CRSTRACE" version
+//   fileCount, then per file: nameLength name dataLength data
+//     (the data files as they were when recording started)
+//   records until end of file: op microsSincePrevious session argCount, then per arg: length bytes
+// Times are on the system's clock (see setClock), which replay sets from them,
+// so holds, admission control and sessions see the same time passing.
+// session is 0 for calls made without one; each login that succeeded while
+// recording is numbered from 1, and the calls made with its token carry that
+// number. Version 1 traces have no session field and replay as one session.
+
+// Stored in traces by value: append new operations at the end
+enum class TraceOp : uint8_t {
+    Login, Logout, RegisterUser,
+    ViewAllCourses, SearchCourse, EnrollCourse, DropCourse, ViewMyHistory, UndoLastAction, RedoLastAction,
+    ProcessPayment, VoidPayment, ViewPaymentStatus, HoldSeat, ConfirmHold, ReleaseHold,
+    ViewEligibleCourses, ViewDegreePlan, SubmitPreferences, ViewPayments,
+    AddCourse, DeleteCourse, UpdateCourse, ViewAllUsers, DeleteUser, ViewCourseEnrollments, ViewAllEnrollments,
+    AddPrerequisite, RetireDepartment, RemoveCohort, SetHoldDuration, ViewReplicationStatus, ViewStatistics,
+    SetCreditLimits, SetRegistrationWindow, ViewAdmissionMetrics, OpenPreferenceRound, RunSeatLottery,
+    VerifyLotteryAudit, ImportReconciliation, ViewMemoryReport, CloseTerm, ViewTermArchives, ViewTranscript,
+    RecountSeats, ExportEnrollments, ViewDepartmentStats, ViewCourseStats, ViewStudentStats,
+    Count
+};
+
+const char* traceOpName(TraceOp op);
+
+struct TraceRecord {
+    TraceOp op;
+    uint64_t atMicros; // On the system clock, since recording started
+    uint32_t session;  // Numbered per trace; 0 for none
+    vector<string> args;
+};
+
+// Files a trace embeds so the replay starts from the same data (plus every term archive)
+const vector<string> TRACED_DATA_FILES = {"users.txt", "courses.txt", "enrollments.dat", "enrollments.txt",
+                                          "payments.txt", "prerequisites.txt", TERMS_FILE};
+
+class TraceWriter {
+private:
+    ofstream out;
+    uint64_t lastMicros;
+    HashTable<uint32_t> sessionNumbers; // Token -> number in this trace
+    uint32_t sessionCount;
+
+    void putVarint(uint64_t value) {
+        while (value >= 0x80) {
+            out.put(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.put(static_cast<char>(value));
+    }
+
+    void putString(const string& text) {
+        putVarint(text.size());
+        out.write(text.data(), static_cast<streamsize>(text.size()));
+    }
+
+public:
+    // Snapshots the data files as they are now
+    explicit TraceWriter(const string& path) : out(path, ios::binary | ios::trunc), lastMicros(0), sessionCount(0) {
+        out.write("CRSTRACE", 8);
+        putVarint(2);
+        vector<string> names = TRACED_DATA_FILES;
+        for (const string& archive : termArchiveFiles()) names.push_back(archive);
+        putVarint(names.size());
+        for (const string& name : names) {
+            ifstream file(name, ios::binary);
+            string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+            putString(name);
+            putString(data);
+        }
+    }
+
+    bool isOpen() const { return out.is_open(); }
+
+    // atMicros is when the call started
+    void write(TraceOp op, uint64_t atMicros, const SessionToken& session, const vector<string>& args) {
+        uint32_t number = 0;
+        if (!session.empty()) {
+            uint32_t* known = sessionNumbers.search(session);
+            if (known == nullptr) {
+                sessionNumbers.insert(session, ++sessionCount);
+                number = sessionCount;
+            } else {
+                number = *known;
+            }
+        }
+        out.put(static_cast<char>(op));
+        putVarint(atMicros - lastMicros);
+        putVarint(number);
+        putVarint(args.size());
+        for (const string& arg : args) putString(arg);
+        out.flush(); // A crash should still leave every call before it
+        lastMicros = atMicros;
+    }
+};
+
+class TraceReader {
+private:
+    ifstream in;
+    uint64_t lastMicros;
+    uint64_t version;
+    bool valid;
+
+    bool getVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int byte = in.get();
+            if (byte == EOF) return false;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool getString(string& text) {
+        uint64_t length;
+        if (!getVarint(length)) return false;
+        text.resize(length);
+        return static_cast<bool>(in.read(text.data(), static_cast<streamsize>(length)));
+    }
+
+public:
+    vector<pair<string, string>> dataFiles; // Name -> contents at recording time
+
+    explicit TraceReader(const string& path) : in(path, ios::binary), lastMicros(0), version(0), valid(false) {
+        char magic[8];
+        uint64_t fileCount;
+        if (!in.read(magic, 8) || string(magic, 8) != "CRSTRACE") return;
+        if (!getVarint(version) || version < 1 || version > 2 || !getVarint(fileCount)) return;
+        for (uint64_t i = 0; i < fileCount; i++) {
+            string name, data;
+            if (!getString(name) || !getString(data)) return;
+            dataFiles.emplace_back(std::move(name), std::move(data));
+        }
+        valid = true;
+    }
+
+    bool isValid() const { return valid; }
+
+    // False at the end of the trace or at a truncated last record
+    bool next(TraceRecord& record) {
+        int op = in.get();
+        uint64_t delta, session = 1, argCount;
+        if (op == EOF || op >= static_cast<int>(TraceOp::Count)) return false;
+        if (!getVarint(delta) || (version >= 2 && !getVarint(session)) || !getVarint(argCount)) return false;
+        if (session > UINT32_MAX) return false;
+        record.op = static_cast<TraceOp>(op);
+        record.atMicros = lastMicros += delta;
+        record.session = static_cast<uint32_t>(session);
+        record.args.resize(argCount);
+        for (string& arg : record.args) {
+            if (!getString(arg)) return false;
+        }
+        return true;
+    }
+};
+
+class CourseRegistrationSystem;
+
+// Calls the API method behind a record as session and drops the result.
+// A successful login stores its token in session; returns whether a login succeeded, true otherwise.
+bool invokeTraceOp(CourseRegistrationSystem& sys, SessionToken& session, const TraceRecord& record);
+
+struct OpTiming {
+    TraceOp op;
+    size_t calls;
+    int malformed; // Records whose arguments could not be parsed
+    double totalMs;
+    double meanMicros;
+    double p50Micros;
+    double p99Micros;
+    double maxMicros;
+};
+
+struct ReplayReport {
+    bool paced;
+    size_t replayed;
+    size_t sessions; // Logins that succeeded
+    double wallMs;
+    double startupMs; // Constructing and seeding the system
+    vector<OpTiming> ops; // Operations present in the trace, in TraceOp order
+};
+
+// Replays a trace in a scratch directory and times every call.
+// Paced replay waits for each call's original offset instead of running flat out.
+Result<ReplayReport> replayTrace(const string& path, bool paced);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef BENCH_SUPPORT_H
+#define BENCH_SUPPORT_H
+
+#include "TestSupport.h"
+#include <cstring>
+#include <iomanip>
+
+// Shared by the benchmarks. Each takes its size from the command line, or a
+// small one with --quick, which is how ctest runs them so they keep building
+// and working. Figures go to stdout; results are still checked, so a run
+// that goes wrong exits non-zero like a test.
+
+inline size_t benchSize(int argc, char** argv, size_t full, size_t quick) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) return quick;
+        if (argv[i][0] >= '0' && argv[i][0] <= '9') return stoull(argv[i]);
+    }
+    return full;
+}
+
+class Stopwatch {
+private:
+    chrono::steady_clock::time_point started;
+
+public:
+    Stopwatch() : started(chrono::steady_clock::now()) {}
+    double seconds() const { return chrono::duration<double>(chrono::steady_clock::now() - started).count(); }
+    void restart() { started = chrono::steady_clock::now(); }
+};
+
+// "label: 1.23 s, 456789 per second"
+inline void printRate(const string& label, double seconds, size_t count) {
+    cout << fixed << setprecision(3) << label << ": " << seconds << " s, " << setprecision(0)
+         << (seconds > 0 ? count / seconds : 0.0) << " per second\n" << defaultfloat << setprecision(6);
+}
+
+#endif
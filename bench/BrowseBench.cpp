@@ -0,0 +1,117 @@
+#include "BenchSupport.h"
+#include <atomic>
+#include <fstream>
+#include <random>
+#include <thread>
+
+// Catalog browsing from many threads at once. Each reader thread looks up
+// random codes with findCourse and lists the whole catalog now and then;
+// browsing only loads the published catalog and reads seat counters, so the
+// lookups per second should grow with the threads up to the core count. The
+// widest run is repeated while this thread keeps enrolling and dropping.
+// Usage: browse_bench [courses]
+
+static const int DEPARTMENTS = 40;
+static const int STUDENTS = 400;
+static const size_t LIST_EVERY = 1'000; // Lookups between full listings
+
+static string courseCode(size_t course) {
+    size_t department = course % DEPARTMENTS;
+    return string(1, char('A' + department / 26)) + char('A' + department % 26) + to_string(1000 + course / DEPARTMENTS);
+}
+
+// Written straight to the data files, like scaling_bench
+static void writeTerm(size_t courses) {
+    ofstream userFile("users.txt");
+    for (int i = 0; i < STUDENTS; i++) userFile << "s" << i << ",123,Student " << i << ",R-" << i << ",0\n";
+
+    ofstream courseFile("courses.txt");
+    for (size_t c = 0; c < courses; c++) courseFile << courseCode(c) << ",Course " << c << ",3,30,30,\n";
+    ofstream(TERMS_FILE) << DEFAULT_TERM << "\n";
+}
+
+struct BrowseRun {
+    double seconds;
+    size_t found;
+    bool torn; // A seat count outside 0..total; CHECK is not for other threads
+};
+
+static BrowseRun browse(CourseRegistrationSystem& sys, const vector<string>& codes, unsigned threads,
+                        size_t lookups, const function<void(const atomic<int>&)>& meanwhile) {
+    atomic<size_t> found(0);
+    atomic<bool> torn(false);
+    atomic<int> running(static_cast<int>(threads));
+    Stopwatch watch;
+    vector<thread> readers;
+    for (unsigned t = 0; t < threads; t++) {
+        readers.emplace_back([&, t] {
+            mt19937 random(t + 1);
+            size_t mine = 0;
+            for (size_t i = 1; i <= lookups; i++) {
+                optional<CourseView> course = sys.findCourse(codes[random() % codes.size()]);
+                if (course) {
+                    mine++;
+                    if (course->availableSeats < 0 || course->availableSeats > course->totalSeats) torn = true;
+                }
+                if (i % LIST_EVERY == 0 && sys.listCourses(CourseOrder::ByCode).size() != codes.size()) torn = true;
+            }
+            found += mine;
+            running--;
+        });
+    }
+    meanwhile(running);
+    for (thread& reader : readers) reader.join();
+    return {watch.seconds(), found, torn};
+}
+
+int main(int argc, char** argv) {
+    size_t courses = benchSize(argc, argv, 20'000, 1'000);
+    size_t lookups = courses < 10'000 ? 20'000 : 500'000; // Per thread
+    ScratchDirectory dir("browse-bench");
+    writeTerm(courses);
+
+    CourseRegistrationSystem sys;
+    sys.setClock(0);
+    vector<string> codes;
+    for (size_t c = 0; c < courses; c++) codes.push_back(courseCode(c));
+
+    // Past the core count too, so the run still overlaps readers on a small machine
+    unsigned maxThreads = max(4u, thread::hardware_concurrency());
+    cout << courses << " course(s), " << lookups << " lookup(s) per thread, 1.." << maxThreads << " thread(s)\n";
+    double single = 0;
+    auto idle = [](const atomic<int>&) {};
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        BrowseRun run = browse(sys, codes, threads, lookups, idle);
+        size_t total = threads * lookups;
+        if (threads == 1) single = total / run.seconds;
+        printRate("  " + to_string(threads) + " reader(s)", run.seconds, total);
+        cout << fixed << setprecision(2) << "    " << total / run.seconds / single << "x one reader\n" << defaultfloat;
+        CHECK_EQ(run.found, total);
+        CHECK(!run.torn);
+    }
+
+    // One writer alongside: students enroll and drop round-robin
+    vector<SessionToken> students;
+    for (int i = 0; i < STUDENTS; i++) students.push_back(loginAs(sys, "s" + to_string(i), "123"));
+    double clock = 0;
+    size_t changes = 0;
+    bool writesOk = true;
+    BrowseRun run = browse(sys, codes, maxThreads, lookups, [&](const atomic<int>& running) {
+        for (size_t i = 0; running > 0; i++) {
+            sys.setClock(clock += 0.025); // Inside admission control's 50 a second
+            const SessionToken& student = students[i % STUDENTS];
+            string code = codes[i % codes.size()];
+            writesOk = writesOk && sys.enrollCourse(student, code).ok();
+            sys.setClock(clock += 0.025);
+            writesOk = writesOk && sys.dropCourse(student, code).ok();
+            changes += 2;
+        }
+    });
+    size_t total = maxThreads * lookups;
+    printRate("  " + to_string(maxThreads) + " reader(s), one writer", run.seconds, total);
+    cout << "    " << changes << " enroll or drop call(s) meanwhile\n";
+    CHECK_EQ(run.found, total);
+    CHECK(!run.torn);
+    CHECK(writesOk);
+    return testResult();
+}
@@ -0,0 +1,88 @@
+#include "BenchSupport.h"
+#include <fstream>
+#include <random>
+
+// Course lookups by code. The same binary search over a sorted catalog, first
+// comparing code strings, then comparing fixed-width course keys (the probe
+// copied into a key once per lookup); then the department-sharded trees and
+// findCourse, which both compare keys. Codes share long prefixes, as in a big catalog, so
+// string compares walk several bytes before they differ.
+// Usage: catalog_bench [courses]
+
+static const int DEPARTMENTS = 40;
+
+static string courseCode(size_t course) {
+    static const char* const departments[] = {"COMP", "MATH", "PHYS", "CHEM", "ECON", "HIST", "BIOL", "ENGL"};
+    size_t department = course % DEPARTMENTS;
+    return departments[department % 8] + string(1, char('A' + department / 8)) + to_string(10000 + course / DEPARTMENTS);
+}
+
+template <typename Lookup>
+static size_t timeLookups(const string& label, const vector<string>& probes, Lookup lookup) {
+    size_t found = 0;
+    Stopwatch watch;
+    for (const string& code : probes) {
+        if (lookup(code)) found++;
+    }
+    printRate(label, watch.seconds(), probes.size());
+    return found;
+}
+
+int main(int argc, char** argv) {
+    size_t courses = benchSize(argc, argv, 100'000, 2'000);
+    size_t lookups = courses * 20;
+    mt19937 random(7);
+
+    vector<string> codes;
+    for (size_t c = 0; c < courses; c++) codes.push_back(courseCode(c));
+    // One probe in ten misses: a code past the end of its department
+    vector<string> probes;
+    size_t expected = 0;
+    for (size_t i = 0; i < lookups; i++) {
+        if (i % 10 == 9) {
+            probes.push_back(courseCode(courses + DEPARTMENTS * (1 + random() % 10)));
+        } else {
+            probes.push_back(codes[random() % courses]);
+            expected++;
+        }
+    }
+    cout << courses << " course(s), " << lookups << " lookup(s)\n";
+
+    vector<string> byString = codes;
+    sort(byString.begin(), byString.end());
+    size_t found = timeLookups("Sorted codes, string compare", probes, [&byString](const string& code) {
+        return binary_search(byString.begin(), byString.end(), code);
+    });
+    CHECK_EQ(found, expected);
+
+    vector<CourseKey> byKey;
+    for (const string& code : byString) byKey.push_back(CourseKey(code));
+    found = timeLookups("Sorted codes, course key", probes, [&byKey](const string& code) {
+        return binary_search(byKey.begin(), byKey.end(), CourseKey(code));
+    });
+    CHECK_EQ(found, expected);
+
+    // Inserted in shuffled order, as courses are added over the years
+    vector<string> shuffled = codes;
+    shuffle(shuffled.begin(), shuffled.end(), random);
+    ShardedCatalog catalog;
+    for (const string& code : shuffled) catalog.insert(Course(code, "Course", 3, 30));
+    found = timeLookups("ShardedCatalog::search", probes, [&catalog](const string& code) {
+        return catalog.search(code) != nullptr;
+    });
+    CHECK_EQ(found, expected);
+
+    ScratchDirectory dir("catalog-bench");
+    {
+        ofstream courseFile("courses.txt");
+        for (const string& code : shuffled) courseFile << code << ",Course " << code << ",3,30,30,\n";
+        ofstream(TERMS_FILE) << DEFAULT_TERM << "\n";
+    }
+    CourseRegistrationSystem sys;
+    sys.setClock(0);
+    found = timeLookups("findCourse", probes, [&sys](const string& code) {
+        return sys.findCourse(code).has_value();
+    });
+    CHECK_EQ(found, expected);
+    return testResult();
+}
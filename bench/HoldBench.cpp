@@ -0,0 +1,95 @@
+#include "BenchSupport.h"
+
+// Seat holds at scale. The expiry engine on its own: a million pending holds
+// in the timing wheel, spread over the 15-minute hold time, expired one tick
+// at a time, and as many cancelled (confirmed or released) instead. Then
+// holds through the API, as many as admission control lets in before the
+// first ones would lapse, all expiring at once.
+// Usage: hold_bench [holds]
+
+static const uint64_t HOLD_TICKS = 15 * 60;
+static const int COURSES = 10;
+
+static void benchWheel(size_t holds) {
+    TimingWheel<Enrollment> wheel;
+    vector<TimingWheel<Enrollment>::Timer*> timers;
+    timers.reserve(holds);
+    Stopwatch watch;
+    for (size_t i = 0; i < holds; i++) {
+        // Placed over the last 15 minutes, so they fall due evenly over the next
+        timers.push_back(wheel.schedule(Enrollment("s" + to_string(i % 100'000), "CS101"), 1 + i % HOLD_TICKS));
+    }
+    printRate("Schedule", watch.seconds(), holds);
+    CHECK_EQ(wheel.size(), static_cast<int>(holds));
+
+    watch.restart();
+    size_t expired = 0;
+    double slowestTick = 0;
+    for (uint64_t tick = 1; tick <= HOLD_TICKS; tick++) {
+        Stopwatch tickWatch;
+        wheel.advance(tick, [&expired](const Enrollment&) { expired++; });
+        slowestTick = max(slowestTick, tickWatch.seconds());
+    }
+    printRate("Expire, tick by tick", watch.seconds(), holds);
+    cout << fixed << setprecision(3) << "Slowest tick: " << slowestTick * 1000 << " ms for about "
+         << holds / HOLD_TICKS << " hold(s)\n" << defaultfloat;
+    CHECK_EQ(expired, holds);
+    CHECK_EQ(wheel.size(), 0);
+
+    timers.clear();
+    for (size_t i = 0; i < holds; i++) {
+        timers.push_back(wheel.schedule(Enrollment("s" + to_string(i % 100'000), "CS101"), HOLD_TICKS * 2 + i % HOLD_TICKS));
+    }
+    watch.restart();
+    for (TimingWheel<Enrollment>::Timer* timer : timers) wheel.cancel(timer);
+    printRate("Cancel", watch.seconds(), holds);
+    CHECK_EQ(wheel.size(), 0);
+}
+
+static void benchApi(size_t holds) {
+    ScratchDirectory dir("hold-bench");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    size_t students = (holds + COURSES - 1) / COURSES;
+    for (int c = 0; c < COURSES; c++) {
+        CHECK(sys.addCourse(admin, "HB" + to_string(100 + c), "Hold Seminar " + to_string(c), 1,
+                            static_cast<int>(students), "") == Status::Ok);
+    }
+    vector<SessionToken> sessions;
+    for (size_t s = 0; s < students; s++) {
+        string n = to_string(s);
+        CHECK(sys.registerUser("h" + n, "123", "Holder " + n, "H-" + n) == Status::Ok);
+        sessions.push_back(loginAs(sys, "h" + n, "123"));
+    }
+
+    // Admission lets 50 requests a second through; 40 a second stays clear of it
+    double clock = 0;
+    size_t placed = 0;
+    Stopwatch watch;
+    for (int c = 0; c < COURSES && placed < holds; c++) {
+        for (size_t s = 0; s < students && placed < holds; s++, placed++) {
+            sys.setClock(clock += 0.025);
+            CHECK(sys.holdSeat(sessions[s], "HB" + to_string(100 + c)).ok());
+        }
+    }
+    printRate("holdSeat", watch.seconds(), placed);
+    CHECK(clock < HOLD_TICKS); // Every hold is still pending
+
+    watch.restart();
+    sys.setClock(clock + HOLD_TICKS + 1); // The jump expires them all
+    printRate("Expire on the clock tick", watch.seconds(), placed);
+    optional<CourseView> course = sys.findCourse("HB100");
+    CHECK(course && course->availableSeats == static_cast<int>(students));
+}
+
+int main(int argc, char** argv) {
+    size_t holds = benchSize(argc, argv, 1'000'000, 5'000);
+    cout << "Timing wheel, " << holds << " pending hold(s)\n";
+    benchWheel(holds);
+    size_t apiHolds = min<size_t>(holds, 20'000);
+    cout << "Through the API, " << apiHolds << " hold(s)\n";
+    benchApi(apiHolds);
+    return testResult();
+}
@@ -0,0 +1,39 @@
+#include "BenchSupport.h"
+#include <fstream>
+
+// Nightly bank reconciliation: a file of new payments, then the same file
+// again with every other payment voided, so the second pass is half status
+// changes and half lines already matching.
+// Usage: import_bench [lines]
+
+static void writeLedger(const string& name, size_t lines, bool voidEveryOther) {
+    static const char* const payers[] = {"Ali", "Sara", "Anas", "Adil", "Amjad"};
+    ofstream file(name);
+    for (size_t i = 0; i < lines; i++) {
+        file << "BANK-" << i << "," << payers[i % 5] << "," << 100 + i % 900 << ","
+             << (voidEveryOther && i % 2 ? "Voided" : "Completed") << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t lines = benchSize(argc, argv, 100'000, 2'000);
+    ScratchDirectory dir("import-bench");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    writeLedger("new.csv", lines, false);
+    writeLedger("voids.csv", lines, true);
+
+    cout << "Importing " << lines << " bank line(s)\n";
+    Result<ReconciliationReport> first = sys.importReconciliation(admin, "new.csv");
+    CHECK(first.ok());
+    CHECK_EQ(first.value.added, static_cast<int>(lines));
+    printRate("New payments", first.value.seconds, lines);
+
+    Result<ReconciliationReport> second = sys.importReconciliation(admin, "voids.csv");
+    CHECK(second.ok());
+    CHECK_EQ(second.value.updated, static_cast<int>(lines / 2));
+    CHECK_EQ(second.value.unchanged, static_cast<int>(lines - lines / 2));
+    printRate("Status changes", second.value.seconds, lines);
+    return testResult();
+}
@@ -0,0 +1,101 @@
+#include "BenchSupport.h"
+#include <fstream>
+
+// Bytes written per operation under a mixed registration-day workload. Each
+// student in turn enrolls in two courses, holds a third, pays, drops the
+// first, confirms the hold and voids the payment; an admin edits a course
+// every 50 students. Only the tables a call changes are appended to or
+// rewritten, against a full save that would rewrite every data file.
+// Usage: persistence_bench [students]
+
+static const int COURSES = 20;
+
+// Everything this process has passed to write(2) so far, data files and journal
+// alike (Linux only; 0 elsewhere)
+static size_t bytesWritten() {
+    ifstream io("/proc/self/io");
+    string key;
+    size_t value = 0;
+    while (io >> key >> value) {
+        if (key == "wchar:") return value;
+    }
+    return 0;
+}
+
+static size_t dataFileBytes() {
+    size_t total = 0;
+    for (const string& name : TRACED_DATA_FILES) {
+        error_code missing;
+        size_t size = filesystem::file_size(name, missing);
+        if (!missing) total += size;
+    }
+    return total;
+}
+
+static string courseCode(int course) {
+    static const char* const departments[] = {"ART", "BIO", "CHEM", "ECON", "HIST"};
+    return departments[course % 5] + to_string(100 + course);
+}
+
+struct OpBytes {
+    const char* name;
+    size_t calls = 0;
+    size_t bytes = 0;
+};
+
+int main(int argc, char** argv) {
+    size_t students = benchSize(argc, argv, 2'000, 200);
+    ScratchDirectory dir("persistence-bench");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    for (int c = 0; c < COURSES; c++) {
+        CHECK(sys.addCourse(admin, courseCode(c), "Elective " + to_string(c), 3, static_cast<int>(students), "") ==
+              Status::Ok);
+    }
+    for (size_t s = 0; s < students; s++) {
+        string n = to_string(s);
+        CHECK(sys.registerUser("s" + n, "123", "Student " + n, "R-" + n) == Status::Ok);
+    }
+
+    OpBytes ops[] = {{"enrollCourse"}, {"holdSeat"}, {"processPayment"}, {"dropCourse"},
+                     {"confirmHold"}, {"voidPayment"}, {"updateCourse"}};
+    double clock = 0;
+    auto measure = [&sys, &clock](OpBytes& op, auto call) {
+        sys.setClock(++clock); // One call a second keeps every student inside the rate limit
+        size_t before = bytesWritten();
+        CHECK(call());
+        op.bytes += bytesWritten() - before;
+        op.calls++;
+    };
+
+    for (size_t s = 0; s < students; s++) {
+        SessionToken student = loginAs(sys, "s" + to_string(s), "123");
+        int c = static_cast<int>(s % COURSES);
+        string first = courseCode(c), second = courseCode((c + 1) % COURSES), held = courseCode((c + 2) % COURSES);
+        string transaction = "T-" + to_string(s);
+        measure(ops[0], [&] { return sys.enrollCourse(student, first).ok(); });
+        measure(ops[0], [&] { return sys.enrollCourse(student, second).ok(); });
+        measure(ops[1], [&] { return sys.holdSeat(student, held).ok(); });
+        measure(ops[2], [&] { return sys.processPayment(student, transaction, 500).ok(); });
+        measure(ops[3], [&] { return sys.dropCourse(student, first).ok(); });
+        measure(ops[4], [&] { return sys.confirmHold(student, held).ok(); });
+        measure(ops[5], [&] { return sys.voidPayment(student, transaction) == Status::Ok; });
+        if (s % 50 == 0) {
+            measure(ops[6], [&] { return sys.updateCourse(admin, first, "", 0, static_cast<int>(students) + 1, "").ok(); });
+        }
+        CHECK(sys.logout(student) == Status::Ok);
+    }
+
+    size_t calls = 0, bytes = 0;
+    cout << "Bytes written per call, " << students << " student(s):\n";
+    for (const OpBytes& op : ops) {
+        cout << "  " << op.name << ": " << (op.calls ? op.bytes / op.calls : 0) << " (" << op.calls << " call(s))\n";
+        calls += op.calls;
+        bytes += op.bytes;
+    }
+    cout << "Mixed workload: " << bytes / calls << " byte(s) per call\n";
+    cout << "Full save of every data file: " << dataFileBytes() << " byte(s)\n";
+    return testResult();
+}
@@ -0,0 +1,83 @@
+#include "BenchSupport.h"
+#include <fstream>
+
+// How the parallel admin jobs scale with the pool: the seat recount (one task
+// per department shard), the enrollment report snapshot (one task per shard)
+// and the CSV export (one task per 4096 rows), each run with 1..N threads.
+// Usage: scaling_bench [students]
+
+static const int DEPARTMENTS = 32;
+static const int COURSES_PER_DEPARTMENT = 20;
+static const int COURSES_PER_STUDENT = 5;
+
+static string courseCode(int course) {
+    int department = course / COURSES_PER_DEPARTMENT;
+    return string(1, char('A' + department / 26)) + char('A' + department % 26) +
+           to_string(101 + course % COURSES_PER_DEPARTMENT);
+}
+
+// Written straight to the data files; registering this many students through
+// the API would take longer than the runs being measured
+static void writeTerm(size_t students) {
+    int courses = DEPARTMENTS * COURSES_PER_DEPARTMENT;
+    ofstream userFile("users.txt");
+    userFile << "admin,admin123,Administrator,ADMIN,1\n";
+    for (size_t i = 0; i < students; i++) userFile << "s" << i << ",123,Student " << i << ",R-" << i << ",0\n";
+
+    ofstream courseFile("courses.txt");
+    size_t seats = students * COURSES_PER_STUDENT / courses + 10;
+    for (int c = 0; c < courses; c++) {
+        courseFile << courseCode(c) << ",Course " << c << ",3," << seats << "," << seats << ",\n";
+    }
+
+    ofstream enrollFile("enrollments.txt");
+    for (size_t i = 0; i < students; i++) {
+        for (int k = 0; k < COURSES_PER_STUDENT; k++) {
+            enrollFile << "s" << i << "," << courseCode(static_cast<int>((i * 7 + k * 131) % courses)) << "\n";
+        }
+    }
+    ofstream(TERMS_FILE) << DEFAULT_TERM << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t students = benchSize(argc, argv, 100'000, 2'000);
+    ScratchDirectory dir("scaling-bench");
+    writeTerm(students);
+
+    Stopwatch load;
+    CourseRegistrationSystem sys;
+    printRate("Load (shared pool)", load.seconds(), students * COURSES_PER_STUDENT);
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken s0 = loginAs(sys, "s0", "123");
+
+    unsigned maxThreads = max(1u, thread::hardware_concurrency());
+    size_t rows = students * COURSES_PER_STUDENT;
+    cout << rows << " enrollment(s), " << DEPARTMENTS << " department(s), 1.." << maxThreads << " thread(s)\n";
+    string spare = courseCode(1); // s0 is not in it; enrolling and dropping forces a fresh snapshot
+    for (unsigned threads = 1; threads <= maxThreads; threads++) {
+        TaskPool pool(threads);
+        sys.setTaskPool(pool);
+        cout << "-- " << threads << " thread(s)\n";
+
+        Stopwatch watch;
+        Outcome recounted = sys.recountSeats(admin);
+        printRate("Recount seats", watch.seconds(), rows);
+        CHECK(recounted.ok());
+        CHECK_EQ(recounted.count, 0LL);
+
+        sys.setClock(threads);
+        CHECK(sys.enrollCourse(s0, spare).ok());
+        CHECK(sys.dropCourse(s0, spare).ok());
+        watch.restart();
+        Result<EnrollmentSnapshot> snapshot = sys.allEnrollments(admin);
+        printRate("Report snapshot", watch.seconds(), rows);
+        CHECK(snapshot.ok() && snapshot.value->size() == rows);
+
+        watch.restart();
+        Outcome exported = sys.exportEnrollments(admin, "export.csv");
+        printRate("CSV export", watch.seconds(), rows);
+        CHECK_EQ(exported.count, static_cast<long long>(rows));
+    }
+    return testResult();
+}
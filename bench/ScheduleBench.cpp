@@ -0,0 +1,108 @@
+#include "BenchSupport.h"
+#include <fstream>
+#include <random>
+
+// Students filling their week from a large catalog. Every course is a
+// one-credit course meeting for an hour on one to three days, so a full load
+// of 18 credits is 18 courses. Each round, every student still short of the
+// limit tries one random course, until all are full or out of tries; most
+// tries late in a week clash. Enrollments and rejected clashes are timed
+// apart, since a rejection writes nothing. Before the clash check comes the
+// duplicate check, which scans the course's department, so the courses are
+// spread over departments as in a real catalog.
+// Usage: schedule_bench [students]
+
+static const int MAX_TRIES = 200;
+static const int DEPARTMENTS = 40;
+
+static string courseCode(size_t course) {
+    size_t department = course % DEPARTMENTS;
+    return string(1, char('A' + department / 26)) + char('A' + department % 26) + to_string(1000 + course / DEPARTMENTS);
+}
+
+static string randomTimes(mt19937& random) {
+    string days;
+    for (int day = 0; day < SCHEDULE_DAYS; day++) {
+        if (random() % 5 < 2) days += SCHEDULE_DAY_LETTERS[day]; // Two days a week on average
+    }
+    if (days.empty()) days = SCHEDULE_DAY_LETTERS[random() % SCHEDULE_DAYS];
+    int hour = SCHEDULE_FIRST_HOUR + static_cast<int>(random() % SCHEDULE_HOURS);
+    return days + " " + to_string(hour) + "-" + to_string(hour + 1);
+}
+
+// Written straight to the data files, like scaling_bench
+static void writeTerm(size_t students, size_t courses, mt19937& random) {
+    ofstream userFile("users.txt");
+    userFile << "admin,admin123,Administrator,ADMIN,1\n";
+    for (size_t i = 0; i < students; i++) userFile << "s" << i << ",123,Student " << i << ",R-" << i << ",0\n";
+
+    ofstream courseFile("courses.txt");
+    size_t seats = students + 10;
+    for (size_t c = 0; c < courses; c++) {
+        courseFile << courseCode(c) << ",Seminar " << c << ",1," << seats << "," << seats << "," << randomTimes(random) << "\n";
+    }
+    ofstream(TERMS_FILE) << DEFAULT_TERM << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t students = benchSize(argc, argv, 2'000, 100);
+    size_t courses = max<size_t>(1'000, students * 10);
+    mt19937 random(11);
+    ScratchDirectory dir("schedule-bench");
+    writeTerm(students, courses, random);
+
+    CourseRegistrationSystem sys;
+    sys.setClock(0);
+    vector<SessionToken> sessions;
+    for (size_t i = 0; i < students; i++) sessions.push_back(loginAs(sys, "s" + to_string(i), "123"));
+    cout << students << " student(s), " << courses << " course(s)\n";
+
+    vector<int> credits(students, 0), tries(students, 0);
+    size_t enrolled = 0, clashes = 0, other = 0;
+    double enrollSeconds = 0, clashSeconds = 0;
+    double clock = 0;
+    bool anyLeft = true;
+    while (anyLeft) {
+        anyLeft = false;
+        double roundStarted = clock;
+        for (size_t s = 0; s < students; s++) {
+            if (credits[s] >= 18 || tries[s] >= MAX_TRIES) continue;
+            anyLeft = true;
+            tries[s]++;
+            sys.setClock(clock += 0.025); // Inside admission control's 50 a second
+            Stopwatch watch;
+            Outcome outcome = sys.enrollCourse(sessions[s], courseCode(random() % courses));
+            double seconds = watch.seconds();
+            if (outcome.ok()) {
+                enrolled++;
+                enrollSeconds += seconds;
+                credits[s]++;
+            } else if (outcome.status == Status::ScheduleConflict) {
+                clashes++;
+                clashSeconds += seconds;
+            } else {
+                CHECK(outcome.status == Status::AlreadyEnrolled); // Drew a course it already takes
+                other++;
+            }
+        }
+        // Each student calls once a round, so a round must last the per-user limit's second
+        clock = max(clock, roundStarted + 1);
+    }
+
+    printRate("Enrollments", enrollSeconds, enrolled);
+    printRate("Rejected clashes", clashSeconds, clashes);
+    size_t full = static_cast<size_t>(count(credits.begin(), credits.end(), 18));
+    cout << full << " of " << students << " student(s) reached 18 credits; " << other << " repeat draw(s)\n";
+
+    // The fuller the week, the more draws clash; each student's courses never overlap
+    for (size_t s = 0; s < students; s++) {
+        Result<StudentRecord> mine = sys.myEnrollments(sessions[s]);
+        CHECK(mine.ok() && mine.value.creditHours == credits[s]);
+        uint64_t busy = 0;
+        for (const CourseView& course : mine.value.courses) {
+            CHECK((busy & course.timeSlots) == 0);
+            busy |= course.timeSlots;
+        }
+    }
+    return testResult();
+}
@@ -0,0 +1,75 @@
+#include "BenchSupport.h"
+#include <fstream>
+#include <random>
+
+// What finding the caller costs on every call, with thousands of sessions
+// open at once. The session table on its own at growing sizes, where a lookup
+// should cost the same however many sessions there are; then the same
+// through the system, token to User record, for every student logged in.
+// Usage: session_bench [sessions]
+
+static void benchTable(size_t sessions, size_t lookups, mt19937& random) {
+    SessionTable table;
+    vector<SessionToken> tokens;
+    Stopwatch watch;
+    for (size_t i = 0; i < sessions; i++) tokens.push_back(table.open("s" + to_string(i), 0));
+    printRate("  open", watch.seconds(), sessions);
+    CHECK_EQ(table.size(), static_cast<int>(sessions));
+
+    watch.restart();
+    size_t found = 0;
+    for (size_t i = 0; i < lookups; i++) {
+        if (table.touch(tokens[random() % sessions], 1) != nullptr) found++;
+    }
+    printRate("  touch", watch.seconds(), lookups);
+    CHECK_EQ(found, lookups);
+
+    watch.restart();
+    for (size_t i = 0; i < lookups; i++) {
+        if (table.touch("0123456789abcdef0123456789abcdef", 1) != nullptr) found++; // Never issued
+    }
+    printRate("  touch, unknown token", watch.seconds(), lookups);
+    CHECK_EQ(found, lookups);
+
+    watch.restart();
+    table.expire(1 + SessionTable::DEFAULT_IDLE_SECONDS + 1); // Every session has idled out
+    printRate("  expire all", watch.seconds(), sessions);
+    CHECK_EQ(table.size(), 0);
+}
+
+int main(int argc, char** argv) {
+    size_t sessions = benchSize(argc, argv, 100'000, 2'000);
+    size_t lookups = 1'000'000;
+    if (sessions < 10'000) lookups = 50'000;
+    mt19937 random(5);
+
+    for (size_t size = 1'000; size <= sessions; size *= 10) {
+        cout << "Session table, " << size << " session(s)\n";
+        benchTable(size, lookups, random);
+    }
+
+    // Written straight to the data files, like scaling_bench
+    ScratchDirectory dir("session-bench");
+    {
+        ofstream userFile("users.txt");
+        for (size_t i = 0; i < sessions; i++) userFile << "s" << i << ",123,Student " << i << ",R-" << i << ",0\n";
+        ofstream(TERMS_FILE) << DEFAULT_TERM << "\n";
+    }
+    CourseRegistrationSystem sys;
+    sys.setClock(0);
+    vector<SessionToken> tokens;
+    Stopwatch watch;
+    for (size_t i = 0; i < sessions; i++) tokens.push_back(loginAs(sys, "s" + to_string(i), "123"));
+    cout << "Through the system, " << sessions << " student(s) logged in\n";
+    printRate("  login", watch.seconds(), sessions);
+
+    watch.restart();
+    size_t matched = 0;
+    for (size_t i = 0; i < lookups; i++) {
+        size_t s = random() % sessions;
+        if (sys.sessionUsername(tokens[s]).size() == 1 + to_string(s).size()) matched++;
+    }
+    printRate("  sessionUsername", watch.seconds(), lookups);
+    CHECK_EQ(matched, lookups);
+    return testResult();
+}
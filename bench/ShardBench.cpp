@@ -0,0 +1,139 @@
+#include "BenchSupport.h"
+#include "ShardRouter.h"
+#include <fstream>
+
+// Registration throughput with the catalog split across worker processes.
+// Every student enrolls in a few courses, one round at a time, each round
+// sent through the router as one batch. Run first in a single process for
+// reference, then with 1, 2, 4... workers; more workers serve a batch side by
+// side, so the rate should climb up to the core count. A quarter of the
+// courses need a course from another department, looked up in its own shard.
+// Usage: shard_bench [students]
+
+static const int DEPARTMENTS = 16;
+static const int COURSES_PER_DEPARTMENT = 25;
+static const int ROUNDS = 4; // Courses per student
+
+static string courseCode(int course) {
+    int department = course % DEPARTMENTS;
+    return string(1, char('A' + department / 26)) + char('A' + department % 26) + to_string(101 + course / DEPARTMENTS);
+}
+
+static int courseCount() {
+    return DEPARTMENTS * COURSES_PER_DEPARTMENT;
+}
+
+// Written straight to the data files, like scaling_bench. Every student
+// completed course 0 of each department last term, so every crossing
+// prerequisite is met.
+static void writeTerm(size_t students) {
+    ofstream userFile("users.txt");
+    for (size_t i = 0; i < students; i++) userFile << "s" << i << ",123,Student " << i << ",R-" << i << ",0\n";
+
+    ofstream courseFile("courses.txt");
+    size_t seats = students * ROUNDS / courseCount() + 10;
+    for (int c = 0; c < courseCount(); c++) courseFile << courseCode(c) << ",Course " << c << ",3," << seats << "," << seats << ",\n";
+
+    ofstream prereqFile("prerequisites.txt");
+    for (int c = DEPARTMENTS; c < courseCount(); c += 4) prereqFile << courseCode(c) << "," << courseCode((c + 1) % DEPARTMENTS) << "\n";
+
+    EnrollmentGroups completed;
+    for (int d = 0; d < DEPARTMENTS; d++) completed.courseCodes.push_back(courseCode(d));
+    sort(completed.courseCodes.begin(), completed.courseCodes.end());
+    for (size_t i = 0; i < students; i++) completed.usernames.push_back("s" + to_string(i));
+    sort(completed.usernames.begin(), completed.usernames.end());
+    vector<uint32_t> all(DEPARTMENTS);
+    for (int d = 0; d < DEPARTMENTS; d++) all[d] = static_cast<uint32_t>(d);
+    completed.courseIds.assign(students, all);
+    CHECK(TermArchive::write(termArchivePath("LAST"), "LAST", completed, vector<int>(DEPARTMENTS, 3)));
+    ofstream(TERMS_FILE) << "LAST\n" << DEFAULT_TERM << "\n";
+}
+
+// Student i's course in round k, never course 0 of a department
+static string roundCourse(size_t student, int round) {
+    int pick = static_cast<int>((student * 7 + round * 131) % (courseCount() - DEPARTMENTS));
+    return courseCode(DEPARTMENTS + pick);
+}
+
+// Admission control lets each process take 50 requests at once and 50 a
+// second after that, so a round goes out in batches of at most 50 per process
+// with the clock a second further on for each batch. Each student is in a
+// round once, well inside the per-student limit.
+static vector<vector<size_t>> admissionBatches(size_t students, int round, int processes,
+                                               const function<int(const string&)>& processOf) {
+    vector<vector<size_t>> perProcess(processes);
+    for (size_t i = 0; i < students; i++) perProcess[processOf(roundCourse(i, round))].push_back(i);
+    vector<vector<size_t>> batches;
+    for (size_t taken = 0;; taken += 50) {
+        vector<size_t> batch;
+        for (const vector<size_t>& queue : perProcess) {
+            for (size_t k = taken; k < min(queue.size(), taken + 50); k++) batch.push_back(queue[k]);
+        }
+        if (batch.empty()) return batches;
+        batches.push_back(std::move(batch));
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t students = benchSize(argc, argv, 20'000, 400);
+    ScratchDirectory dir("shard-bench");
+    writeTerm(students);
+    size_t requests = students * ROUNDS;
+    cout << students << " student(s), " << courseCount() << " course(s) in " << DEPARTMENTS << " department(s), "
+         << requests << " enrollment(s)\n";
+
+    double single;
+    {
+        ScratchDirectory copy("shard-bench-single");
+        for (const auto& entry : filesystem::directory_iterator(dir.path())) {
+            filesystem::copy(entry.path(), copy.path() / entry.path().filename());
+        }
+        CourseRegistrationSystem sys;
+        vector<SessionToken> sessions;
+        for (size_t i = 0; i < students; i++) sessions.push_back(loginAs(sys, "s" + to_string(i), "123"));
+        size_t enrolled = 0;
+        double seconds = 0, clock = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            for (const vector<size_t>& batch : admissionBatches(students, round, 1, [](const string&) { return 0; })) {
+                sys.setClock(clock += 1);
+                Stopwatch watch;
+                for (size_t i : batch) {
+                    if (sys.enrollCourse(sessions[i], roundCourse(i, round)).ok()) enrolled++;
+                }
+                seconds += watch.seconds();
+            }
+        }
+        printRate("One process", seconds, requests);
+        single = seconds;
+        CHECK_EQ(enrolled, requests);
+    }
+
+    unsigned maxWorkers = max(4u, thread::hardware_concurrency());
+    for (unsigned workers = 1; workers <= maxWorkers; workers *= 2) {
+        ShardRouter router(static_cast<int>(workers)); // Each count splits the files afresh
+        vector<SessionToken> sessions;
+        for (size_t i = 0; i < students; i++) {
+            Result<SessionToken> login = router.login("s" + to_string(i), "123");
+            CHECK(login.ok());
+            sessions.push_back(login.value);
+        }
+        auto workerOf = [&router](const string& code) { return router.workerFor(code); };
+        size_t enrolled = 0;
+        double seconds = 0, clock = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            for (const vector<size_t>& indexes : admissionBatches(students, round, static_cast<int>(workers), workerOf)) {
+                router.setClock(clock += 1);
+                vector<ShardRouter::EnrollRequest> batch;
+                for (size_t i : indexes) batch.push_back({sessions[i], roundCourse(i, round)});
+                Stopwatch watch;
+                vector<Outcome> outcomes = router.enrollMany(batch);
+                seconds += watch.seconds();
+                for (const Outcome& outcome : outcomes) enrolled += outcome.ok() ? 1 : 0;
+            }
+        }
+        printRate("  " + to_string(workers) + " worker(s)", seconds, requests);
+        cout << fixed << setprecision(2) << "    " << single / seconds << "x one process\n" << defaultfloat;
+        CHECK_EQ(enrolled, requests);
+    }
+    return testResult();
+}
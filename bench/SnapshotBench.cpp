@@ -0,0 +1,104 @@
+#include "BenchSupport.h"
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+// Enrollment latency while a full report runs. The report pins the
+// enrollment snapshot and formats every row on a thread of its own, over and
+// over, while this thread keeps enrolling new students; the latencies are
+// compared with the same enrollments made with no report running.
+// Usage: snapshot_bench [students]
+
+static const int COURSES = 200;
+static const int COURSES_PER_STUDENT = 4;
+
+static string courseCode(int course) {
+    return string(1, char('A' + course / 26 % 26)) + char('A' + course % 26) + to_string(100 + course / 676);
+}
+
+// Written straight to the data files, like scaling_bench
+static void writeTerm(size_t students, size_t newcomers) {
+    ofstream userFile("users.txt");
+    userFile << "admin,admin123,Administrator,ADMIN,1\n";
+    for (size_t i = 0; i < students + newcomers; i++) userFile << "s" << i << ",123,Student " << i << ",R-" << i << ",0\n";
+
+    ofstream courseFile("courses.txt");
+    size_t seats = (students * COURSES_PER_STUDENT + newcomers) / COURSES + 10;
+    for (int c = 0; c < COURSES; c++) courseFile << courseCode(c) << ",Course " << c << ",3," << seats << "," << seats << ",\n";
+
+    ofstream enrollFile("enrollments.txt");
+    for (size_t i = 0; i < students; i++) {
+        for (int k = 0; k < COURSES_PER_STUDENT; k++) {
+            enrollFile << "s" << i << "," << courseCode(static_cast<int>((i + k * 37) % COURSES)) << "\n";
+        }
+    }
+    ofstream(TERMS_FILE) << DEFAULT_TERM << "\n";
+}
+
+static void printLatencies(const string& label, vector<double> micros) {
+    sort(micros.begin(), micros.end());
+    auto at = [&micros](double fraction) { return micros[min(micros.size() - 1, size_t(fraction * micros.size()))]; };
+    cout << fixed << setprecision(1) << label << ": p50 " << at(0.5) << " us, p99 " << at(0.99) << " us, max "
+         << micros.back() << " us\n" << defaultfloat;
+}
+
+int main(int argc, char** argv) {
+    size_t students = benchSize(argc, argv, 50'000, 2'000);
+    size_t newcomers = max<size_t>(200, students / 10);
+    ScratchDirectory dir("snapshot-bench");
+    writeTerm(students, newcomers);
+
+    CourseRegistrationSystem sys;
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    double clock = 0;
+    size_t next = students; // Newcomers enroll in order
+    auto enrollBatch = [&](size_t count) {
+        vector<double> micros;
+        for (size_t i = 0; i < count; i++, next++) {
+            sys.setClock(clock += 0.025); // Inside admission control's 50 a second
+            SessionToken student = loginAs(sys, "s" + to_string(next), "123");
+            string code = courseCode(static_cast<int>(next % COURSES));
+            Stopwatch watch;
+            CHECK(sys.enrollCourse(student, code).ok());
+            micros.push_back(watch.seconds() * 1e6);
+            CHECK(sys.logout(student) == Status::Ok);
+        }
+        return micros;
+    };
+
+    size_t rows = students * COURSES_PER_STUDENT;
+    cout << rows << " enrollment(s) in the report\n";
+    printLatencies("Enroll, no report", enrollBatch(newcomers / 2));
+
+    Result<EnrollmentSnapshot> pinned = sys.allEnrollments(admin);
+    CHECK(pinned.ok());
+    EnrollmentSnapshot snapshot = pinned.value;
+    size_t pinnedRows = snapshot->size();
+    atomic<bool> stop(false);
+    atomic<int> passes(0);
+    atomic<bool> moved(false); // CHECK is not for other threads
+    thread report([&snapshot, &stop, &passes, &moved, pinnedRows] {
+        while (!stop) {
+            ostringstream out;
+            size_t seen = 0;
+            for (const EnrollmentRow& row : *snapshot) {
+                out << row.fullName << "," << row.courseCode << "," << row.courseName << "\n";
+                seen++;
+            }
+            if (seen != pinnedRows) moved = true; // Enrollments made meanwhile never show up in it
+            passes++;
+        }
+    });
+    vector<double> during = enrollBatch(newcomers - newcomers / 2);
+    stop = true;
+    report.join();
+    printLatencies("Enroll, report running", during);
+    cout << passes << " full report pass(es) meanwhile\n";
+
+    CHECK(!moved && snapshot->size() == pinnedRows);
+    Result<EnrollmentSnapshot> fresh = sys.allEnrollments(admin);
+    CHECK(fresh.ok() && fresh.value->size() == pinnedRows + (newcomers - newcomers / 2));
+    return testResult();
+}
@@ -11,10 +11,17 @@
 */
 
 #include <iostream>
-#include "System.h"
+#include <sstream>
+#include "Console.h"
 
 using namespace std;
 
+// Runs the API call behind a menu action and prints what it returned
+bool call(CourseRegistrationSystem& sys, SessionToken& session, TraceOp op, const vector<string>& args = {}) {
+    sys.tick();
+    return runConsoleOp(sys, session, TraceRecord{op, 0, 0, args});
+}
+
 void displayMenu() {
     cout << "\n1. Login\n2. Register\n3. Exit\nChoice: ";
 }
@@ -25,11 +32,22 @@ void studentMenu() {
     cout << "2. View All Courses (Sort by Name)\n";
     cout << "3. Search Course\n";
     cout << "4. Enroll in Course\n";
-    cout << "5. View My History\n";
-    cout << "6. Undo Last Action\n";
-    cout << "7. Make Payment\n";
-    cout << "8. Check Payment Status\n";
-    cout << "9. Logout\n";
+    cout << "5. Drop Course\n";
+    cout << "6. View My History\n";
+    cout << "7. Undo Last Action\n";
+    cout << "8. Redo Last Action\n";
+    cout << "9. Make Payment\n";
+    cout << "10. Void Payment\n";
+    cout << "11. Check Payment Status\n";
+    cout << "12. Hold Seat\n";
+    cout << "13. Confirm Held Seat\n";
+    cout << "14. Release Held Seat\n";
+    cout << "15. View Eligible Courses\n";
+    cout << "16. Plan Path to Course\n";
+    cout << "17. Submit Course Preferences\n";
+    cout << "18. View My Payments\n";
+    cout << "19. View My Transcript\n";
+    cout << "20. Logout\n";
     cout << "Choice: ";
 }
 
@@ -47,15 +65,64 @@ void adminMenu() {
     cout << "10. View All Enrollments\n";
     cout << "11. Check Payment Status\n";
     cout << "12. Add Prerequisite\n";
-    cout << "13. Logout\n";
+    cout << "13. Retire Department\n";
+    cout << "14. Remove Student Cohort\n";
+    cout << "15. Set Seat Hold Duration\n";
+    cout << "16. Replication Status\n";
+    cout << "17. Registration Dashboard\n";
+    cout << "18. Set Credit Limits\n";
+    cout << "19. Degree Plan for Student\n";
+    cout << "20. Set Registration Window\n";
+    cout << "21. Admission Metrics\n";
+    cout << "22. Open Preference Round\n";
+    cout << "23. Run Seat Lottery\n";
+    cout << "24. Verify Lottery Audit\n";
+    cout << "25. View Student Payments\n";
+    cout << "26. Import Bank Reconciliation\n";
+    cout << "27. Memory Report\n";
+    cout << "28. Close Term\n";
+    cout << "29. Term Archives\n";
+    cout << "30. View Student Transcript\n";
+    cout << "31. Recount Seats\n";
+    cout << "32. Export Enrollments (CSV)\n";
+    cout << "33. Look Up Statistics\n";
+    cout << "34. Logout\n";
     cout << "Choice: ";
 }
 
-int main() {
-    CourseRegistrationSystem sys;
+int main(int argc, char* argv[]) {
+    // "--replica" starts a read-only instance that follows the primary's journal.
+    // "--record FILE" captures this session's API calls; "--replay FILE [--paced]"
+    // re-runs a captured session and prints per-operation timings.
+    bool replica = false;
+    string recordPath;
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "--replica") {
+            replica = true;
+        } else if (flag == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (flag == "--replay" && i + 1 < argc) {
+            bool paced = i + 2 < argc && string(argv[i + 2]) == "--paced";
+            return printReplay(argv[i + 1], replayTrace(argv[i + 1], paced));
+        }
+    }
+
+    CourseRegistrationSystem sys(replica);
     sys.seedData();
+    if (replica) {
+        cout << "Running as a read-only replica.\n";
+    }
+    if (!recordPath.empty()) {
+        if (sys.startRecording(recordPath) != Status::Ok) {
+            cout << "Cannot write trace " << recordPath << ".\n";
+            return 1;
+        }
+        cout << "Recording API calls to " << recordPath << ".\n";
+    }
 
     int choice;
+    SessionToken session; // Empty while nobody is logged in
     while (true) {
         displayMenu();
 
@@ -72,12 +139,17 @@ int main() {
             cout << "Username: "; cin >> u;
             cout << "Password: "; cin >> p;
 
-            if (sys.login(u, p)) {
+            if (call(sys, session, TraceOp::Login, {u, p})) {
                 int subChoice;
                 bool loggedIn = true;
 
                 while (loggedIn) {
-                    if (sys.isCurrentUserAdmin()) {
+                    string currentUsername = sys.sessionUsername(session);
+                    if (currentUsername.empty()) {
+                        cout << "Your session has expired. Please login again.\n";
+                        break;
+                    }
+                    if (sys.isAdmin(session)) {
                         // Admin menu
                         adminMenu();
 
@@ -89,65 +161,184 @@ int main() {
                         }
 
                         switch (subChoice) {
-                            case 1: sys.viewAllCourses(0); break;
-                            case 2: sys.viewAllCourses(1); break;
+                            case 1: call(sys, session, TraceOp::ViewAllCourses, {"0"}); break;
+                            case 2: call(sys, session, TraceOp::ViewAllCourses, {"1"}); break;
                             case 3: {
                                 string code;
                                 cout << "Enter Course Code: "; cin >> code;
-                                sys.searchCourse(code);
+                                call(sys, session, TraceOp::SearchCourse, {code});
                                 break;
                             }
                             case 4: {
-                                string code, name;
+                                string code, name, meetingTimes;
                                 int creditHours, totalSeats;
                                 cout << "Enter Course Code: "; cin >> code;
                                 cin.ignore();
                                 cout << "Enter Course Name: "; getline(cin, name);
                                 cout << "Enter Credit Hours: "; cin >> creditHours;
                                 cout << "Enter Total Seats: "; cin >> totalSeats;
-                                sys.addCourse(code, name, creditHours, totalSeats);
+                                cin.ignore();
+                                cout << "Enter Meeting Times (e.g. MWF 9-10;TR 13-15, blank for TBA): ";
+                                getline(cin, meetingTimes);
+                                call(sys, session, TraceOp::AddCourse, {code, name, to_string(creditHours), to_string(totalSeats), meetingTimes});
                                 break;
                             }
                             case 5: {
                                 string code;
                                 cout << "Enter Course Code to delete: "; cin >> code;
-                                sys.deleteCourse(code);
+                                call(sys, session, TraceOp::DeleteCourse, {code});
                                 break;
                             }
                             case 6: {
                                 string code;
                                 cout << "Enter Course Code to update: "; cin >> code;
-                                sys.updateCourse(code);
+                                if (!sys.hasCourse(code)) {
+                                    cout << "Course not found!\n";
+                                    break;
+                                }
+                                call(sys, session, TraceOp::SearchCourse, {code}); // Shows the current details
+
+                                string newName, newTimes;
+                                int newCreditHours, newTotalSeats;
+                                cin.ignore();
+                                cout << "\n--- Update Course ---\n";
+                                cout << "Enter new name (or press enter to keep): "; getline(cin, newName);
+                                cout << "Enter new credit hours (or 0 to keep): "; cin >> newCreditHours;
+                                cout << "Enter new total seats (or 0 to keep): "; cin >> newTotalSeats;
+                                cin.ignore();
+                                cout << "Enter new meeting times (or press enter to keep): "; getline(cin, newTimes);
+                                call(sys, session, TraceOp::UpdateCourse, {code, newName, to_string(newCreditHours),
+                                                                  to_string(newTotalSeats), newTimes});
                                 break;
                             }
-                            case 7: sys.viewAllUsers(); break;
+                            case 7: call(sys, session, TraceOp::ViewAllUsers); break;
                             case 8: {
                                 string username;
                                 cout << "Enter Username to delete: "; cin >> username;
-                                sys.deleteUser(username);
+                                call(sys, session, TraceOp::DeleteUser, {username});
                                 break;
                             }
                             case 9: {
                                 string code;
                                 cout << "Enter Course Code: "; cin >> code;
-                                sys.viewCourseEnrollments(code);
+                                call(sys, session, TraceOp::ViewCourseEnrollments, {code});
                                 break;
                             }
-                            case 10: sys.viewAllEnrollments(); break;
+                            case 10: call(sys, session, TraceOp::ViewAllEnrollments); break;
                             case 11: {
                                 string tid;
                                 cout << "Enter Transaction ID: "; cin >> tid;
-                                sys.viewPaymentStatus(tid);
+                                call(sys, session, TraceOp::ViewPaymentStatus, {tid});
                                 break;
                             }
                             case 12: {
                                 string course, prereq;
                                 cout << "Enter Course Code: "; cin >> course;
                                 cout << "Enter Prerequisite Course Code: "; cin >> prereq;
-                                sys.addPrerequisite(course, prereq);
+                                call(sys, session, TraceOp::AddPrerequisite, {course, prereq});
+                                break;
+                            }
+                            case 13: {
+                                string department;
+                                cout << "Enter Department Prefix (e.g. ENG): "; cin >> department;
+                                call(sys, session, TraceOp::RetireDepartment, {department});
+                                break;
+                            }
+                            case 14: {
+                                string prefix;
+                                cout << "Enter Roll No Prefix: "; cin >> prefix;
+                                call(sys, session, TraceOp::RemoveCohort, {prefix});
+                                break;
+                            }
+                            case 15: {
+                                int minutes;
+                                cout << "Enter Hold Duration (minutes): "; cin >> minutes;
+                                call(sys, session, TraceOp::SetHoldDuration, {to_string(minutes)});
+                                break;
+                            }
+                            case 16: call(sys, session, TraceOp::ViewReplicationStatus); break;
+                            case 17: call(sys, session, TraceOp::ViewStatistics); break;
+                            case 18: {
+                                int minHours, maxHours;
+                                cout << "Enter Minimum Credit Hours: "; cin >> minHours;
+                                cout << "Enter Maximum Credit Hours: "; cin >> maxHours;
+                                call(sys, session, TraceOp::SetCreditLimits, {to_string(minHours), to_string(maxHours)});
+                                break;
+                            }
+                            case 19: {
+                                string username, code;
+                                cout << "Enter Student Username: "; cin >> username;
+                                cout << "Enter Target Course Code: "; cin >> code;
+                                call(sys, session, TraceOp::ViewDegreePlan, {username, code});
+                                break;
+                            }
+                            case 20: {
+                                string prefix;
+                                int minutes;
+                                cout << "Enter Roll No Prefix: "; cin >> prefix;
+                                cout << "Opens in (minutes): "; cin >> minutes;
+                                call(sys, session, TraceOp::SetRegistrationWindow, {prefix, to_string(minutes)});
                                 break;
                             }
-                            case 13: sys.logout(); loggedIn = false; break;
+                            case 21: call(sys, session, TraceOp::ViewAdmissionMetrics); break;
+                            case 22: call(sys, session, TraceOp::OpenPreferenceRound); break;
+                            case 23: {
+                                unsigned long long seed;
+                                cout << "Enter Lottery Seed: "; cin >> seed;
+                                call(sys, session, TraceOp::RunSeatLottery, {to_string(seed)});
+                                break;
+                            }
+                            case 24: call(sys, session, TraceOp::VerifyLotteryAudit); break;
+                            case 25: {
+                                string username;
+                                cout << "Enter Student Username: "; cin >> username;
+                                call(sys, session, TraceOp::ViewPayments, {username});
+                                break;
+                            }
+                            case 26: {
+                                string filename;
+                                cout << "Enter Reconciliation File: "; cin >> filename;
+                                call(sys, session, TraceOp::ImportReconciliation, {filename});
+                                break;
+                            }
+                            case 27: call(sys, session, TraceOp::ViewMemoryReport); break;
+                            case 28: {
+                                string term;
+                                cout << "Enter Name of the Next Term: "; cin >> term;
+                                call(sys, session, TraceOp::CloseTerm, {term});
+                                break;
+                            }
+                            case 29: call(sys, session, TraceOp::ViewTermArchives); break;
+                            case 30: {
+                                string username;
+                                cout << "Enter Student Username: "; cin >> username;
+                                call(sys, session, TraceOp::ViewTranscript, {username});
+                                break;
+                            }
+                            case 31: call(sys, session, TraceOp::RecountSeats); break;
+                            case 32: {
+                                string filename;
+                                cout << "Enter Export File: "; cin >> filename;
+                                call(sys, session, TraceOp::ExportEnrollments, {filename});
+                                break;
+                            }
+                            case 33: {
+                                int kind;
+                                string key;
+                                cout << "1. Department  2. Course  3. Student\nChoice: "; cin >> kind;
+                                if (kind < 1 || kind > 3) {
+                                    cout << "Invalid choice.\n";
+                                    break;
+                                }
+                                cout << (kind == 1 ? "Enter Department Prefix (e.g. CS): "
+                                         : kind == 2 ? "Enter Course Code: " : "Enter Student Username: ");
+                                cin >> key;
+                                TraceOp op = kind == 1 ? TraceOp::ViewDepartmentStats
+                                             : kind == 2 ? TraceOp::ViewCourseStats : TraceOp::ViewStudentStats;
+                                call(sys, session, op, {key});
+                                break;
+                            }
+                            case 34: call(sys, session, TraceOp::Logout); loggedIn = false; break;
                             default: cout << "Invalid choice.\n";
                         }
                     } else {
@@ -162,41 +353,93 @@ int main() {
                         }
 
                         switch (subChoice) {
-                            case 1: sys.viewAllCourses(0); break;
-                            case 2: sys.viewAllCourses(1); break;
+                            case 1: call(sys, session, TraceOp::ViewAllCourses, {"0"}); break;
+                            case 2: call(sys, session, TraceOp::ViewAllCourses, {"1"}); break;
                             case 3: {
                                 string code;
                                 cout << "Enter Course Code: "; cin >> code;
-                                sys.searchCourse(code);
+                                call(sys, session, TraceOp::SearchCourse, {code});
                                 break;
                             }
                             case 4: {
                                 string code;
                                 cout << "Enter Course Code: "; cin >> code;
-                                sys.enrollCourse(code);
+                                call(sys, session, TraceOp::EnrollCourse, {code});
                                 break;
                             }
-                            case 5: sys.viewMyHistory(); break;
-                            case 6: sys.undoLastAction(); break;
-                            case 7: {
+                            case 5: {
+                                string code;
+                                cout << "Enter Course Code to drop: "; cin >> code;
+                                call(sys, session, TraceOp::DropCourse, {code});
+                                break;
+                            }
+                            case 6: call(sys, session, TraceOp::ViewMyHistory); break;
+                            case 7: call(sys, session, TraceOp::UndoLastAction); break;
+                            case 8: call(sys, session, TraceOp::RedoLastAction); break;
+                            case 9: {
                                 string tid;
                                 double amount;
                                 cout << "Enter Transaction ID: "; cin >> tid;
                                 cout << "Enter Amount: "; cin >> amount;
-                                sys.processPayment(tid, amount);
+                                call(sys, session, TraceOp::ProcessPayment, {tid, to_string(amount)});
                                 break;
                             }
-                            case 8: {
+                            case 10: {
+                                string tid;
+                                cout << "Enter Transaction ID to void: "; cin >> tid;
+                                call(sys, session, TraceOp::VoidPayment, {tid});
+                                break;
+                            }
+                            case 11: {
                                 string tid;
                                 cout << "Enter Transaction ID: "; cin >> tid;
-                                sys.viewPaymentStatus(tid);
+                                call(sys, session, TraceOp::ViewPaymentStatus, {tid});
+                                break;
+                            }
+                            case 12: {
+                                string code;
+                                cout << "Enter Course Code to hold: "; cin >> code;
+                                call(sys, session, TraceOp::HoldSeat, {code});
+                                break;
+                            }
+                            case 13: {
+                                string code;
+                                cout << "Enter Course Code to confirm: "; cin >> code;
+                                call(sys, session, TraceOp::ConfirmHold, {code});
+                                break;
+                            }
+                            case 14: {
+                                string code;
+                                cout << "Enter Course Code to release: "; cin >> code;
+                                call(sys, session, TraceOp::ReleaseHold, {code});
+                                break;
+                            }
+                            case 15: call(sys, session, TraceOp::ViewEligibleCourses); break;
+                            case 16: {
+                                string code;
+                                cout << "Enter Target Course Code: "; cin >> code;
+                                call(sys, session, TraceOp::ViewDegreePlan, {currentUsername, code});
+                                break;
+                            }
+                            case 17: {
+                                string line, code;
+                                vector<string> codes;
+                                cin.ignore(10000, '\n');
+                                cout << "Enter Course Codes, most wanted first (space separated): ";
+                                getline(cin, line);
+                                stringstream ss(line);
+                                while (ss >> code) codes.push_back(code);
+                                call(sys, session, TraceOp::SubmitPreferences, codes);
                                 break;
                             }
-                            case 9: sys.logout(); loggedIn = false; break;
+                            case 18: call(sys, session, TraceOp::ViewPayments, {currentUsername}); break;
+                            case 19: call(sys, session, TraceOp::ViewTranscript, {currentUsername}); break;
+                            case 20: call(sys, session, TraceOp::Logout); loggedIn = false; break;
                             default: cout << "Invalid choice.\n";
                         }
                     }
                 }
+                session.clear();
             } else {
                 cout << "Invalid credentials.\n";
             }
@@ -212,7 +455,7 @@ int main() {
             getline(cin, n);
             cout << "Roll No: ";
             cin >> r;
-            sys.registerUser(u, p, n, r);
+            call(sys, session, TraceOp::RegisterUser, {u, p, n, r});
         }
         else if (choice == 3) {
             cout << "Exiting system. Goodbye!\n";
@@ -0,0 +1,50 @@
+#include "TestSupport.h"
+#include "Admission.h"
+
+// The admission queue: earlier windows go first, then arrival order, and each
+// queued student is told to come back when the tokens for everyone ahead
+// of them and their own have refilled
+
+static void testRetryTimesFollowPlaceInLine() {
+    // One request per second system-wide, no burst
+    AdmissionController admission(1, 1, 5, 1, 10);
+    admission.setWindow("EARLY", 0);
+
+    CHECK(admission.admit("a", "LATE-1", 0).result == Admission::Admitted);
+    AdmissionDecision b = admission.admit("b", "LATE-2", 0);
+    CHECK(b.result == Admission::Queued);
+    CHECK_EQ(b.retryAt, 1.0);
+    CHECK_EQ(admission.admit("c", "LATE-3", 0).retryAt, 2.0);
+
+    // An earlier window goes ahead of everyone already queued
+    CHECK_EQ(admission.admit("d", "EARLY-1", 0).retryAt, 1.0);
+    CHECK_EQ(admission.admit("c", "LATE-3", 0.5).retryAt, 3.0);
+    CHECK_EQ(admission.queueDepth(), 3);
+
+    // Only the head is let in; the rest move up one place each
+    CHECK(admission.admit("b", "LATE-2", 1).result == Admission::Queued);
+    CHECK(admission.admit("d", "EARLY-1", 1).result == Admission::Admitted);
+    CHECK_EQ(admission.admit("c", "LATE-3", 1).retryAt, 3.0);
+    CHECK(admission.admit("b", "LATE-2", 2).result == Admission::Admitted);
+    CHECK(admission.admit("c", "LATE-3", 3).result == Admission::Admitted);
+    CHECK_EQ(admission.queueDepth(), 0);
+}
+
+static void testAbandonedTicketsLeaveTheLine() {
+    AdmissionController admission(1, 1, 5, 1, 10);
+    CHECK(admission.admit("a", "R-1", 0).result == Admission::Admitted);
+    CHECK_EQ(admission.admit("b", "R-2", 0).retryAt, 1.0);
+    CHECK_EQ(admission.admit("c", "R-3", 0).retryAt, 2.0);
+
+    // b never comes back; once its grace period is over c is at the head
+    CHECK(admission.admit("c", "R-3", 31.5).result == Admission::Admitted);
+    CHECK_EQ(admission.metrics().expired, 1LL);
+    CHECK_EQ(admission.queueDepth(), 0);
+    CHECK_EQ(admission.admit("e", "R-5", 31.5).retryAt, 32.5);
+}
+
+int main() {
+    testRetryTimesFollowPlaceInLine();
+    testAbandonedTicketsLeaveTheLine();
+    return testResult();
+}
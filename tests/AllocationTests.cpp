@@ -0,0 +1,103 @@
+#include "TestSupport.h"
+#include "MemoryTracking.h"
+
+// Built against crs_core_tracked, whose global new/delete count every
+// allocation. Pins how many allocations the hot calls make, and checks the
+// memory report's per-structure estimates against the live heap.
+
+template <typename Body>
+static size_t allocationsDuring(Body body) {
+    size_t before = heapCounters().totalAllocations;
+    body();
+    return heapCounters().totalAllocations - before;
+}
+
+// The limits are today's counts; a call that starts allocating more fails
+static void checkAllocations(const char* call, size_t made, size_t limit) {
+    if (made > limit) {
+        cerr << call << ": " << made << " allocation(s), limit " << limit << "\n";
+        checkFailures++;
+    }
+}
+
+static void testHotPathAllocations() {
+    ScratchDirectory dir("allocations");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(heapTrackingEnabled());
+    Course longest("COMPSCIENCE12345", "Course", 3, 30); // Past the small-string buffer
+
+    // The first round warms caches and sizes tables; the second is measured
+    for (int round = 0; round < 2; round++) {
+        sys.setClock(round * 10);
+        bool measured = round == 1;
+        auto pin = [measured](const char* call, size_t made, size_t limit) {
+            if (measured) checkAllocations(call, made, limit);
+        };
+
+        pin("findCourse", allocationsDuring([&] { CHECK(sys.findCourse("CS101")); }), 1); // The name outgrows SSO
+        pin("findCourse, unknown", allocationsDuring([&] { CHECK(!sys.findCourse("XX999")); }), 0);
+        pin("getCode", allocationsDuring([&] { CHECK(longest.getCode() == "COMPSCIENCE12345"); }), 0);
+        pin("sessionUsername", allocationsDuring([&] { CHECK(sys.sessionUsername(ali) == "Ali"); }), 0);
+        pin("listCourses", allocationsDuring([&] { CHECK_EQ(sys.listCourses(CourseOrder::ByCode).size(), size_t(6)); }), 9);
+        pin("myEnrollments", allocationsDuring([&] { CHECK(sys.myEnrollments(ali).ok()); }), 3);
+        pin("login and logout", allocationsDuring([&] {
+            Result<LoginSession> login = sys.login("Sara", "123");
+            CHECK(login.ok() && sys.logout(login.value.token) == Status::Ok);
+        }), 5);
+        // Enrolling links one node, indexes it, counts Ali into ENG's distinct students (a first course
+        // there), and appends one line to the enrollment file and one to the journal
+        pin("enrollCourse", allocationsDuring([&] { CHECK(sys.enrollCourse(ali, "ENG101").ok()); }), 7);
+        // Dropping appends a drop record rather than rewriting the enrollment file
+        pin("dropCourse", allocationsDuring([&] { CHECK(sys.dropCourse(ali, "ENG101").ok()); }), 6);
+        pin("holdSeat", allocationsDuring([&] { CHECK(sys.holdSeat(ali, "ENG101").ok()); }), 5);
+        pin("releaseHold", allocationsDuring([&] { CHECK(sys.releaseHold(ali, "ENG101").ok()); }), 2);
+    }
+}
+
+static MemoryStats reportTotal(CourseRegistrationSystem& sys, const SessionToken& admin) {
+    Result<MemoryReport> report = sys.memoryReport(admin);
+    CHECK(report.ok() && report.value.heapTracked);
+    MemoryStats total;
+    for (const auto& [name, stats] : report.value.rows) total += stats;
+    return total;
+}
+
+// What the report says the new records cost must be what the heap says they
+// cost: the same allocations, and the requested bytes plus one allocator
+// header per allocation
+static void testMemoryReportMatchesHeap() {
+    ScratchDirectory dir("memory-report");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken ali = loginAs(sys, "Ali", "123");
+
+    MemoryStats before = reportTotal(sys, admin);
+    HeapCounters heapBefore = heapCounters();
+    // Long enough that no string fits the small-string buffer
+    for (int i = 0; i < 2000; i++) {
+        string n = to_string(i);
+        CHECK(sys.registerUser("student-with-a-long-name-" + n, "a-long-password-" + n,
+                               "Full Name of Student Number " + n, "ROLL-NUMBER-0000-" + n) == Status::Ok);
+    }
+    for (int i = 0; i < 500; i++) {
+        CHECK(sys.processPayment(ali, "BANK-TRANSACTION-" + to_string(i), 100 + i).ok());
+    }
+    MemoryStats after = reportTotal(sys, admin);
+    HeapCounters heapAfter = heapCounters();
+
+    size_t allocations = after.allocations - before.allocations;
+    CHECK_EQ(allocations, heapAfter.liveAllocations - heapBefore.liveAllocations);
+    size_t estimated = (after.payloadBytes + after.overheadBytes) - (before.payloadBytes + before.overheadBytes);
+    CHECK_EQ(estimated, heapAfter.liveBytes - heapBefore.liveBytes + allocations * ALLOCATION_HEADER);
+}
+
+int main() {
+    testHotPathAllocations();
+    testMemoryReportMatchesHeap();
+    return testResult();
+}
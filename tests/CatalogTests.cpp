@@ -0,0 +1,183 @@
+#include "TestSupport.h"
+
+// Catalog administration: course updates keep seats, totals and enrolled
+// students consistent
+
+static void testSeatsCannotDropBelowTaken() {
+    ScratchDirectory dir("seats");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(sys.addCourse(admin, "CS150", "Discrete Structures", 3, 3, "TR 14-15") == Status::Ok);
+    CHECK(sys.enrollCourse(ali, "CS150").ok());
+    SessionToken sara = loginAs(sys, "Sara", "123");
+    CHECK(sys.holdSeat(sara, "CS150").ok());
+
+    // One enrolled and one held: two seats are taken
+    Outcome refused = sys.updateCourse(admin, "CS150", "", 0, 1, "");
+    CHECK(refused.status == Status::SeatsBelowTaken);
+    CHECK_EQ(refused.limit, 2LL);
+    CHECK_EQ(sys.findCourse("CS150")->totalSeats, 3);
+    CHECK_EQ(openSeats(sys, "CS150"), 1);
+
+    CHECK(sys.updateCourse(admin, "CS150", "", 0, 2, "").ok());
+    CHECK_EQ(openSeats(sys, "CS150"), 0);
+
+    // Once the hold lapses its seat no longer counts
+    sys.setClock(16 * 60);
+    CHECK(sys.updateCourse(admin, "CS150", "", 0, 1, "").ok());
+    CHECK_EQ(openSeats(sys, "CS150"), 0);
+    CHECK(sys.enrollCourse(sara, "CS150").status == Status::NoSeats);
+}
+
+// Listings come from the published snapshot; seats in it follow every
+// enrollment, hold and drop, and every catalog change is published at once
+static void testListingsFollowChanges() {
+    ScratchDirectory dir("listing");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(sys.addCourse(admin, "CS150", "Discrete Structures", 3, 3, "TR 14-15") == Status::Ok);
+
+    auto listed = [&sys](const string& code) {
+        for (const CourseView& course : sys.listCourses(CourseOrder::ByName)) {
+            if (course.code == code) return optional<CourseView>(course);
+        }
+        return optional<CourseView>();
+    };
+    CHECK(listed("CS150").has_value());
+    CHECK(sys.enrollCourse(ali, "CS150").ok());
+    CHECK_EQ(listed("CS150")->availableSeats, 2);
+    CHECK(sys.dropCourse(ali, "CS150").ok());
+    CHECK(sys.holdSeat(ali, "CS150").ok());
+    CHECK_EQ(listed("CS150")->availableSeats, 2);
+
+    CHECK(sys.updateCourse(admin, "CS150", "Discrete Math", 0, 5, "").ok());
+    CHECK_EQ(listed("CS150")->totalSeats, 5);
+    CHECK_EQ(listed("CS150")->availableSeats, 4);
+    CHECK_EQ(listed("CS150")->name, string("Discrete Math"));
+    CHECK(sys.addPrerequisite(admin, "CS150", "CS101") == Status::Ok);
+    CHECK(sys.findCourse("CS150")->prerequisites == vector<string>({"CS101"}));
+
+    // Deleted and added again, the course starts with its own seats
+    CHECK(sys.deleteCourse(admin, "CS150") == Status::Ok);
+    CHECK(!listed("CS150").has_value());
+    CHECK(!sys.findCourse("CS150").has_value());
+    CHECK(sys.addCourse(admin, "CS150", "Discrete Structures", 3, 3, "TR 14-15") == Status::Ok);
+    CHECK_EQ(openSeats(sys, "CS150"), 3);
+}
+
+// Removing a course cuts the edges on both sides of it, and the freed ID
+// comes back without any
+static void testRemovedCourseLeavesNoEdges() {
+    CourseIndex index;
+    for (const string code : {"A", "B", "C"}) {
+        index.add(code);
+        index.setOpen(code, true);
+    }
+    index.addPrerequisite("B", "A");
+    index.addPrerequisite("C", "A");
+    index.addPrerequisite("C", "B");
+    auto eligibleCodes = [&index]() {
+        vector<int> ids;
+        index.eligible({}, {}, ids);
+        vector<string> codes;
+        for (int id : ids) codes.push_back(index.codeOf(id));
+        return codes;
+    };
+    CHECK(eligibleCodes() == vector<string>{"A"});
+
+    index.remove("A");
+    CHECK(eligibleCodes() == vector<string>{"B"});
+    index.remove("B");
+    CHECK(eligibleCodes() == vector<string>{"C"});
+
+    // "D" takes A's old ID; C no longer lists it, and it lists nothing
+    index.add("D");
+    index.setOpen("D", true);
+    CHECK_EQ(eligibleCodes().size(), size_t(2));
+    index.addPrerequisite("D", "C");
+    index.remove("C");
+    CHECK(eligibleCodes() == vector<string>{"D"});
+}
+
+// A department counts a student once however many of its courses they take,
+// until they drop the last one
+static void testDepartmentCountsDistinctStudents() {
+    ScratchDirectory dir("department-stats");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    SessionToken anas = loginAs(sys, "Anas", "123");
+    CHECK(sys.addCourse(admin, "MATH201", "Linear Algebra", 3, 30, "TR 16-17") == Status::Ok);
+    Result<DepartmentStats> before = sys.departmentStatistics(admin, "MATH");
+    CHECK(before.ok());
+    auto changeSince = [&]() {
+        Result<DepartmentStats> now = sys.departmentStatistics(admin, "MATH");
+        return pair<int, int>(now.value.enrollments - before.value.enrollments,
+                              now.value.students - before.value.students);
+    };
+
+    CHECK(sys.enrollCourse(ali, "MATH201").ok()); // Ali already takes MATH101
+    CHECK((changeSince() == pair<int, int>(1, 0)));
+    CHECK(sys.enrollCourse(anas, "MATH101").ok());
+    CHECK((changeSince() == pair<int, int>(2, 1)));
+    CHECK(sys.dropCourse(ali, "MATH101").ok());
+    CHECK((changeSince() == pair<int, int>(1, 1)));
+    CHECK(sys.dropCourse(ali, "MATH201").ok());
+    CHECK((changeSince() == pair<int, int>(0, 0)));
+
+    // The per-key reads agree with the dashboard rows
+    Result<Dashboard> dashboard = sys.statistics(admin);
+    CHECK(dashboard.ok());
+    for (const auto& [department, stats] : dashboard.value.departments) {
+        Result<DepartmentStats> one = sys.departmentStatistics(admin, department);
+        CHECK(one.ok() && one.value.students == stats.students && one.value.enrollments == stats.enrollments);
+    }
+    Result<CourseFill> fill = sys.courseStatistics(admin, "MATH101");
+    CHECK(fill.ok() && fill.value.totalSeats - fill.value.enrolled == openSeats(sys, "MATH101"));
+    Result<StudentLoad> load = sys.studentStatistics(admin, "Anas");
+    CHECK(load.ok() && load.value.courses == 2);
+    CHECK(sys.departmentStatistics(admin, "ZZ").status == Status::NoMatches);
+    CHECK(sys.studentStatistics(admin, "admin").status == Status::StudentNotFound);
+    CHECK(sys.courseStatistics(ali, "MATH101").status == Status::AdminRequired);
+}
+
+// Keys order exactly as their codes do, and a code that the zero padding
+// would cut short at an embedded NUL is refused
+static void testCourseKeysMatchCodes() {
+    vector<string> codes = {"CS2", "CS101", "CS10", "COMPSCIENCE12345", "C", "MATH101", "COMPSCIENCE1234"};
+    for (const string& a : codes) {
+        CHECK(CourseKey(a).view() == a);
+        for (const string& b : codes) {
+            CHECK_EQ(CourseKey(a) < CourseKey(b), a < b);
+            CHECK_EQ(CourseKey(a) == CourseKey(b), a == b);
+        }
+    }
+    string withNul("CS\0" "101", 6);
+    CHECK(!CourseKey::fits(withNul));
+    CHECK(!CourseKey::fits(string(17, 'A')));
+
+    ScratchDirectory dir("course-keys");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    CHECK(sys.addCourse(admin, withNul, "Shadow", 3, 30, "") == Status::CourseCodeHasNul);
+    CHECK(sys.addCourse(admin, string(17, 'A'), "Long", 3, 30, "") == Status::CourseCodeTooLong);
+    CHECK(sys.findCourse(withNul) == nullopt);
+}
+
+int main() {
+    testSeatsCannotDropBelowTaken();
+    testCourseKeysMatchCodes();
+    testDepartmentCountsDistinctStudents();
+    testListingsFollowChanges();
+    testRemovedCourseLeavesNoEdges();
+    return testResult();
+}
@@ -0,0 +1,83 @@
+#include "TestSupport.h"
+
+// Seat holds must not outlive what they hold: deleting the student or the
+// course takes the hold and its expiry timer with it. Nor may a freed seat
+// count twice while holds are out.
+
+static void testDeletedStudentReturnsHeldSeat() {
+    ScratchDirectory dir("hold-user");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(sys.holdSeat(ali, "ENG101").ok());
+    CHECK_EQ(openSeats(sys, "ENG101"), 38);
+
+    CHECK(sys.deleteUser(admin, "Ali") == Status::Ok);
+    CHECK_EQ(openSeats(sys, "ENG101"), 39);
+
+    // A new account with the same name starts without the old hold
+    CHECK(sys.registerUser("Ali", "456", "Ali Again", "02-134242-101") == Status::Ok);
+    SessionToken again = loginAs(sys, "Ali", "456");
+    CHECK(sys.confirmHold(again, "ENG101").status == Status::NoHold);
+    CHECK(sys.holdSeat(again, "ENG101").ok());
+    CHECK_EQ(openSeats(sys, "ENG101"), 38);
+}
+
+static void testDeletedCourseDropsItsHolds() {
+    ScratchDirectory dir("hold-course");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(sys.addCourse(admin, "CS150", "Discrete Structures", 3, 1, "TR 14-15") == Status::Ok);
+    CHECK(sys.holdSeat(ali, "CS150").ok());
+    CHECK(sys.deleteCourse(admin, "CS150") == Status::Ok);
+
+    // The course comes back under the same code; the old hold and timer must not
+    sys.setClock(10 * 60);
+    CHECK(sys.addCourse(admin, "CS150", "Discrete Structures", 3, 1, "TR 14-15") == Status::Ok);
+    CHECK(sys.holdSeat(ali, "CS150").ok());
+    CHECK_EQ(openSeats(sys, "CS150"), 0);
+
+    // Past the first hold's expiry the second one still holds the seat
+    sys.setClock(16 * 60);
+    CHECK_EQ(openSeats(sys, "CS150"), 0);
+    CHECK(sys.confirmHold(ali, "CS150").ok());
+    CHECK(enrolledIn(sys, ali, "CS150"));
+}
+
+static void testRetiredDepartmentDropsItsHolds() {
+    ScratchDirectory dir("hold-retire");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(sys.holdSeat(ali, "ENG101").ok());
+    CHECK(sys.retireDepartment(admin, "ENG").ok());
+    CHECK(sys.releaseHold(ali, "ENG101").status == Status::NoHold);
+}
+
+// Every seat held: a drop the counts do not account for (data loaded
+// overbooked) must not free a seat on top of them
+static void testDropNeverOversellsHeldSeats() {
+    Course course("CS150", "Discrete Structures", 3, 2);
+    CHECK(course.holdSeat());
+    CHECK(course.holdSeat());
+    course.unenrollStudent();
+    CHECK_EQ(course.getAvailableSeats(), 0);
+    course.releaseHold();
+    CHECK_EQ(course.getAvailableSeats(), 1);
+    CHECK_EQ(course.getAvailableSeats() + course.getHeldSeats(), course.getTotalSeats());
+}
+
+int main() {
+    testDeletedStudentReturnsHeldSeat();
+    testDeletedCourseDropsItsHolds();
+    testRetiredDepartmentDropsItsHolds();
+    testDropNeverOversellsHeldSeats();
+    return testResult();
+}
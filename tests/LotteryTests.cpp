@@ -0,0 +1,80 @@
+#include "TestSupport.h"
+
+// The seat lottery: a seed fixes the outcome, every assignment it reports is
+// an enrollment on record, and the audit replays to the same digest
+
+static const char* const STUDENTS[] = {"Ali", "Sara", "Anas", "Adil", "Amjad"};
+
+// Five students rank a two-seat seminar over a roomy one; returns the
+// students who won the seminar
+static vector<string> runLottery(uint64_t seed, LotteryReport& report) {
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    CHECK(sys.addCourse(admin, "SEM100", "Small Seminar", 3, 2, "F 17-18") == Status::Ok);
+    CHECK(sys.addCourse(admin, "SEM200", "Large Seminar", 3, 10, "R 17-18") == Status::Ok);
+    CHECK(sys.openPreferenceRound(admin).ok());
+
+    vector<SessionToken> sessions;
+    for (const char* name : STUDENTS) {
+        sessions.push_back(loginAs(sys, name, "123"));
+        CHECK(sys.submitPreferences(sessions.back(), {"SEM100", "SEM200"}).ok());
+    }
+
+    Result<LotteryReport> run = sys.runSeatLottery(admin, seed);
+    CHECK(run.ok());
+    report = run.value;
+
+    vector<string> winners;
+    size_t enrolled = 0;
+    for (size_t i = 0; i < sessions.size(); i++) {
+        if (enrolledIn(sys, sessions[i], "SEM100")) winners.push_back(STUDENTS[i]);
+        enrolled += enrolledIn(sys, sessions[i], "SEM100") + enrolledIn(sys, sessions[i], "SEM200");
+    }
+    CHECK_EQ(report.assigned, enrolled);
+    CHECK_EQ(openSeats(sys, "SEM100"), 0);
+    CHECK_EQ(openSeats(sys, "SEM200"), 5);
+
+    Result<LotteryCheck> check = sys.verifyLotteryAudit(admin);
+    CHECK(check.ok());
+    CHECK_EQ(check.value.replayDigest, check.value.recordedDigest);
+    CHECK_EQ(check.value.recordedDigest, report.digest);
+    return winners;
+}
+
+static void testSameSeedSameOutcome() {
+    LotteryReport first, second;
+    vector<string> firstWinners, secondWinners;
+    {
+        ScratchDirectory dir("lottery-a");
+        firstWinners = runLottery(20261018, first);
+    }
+    {
+        ScratchDirectory dir("lottery-b");
+        secondWinners = runLottery(20261018, second);
+    }
+    CHECK_EQ(firstWinners.size(), size_t(2));
+    CHECK(firstWinners == secondWinners);
+    CHECK_EQ(first.digest, second.digest);
+    CHECK_EQ(first.assigned, size_t(7));
+    CHECK_EQ(first.refused, size_t(0));
+    CHECK_EQ(first.requested, 10);
+}
+
+// Seeds spread the seminar across students rather than always picking the same two
+static void testSeedsChangeTheDraw() {
+    vector<vector<string>> draws;
+    for (uint64_t seed = 1; seed <= 8; seed++) {
+        ScratchDirectory dir("lottery-seed");
+        LotteryReport report;
+        vector<string> winners = runLottery(seed, report);
+        if (find(draws.begin(), draws.end(), winners) == draws.end()) draws.push_back(winners);
+    }
+    CHECK(draws.size() > 1);
+}
+
+int main() {
+    testSameSeedSameOutcome();
+    testSeedsChangeTheDraw();
+    return testResult();
+}
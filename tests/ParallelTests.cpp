@@ -0,0 +1,105 @@
+#include "TestSupport.h"
+#include <fstream>
+#include <sstream>
+
+// Work spread over the task pool: a seat recount and an enrollment export
+// must come out the same whether one thread or several share the work
+
+static const char* const DEPARTMENTS[] = {"ART101", "BIO101", "CHEM101", "ECON101", "HIST101", "PHYS101"};
+static const int STUDENTS = 1500;
+
+// Enough rows that the export is cut into more than one chunk
+static void buildLargeTerm(CourseRegistrationSystem& sys) {
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    for (const char* code : DEPARTMENTS) {
+        CHECK(sys.addCourse(admin, code, string("Survey of ") + code, 3, 1000, "") == Status::Ok);
+    }
+    for (int i = 0; i < STUDENTS; i++) {
+        string username = "s" + to_string(i);
+        CHECK(sys.registerUser(username, "123", "Student " + to_string(i), "02-9-" + to_string(i)) == Status::Ok);
+        sys.setClock(i); // Clear of the per-student rate limit
+        SessionToken student = loginAs(sys, username, "123");
+        for (int k = 0; k < 3; k++) CHECK(sys.enrollCourse(student, DEPARTMENTS[(i + k) % 6]).ok());
+        CHECK(sys.logout(student) == Status::Ok);
+    }
+    CHECK(sys.registerUser("quoted", "123", "Khan, \"Omar\"", "02-9-quoted") == Status::Ok);
+    SessionToken quoted = loginAs(sys, "quoted", "123");
+    CHECK(sys.enrollCourse(quoted, "ENG101").ok());
+}
+
+static string readFile(const string& name) {
+    ifstream file(name, ios::binary);
+    stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+static void testExportMatchesAcrossPools() {
+    ScratchDirectory dir("export");
+    CourseRegistrationSystem sys;
+    buildLargeTerm(sys);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+
+    TaskPool single(1), several(4);
+    sys.setTaskPool(single);
+    Outcome serial = sys.exportEnrollments(admin, "serial.csv");
+    sys.setTaskPool(several);
+    Outcome parallel = sys.exportEnrollments(admin, "parallel.csv");
+    CHECK(serial.ok());
+    CHECK(parallel.ok());
+    CHECK_EQ(parallel.count, serial.count);
+    CHECK_EQ(parallel.count, 3LL * STUDENTS + 8); // Seven seed enrollments and the quoted student's
+    CHECK(readFile("parallel.csv") == readFile("serial.csv"));
+
+    string text = readFile("parallel.csv");
+    CHECK_EQ(text.rfind("Student,Course Code,Course Name\n", 0), size_t(0));
+    CHECK_EQ(static_cast<long long>(count(text.begin(), text.end(), '\n')), parallel.count + 1);
+    CHECK(text.find("\nAli Ahmed,CS101,Introduction to Programming\n") != string::npos);
+    CHECK(text.find("\n\"Khan, \"\"Omar\"\"\",ENG101,") != string::npos);
+
+    CHECK(sys.exportEnrollments(admin, "missing/dir/out.csv").status == Status::CannotOpenFile);
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(sys.exportEnrollments(ali, "mine.csv").status == Status::AdminRequired);
+}
+
+// Seats are rebuilt from the enrollment files at startup, including lines
+// appended by hand while the system was down
+static void testRestartRecountsSeats() {
+    ScratchDirectory dir("recount");
+    {
+        CourseRegistrationSystem sys;
+        buildLargeTerm(sys);
+    }
+    {
+        ofstream appended("enrollments.txt", ios::app);
+        appended << "Anas,ENG101\n";
+    }
+
+    CourseRegistrationSystem sys;
+    TaskPool several(4);
+    sys.setTaskPool(several);
+    for (const char* code : DEPARTMENTS) CHECK_EQ(openSeats(sys, code), 1000 - STUDENTS / 2);
+    CHECK_EQ(openSeats(sys, "ENG101"), 37);
+    CHECK_EQ(openSeats(sys, "MATH101"), 34);
+
+    // Nothing has drifted, so a recount changes nothing
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    Outcome recounted = sys.recountSeats(admin);
+    CHECK(recounted.ok());
+    CHECK_EQ(recounted.count, 0LL);
+
+    // A held seat stays out of the count
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(sys.holdSeat(ali, "ART101").ok());
+    CHECK_EQ(sys.recountSeats(admin).count, 0LL);
+    CHECK_EQ(openSeats(sys, "ART101"), 1000 - STUDENTS / 2 - 1);
+    CHECK(sys.recountSeats(ali).status == Status::AdminRequired);
+}
+
+int main() {
+    testExportMatchesAcrossPools();
+    testRestartRecountsSeats();
+    return testResult();
+}
@@ -0,0 +1,55 @@
+#include "TestSupport.h"
+#include <fstream>
+
+// Payments arriving from the bank are held to the same rules as those made
+// at the counter, and every line turned away says why
+
+static void writeFile(const string& name, const string& text) {
+    ofstream file(name);
+    file << text;
+}
+
+static void testImportValidatesLikeProcessPayment() {
+    ScratchDirectory dir("import");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken sara = loginAs(sys, "Sara", "123");
+    CHECK(sys.processPayment(sara, "T-1", 500).ok());
+
+    writeFile("bank.csv",
+              "T-1,Sara,500,Voided\n"       // Known: status change
+              "T-2,Ali,100000,Completed\n"  // New, at the cap
+              "\n"
+              "T-3,Nobody,50,Completed\n"
+              "T-4,Ali,100000.01,Completed\n"
+              "T-5,Ali,0,Completed\n"
+              "T-6,Ali,50,Pending\n"
+              "T-7,Ali,lots,Completed\n"
+              ",Ali,50,Completed\n"
+              "T-8,Ali\n");
+    Result<ReconciliationReport> result = sys.importReconciliation(admin, "bank.csv");
+    CHECK(result.ok());
+    const ReconciliationReport& report = result.value;
+    CHECK_EQ(report.lines, 9); // Blank lines are skipped but still numbered
+    CHECK_EQ(report.added, 1);
+    CHECK_EQ(report.updated, 1);
+    CHECK_EQ(report.rejected, 7);
+
+    const vector<pair<int, Status>> expected = {
+        {4, Status::UserNotFound},  {5, Status::AmountTooHigh},   {6, Status::AmountNotPositive},
+        {7, Status::MalformedRecord}, {8, Status::MalformedRecord}, {9, Status::EmptyTransactionId},
+        {10, Status::MalformedRecord}};
+    CHECK(report.rejections == expected);
+
+    // Nothing was created for the rejected lines
+    CHECK(sys.paymentStatus(admin, "T-3").status == Status::PaymentNotFound);
+    CHECK(sys.paymentStatus(admin, "T-4").status == Status::PaymentNotFound);
+    CHECK(sys.paymentStatus(admin, "T-2").ok());
+    CHECK_EQ(sys.paymentStatus(admin, "T-1").value.status, string("Voided"));
+}
+
+int main() {
+    testImportValidatesLikeProcessPayment();
+    return testResult();
+}
@@ -0,0 +1,142 @@
+#include "TestSupport.h"
+#include <fstream>
+#include <sstream>
+
+// Data written by one run must survive into the next, including runs that
+// are killed before their destructor can save anything
+
+static string readFile(const string& name) {
+    ifstream file(name);
+    stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+static void testRestartKeepsEnrollments() {
+    ScratchDirectory dir("restart");
+    {
+        CourseRegistrationSystem sys;
+        sys.seedData();
+        SessionToken ali = loginAs(sys, "Ali", "123");
+        CHECK(sys.enrollCourse(ali, "ENG101").ok());
+    }
+    CourseRegistrationSystem sys;
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(enrolledIn(sys, ali, "ENG101"));
+    CHECK_EQ(openSeats(sys, "ENG101"), 38);
+}
+
+// The second run starts with enrollments appended since the last snapshot;
+// what it enrolls must reach disk before it is killed
+static void testCrashAfterRestartKeepsEnrollments() {
+    ScratchDirectory dir("crash");
+    CHECK_EQ(runThenCrash([](CourseRegistrationSystem& sys) {
+        sys.seedData();
+        SessionToken ali = loginAs(sys, "Ali", "123");
+        CHECK(sys.enrollCourse(ali, "ENG101").ok());
+    }), 0);
+    CHECK(filesystem::file_size("enrollments.txt") > 0);
+
+    CHECK_EQ(runThenCrash([](CourseRegistrationSystem& sys) {
+        SessionToken anas = loginAs(sys, "Anas", "123");
+        CHECK(sys.enrollCourse(anas, "MATH101").ok());
+    }), 0);
+
+    CourseRegistrationSystem sys;
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    SessionToken anas = loginAs(sys, "Anas", "123");
+    CHECK(enrolledIn(sys, ali, "ENG101"));
+    CHECK(enrolledIn(sys, anas, "MATH101"));
+    CHECK(enrolledIn(sys, anas, "CS201"));
+    CHECK_EQ(openSeats(sys, "ENG101"), 38);
+    CHECK_EQ(openSeats(sys, "MATH101"), 33);
+}
+
+static void testCrashKeepsDropsAndPayments() {
+    ScratchDirectory dir("crash-drop");
+    CHECK_EQ(runThenCrash([](CourseRegistrationSystem& sys) {
+        sys.seedData();
+        SessionToken sara = loginAs(sys, "Sara", "123");
+        CHECK(sys.dropCourse(sara, "ENG101").ok());
+        CHECK(sys.processPayment(sara, "T-1", 500).ok());
+        CHECK(sys.processPayment(sara, "T-2", 250).ok());
+        CHECK(sys.voidPayment(sara, "T-2") == Status::Ok);
+    }), 0);
+
+    CourseRegistrationSystem sys;
+    SessionToken sara = loginAs(sys, "Sara", "123");
+    CHECK(!enrolledIn(sys, sara, "ENG101"));
+    CHECK_EQ(openSeats(sys, "ENG101"), 40);
+    Result<PaymentHistory> history = sys.paymentHistory(sara, "Sara");
+    CHECK(history.ok());
+    CHECK_EQ(history.value.payments.size(), size_t(2));
+    CHECK_EQ(history.value.totals.completedCount, 1);
+    CHECK_EQ(history.value.totals.voidedCount, 1);
+}
+
+// A crash after the snapshot is replaced but before the tail is emptied
+// replays records the snapshot already holds; they must count once, and
+// a record for a course that no longer exists is skipped
+static void testReplayedTailLoadsOnce() {
+    ScratchDirectory dir("replayed-tail");
+    string tail;
+    {
+        CourseRegistrationSystem sys;
+        sys.seedData();
+        sys.setClock(0);
+        CHECK(sys.enrollCourse(loginAs(sys, "Ali", "123"), "ENG101").ok());
+        CHECK(sys.enrollCourse(loginAs(sys, "Anas", "123"), "MATH101").ok());
+        CHECK(sys.dropCourse(loginAs(sys, "Sara", "123"), "CS101").ok());
+        tail = readFile("enrollments.txt");
+    }
+    { CourseRegistrationSystem sys; } // Folds the tail into the snapshot
+    CHECK_EQ(readFile("enrollments.txt"), string());
+    ofstream("enrollments.txt") << tail << "Ghost,XX999\n";
+
+    CourseRegistrationSystem sys;
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    CHECK_EQ(openSeats(sys, "ENG101"), 38);
+    CHECK_EQ(openSeats(sys, "MATH101"), 33);
+    CHECK_EQ(openSeats(sys, "CS101"), 28);
+    Result<CourseRoster> roster = sys.courseEnrollments(admin, "ENG101");
+    CHECK(roster.ok() && roster.value.students.size() == 2);
+    CHECK(!enrolledIn(sys, loginAs(sys, "Sara", "123"), "CS101"));
+    CHECK(!sys.findCourse("XX999").has_value());
+}
+
+// Deleting a student or a course appends drop records; the snapshot stays as it was
+static void testBulkDropsAreAppended() {
+    ScratchDirectory dir("bulk-drops");
+    {
+        CourseRegistrationSystem sys;
+        sys.seedData();
+        sys.setClock(0);
+        SessionToken admin = loginAs(sys, "admin", "admin123");
+        filesystem::file_time_type snapshotWritten = filesystem::last_write_time("enrollments.dat");
+        CHECK(sys.deleteUser(admin, "Anas") == Status::Ok);
+        CHECK(sys.deleteCourse(admin, "CS101") == Status::Ok);
+        CHECK(filesystem::last_write_time("enrollments.dat") == snapshotWritten);
+        string tail = readFile("enrollments.txt");
+        CHECK(tail.starts_with("DROP,Anas,CS201\n"));
+        CHECK(tail.find("DROP,Ali,CS101\n") != string::npos);
+        CHECK(tail.find("DROP,Sara,CS101\n") != string::npos);
+        CHECK(tail.find("DROP,student,CS101\n") != string::npos);
+    }
+    CourseRegistrationSystem sys;
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    CHECK_EQ(openSeats(sys, "CS201"), 25);
+    // Added again under the same code, the course starts with no one in it
+    CHECK(sys.addCourse(admin, "CS101", "Introduction to Programming", 3, 30, "MWF 9-10") == Status::Ok);
+    CHECK_EQ(openSeats(sys, "CS101"), 30);
+    CHECK(!enrolledIn(sys, loginAs(sys, "Ali", "123"), "CS101"));
+}
+
+int main() {
+    testRestartKeepsEnrollments();
+    testCrashAfterRestartKeepsEnrollments();
+    testCrashKeepsDropsAndPayments();
+    testReplayedTailLoadsOnce();
+    testBulkDropsAreAppended();
+    return testResult();
+}
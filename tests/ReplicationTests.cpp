@@ -0,0 +1,161 @@
+#include "TestSupport.h"
+#include <thread>
+
+// Log shipping between processes: a primary and two read replicas share a
+// data directory, the replicas starting before the primary's first run, and
+// each replica must catch up with every step the primary takes
+
+// A replica in a child process, stepped through the scenario over two pipes.
+// The parent sends a step letter once the primary has made its changes; the
+// child answers with the same letter once its replica shows them.
+class ReplicaProcess {
+private:
+    pid_t child;
+    int toChild[2];
+    int toParent[2];
+
+public:
+    explicit ReplicaProcess(const function<void(ReplicaProcess&, CourseRegistrationSystem&)>& body) {
+        cout.flush();
+        cerr.flush();
+        if (pipe(toChild) != 0 || pipe(toParent) != 0) {
+            child = -1;
+            return;
+        }
+        child = fork();
+        if (child == 0) {
+            close(toChild[1]);
+            close(toParent[0]);
+            checkFailures = 0; // Only the child's own checks decide its status
+            body(*this, *new CourseRegistrationSystem(true));
+            _exit(checkFailures > 0 ? 1 : 0);
+        }
+        close(toChild[0]);
+        close(toParent[1]);
+    }
+
+    ReplicaProcess(const ReplicaProcess&) = delete;
+    ReplicaProcess& operator=(const ReplicaProcess&) = delete;
+
+    // Parent side
+    void send(char step) { CHECK(write(toChild[1], &step, 1) == 1); }
+    bool answered(char step) {
+        char reply = 0;
+        return read(toParent[0], &reply, 1) == 1 && reply == step;
+    }
+    int finish() {
+        close(toChild[1]);
+        close(toParent[0]);
+        int status = 0;
+        if (child < 0 || waitpid(child, &status, 0) != child) return -1;
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    // Child side
+    bool received(char step) {
+        char sent = 0;
+        return read(toChild[0], &sent, 1) == 1 && sent == step;
+    }
+    void answer(char step) { CHECK(write(toParent[1], &step, 1) == 1); }
+};
+
+// Replica reads may be up to a second behind; gives the condition five
+static bool eventually(const function<bool()>& condition) {
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+    while (!condition()) {
+        if (chrono::steady_clock::now() > deadline) return false;
+        this_thread::sleep_for(chrono::milliseconds(20));
+    }
+    return true;
+}
+
+// Browsing never syncs a replica itself; the front end ticks it between requests
+static int replicaSeats(CourseRegistrationSystem& replica, const string& code) {
+    replica.tick();
+    return openSeats(replica, code);
+}
+
+static void followPrimary(ReplicaProcess& channel, CourseRegistrationSystem& replica) {
+    channel.answer('R');
+
+    // Seeded: users, courses, prerequisites, the archived term and enrollments
+    CHECK(channel.received('S'));
+    CHECK(eventually([&replica] { return replicaSeats(replica, "ENG101") == 39; }));
+    CHECK_EQ(openSeats(replica, "MATH101"), 34);
+    optional<CourseView> gated = replica.findCourse("CS201");
+    CHECK(gated && gated->prerequisites == vector<string>({"CS101"}));
+    SessionToken amjad = loginAs(replica, "Amjad", "123");
+    Result<Transcript> transcript = replica.transcript(amjad, "Amjad");
+    CHECK(transcript.ok() && transcript.value.terms.size() == 1 && transcript.value.terms[0].courses.size() == 3);
+    SessionToken ali = loginAs(replica, "Ali", "123");
+    CHECK(enrolledIn(replica, ali, "CS101"));
+    CHECK(replica.enrollCourse(ali, "ENG101").status == Status::ReadOnlyReplica);
+    channel.answer('S');
+
+    // Ali holds a seat in ENG101
+    CHECK(channel.received('H'));
+    CHECK(eventually([&replica] { return replicaSeats(replica, "ENG101") == 38; }));
+    channel.answer('H');
+
+    // Ali confirms it; Adil holds and releases one in MATH101
+    CHECK(channel.received('C'));
+    CHECK(eventually([&] { return enrolledIn(replica, ali, "ENG101"); }));
+    CHECK_EQ(openSeats(replica, "ENG101"), 38);
+    CHECK_EQ(openSeats(replica, "MATH101"), 34);
+    channel.answer('C');
+
+    // Anas holds one too, and it expires on the primary's clock; the
+    // replica's own copy of the hold would not run out for 15 minutes
+    CHECK(channel.received('A'));
+    CHECK(eventually([&replica] { return replicaSeats(replica, "ENG101") == 37; }));
+    channel.answer('A');
+    CHECK(channel.received('E'));
+    CHECK(eventually([&replica] { return replicaSeats(replica, "ENG101") == 38; }));
+    channel.answer('E');
+}
+
+static void testReplicasFollowPrimaryProcess() {
+    ScratchDirectory dir("replicas");
+    ReplicaProcess first(followPrimary);
+    ReplicaProcess second(followPrimary);
+    CHECK(first.answered('R'));
+    CHECK(second.answered('R'));
+
+    auto step = [&first, &second](char letter) {
+        first.send(letter);
+        second.send(letter);
+        CHECK(first.answered(letter));
+        CHECK(second.answered(letter));
+    };
+
+    CourseRegistrationSystem primary;
+    primary.seedData();
+    primary.setClock(0);
+    step('S');
+
+    SessionToken ali = loginAs(primary, "Ali", "123");
+    CHECK(primary.holdSeat(ali, "ENG101").ok());
+    step('H');
+
+    CHECK(primary.confirmHold(ali, "ENG101").ok());
+    SessionToken adil = loginAs(primary, "Adil", "123");
+    CHECK(primary.holdSeat(adil, "MATH101").ok());
+    CHECK(primary.releaseHold(adil, "MATH101").ok());
+    step('C');
+
+    SessionToken anas = loginAs(primary, "Anas", "123");
+    CHECK(primary.holdSeat(anas, "ENG101").ok());
+    CHECK_EQ(openSeats(primary, "ENG101"), 37);
+    step('A');
+    primary.setClock(16 * 60);
+    CHECK_EQ(openSeats(primary, "ENG101"), 38);
+    step('E');
+
+    CHECK_EQ(first.finish(), 0);
+    CHECK_EQ(second.finish(), 0);
+}
+
+int main() {
+    testReplicasFollowPrimaryProcess();
+    return testResult();
+}
@@ -0,0 +1,134 @@
+#include "TestSupport.h"
+#include "ShardRouter.h"
+#include <fstream>
+#include <sstream>
+
+// The catalog split across worker processes: two workers share the seed
+// departments (CS and MATH with one, ENG with the other), and ENG201 needs
+// MATH101, so its prerequisite is looked up in the other worker's shard
+
+static string readFile(const string& name) {
+    ifstream file(name);
+    stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+// The seed data plus ENG201, whose prerequisite lives in another department
+static vector<CourseView> seedWithCrossingPrerequisite() {
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    CHECK(sys.addCourse(admin, "ENG201", "Technical Writing", 3, 30, "") == Status::Ok);
+    CHECK(sys.addPrerequisite(admin, "ENG201", "MATH101") == Status::Ok);
+    return sys.listCourses(CourseOrder::ByCode);
+}
+
+static SessionToken routerLogin(ShardRouter& router, const string& username) {
+    Result<SessionToken> login = router.login(username, "123");
+    CHECK(login.ok());
+    return login.value;
+}
+
+static int routerSeats(ShardRouter& router, const string& code) {
+    optional<CourseView> course = router.findCourse(code);
+    return course ? course->availableSeats : -1;
+}
+
+static void testShardsSplitByDepartment() {
+    ScratchDirectory dir("shard-split");
+    vector<CourseView> whole = seedWithCrossingPrerequisite();
+    ShardRouter router(2);
+    CHECK_EQ(router.workerCount(), 2);
+    CHECK_EQ(router.workerFor("CS101"), 0);
+    CHECK_EQ(router.workerFor("ENG101"), 1);
+    CHECK_EQ(router.workerFor("MATH101"), 0);
+    CHECK_EQ(router.workerFor("XX100"), -1);
+
+    // Each worker's files hold its own departments only
+    string first = readFile("shards/0/courses.txt");
+    string second = readFile("shards/1/courses.txt");
+    CHECK(first.find("CS101,") != string::npos && first.find("MATH101,") != string::npos);
+    CHECK(first.find("ENG") == string::npos);
+    CHECK(second.find("ENG101,") != string::npos && second.find("CS") == string::npos);
+    CHECK(readFile("shards/1/prerequisites.txt").empty()); // ENG201 -> MATH101 crosses, so the router keeps it
+
+    // Browsing through the router shows the catalog as one program did
+    vector<CourseView> merged = router.listCourses(CourseOrder::ByCode);
+    CHECK_EQ(merged.size(), whole.size());
+    for (size_t i = 0; i < min(merged.size(), whole.size()); i++) {
+        CHECK_EQ(merged[i].code, whole[i].code);
+        CHECK_EQ(merged[i].availableSeats, whole[i].availableSeats);
+        CHECK(merged[i].prerequisites == whole[i].prerequisites);
+    }
+    optional<CourseView> writing = router.findCourse("ENG201");
+    CHECK(writing && writing->prerequisites == vector<string>({"MATH101"}));
+    CHECK(!router.findCourse("XX100"));
+}
+
+static void testCrossShardPrerequisites() {
+    ScratchDirectory dir("shard-prereq");
+    seedWithCrossingPrerequisite();
+    {
+        ShardRouter router(2);
+        router.setClock(0);
+        SessionToken sara = routerLogin(router, "Sara"); // Completed MATH101 last term
+        SessionToken ali = routerLogin(router, "Ali");   // Only taking it this term
+        SessionToken anas = routerLogin(router, "Anas");
+
+        CHECK(router.enrollCourse(sara, "ENG201").ok());
+        Outcome missing = router.enrollCourse(ali, "ENG201");
+        CHECK(missing.status == Status::PrerequisitesMissing);
+        CHECK(missing.items == vector<string>({"MATH101"}));
+        CHECK(router.enrollCourse(anas, "CS301").status == Status::PrerequisitesMissing); // Checked by the worker itself
+        CHECK_EQ(routerSeats(router, "ENG201"), 29);
+
+        CHECK(router.enrollCourse(ali, "XX100").status == Status::CourseNotFound);
+        CHECK(router.enrollCourse("not-a-token", "ENG101").status == Status::NotLoggedIn);
+        CHECK(router.login("Ali", "wrong").status == Status::InvalidCredentials);
+    }
+
+    // Started again with the same worker count, the shards are picked up as they were left
+    ShardRouter router(2);
+    router.setClock(0);
+    CHECK_EQ(routerSeats(router, "ENG201"), 29);
+    SessionToken sara = routerLogin(router, "Sara");
+    CHECK(router.enrollCourse(sara, "ENG201").status == Status::AlreadyEnrolled);
+    CHECK(router.dropCourse(sara, "ENG201").ok());
+    CHECK_EQ(routerSeats(router, "ENG201"), 30);
+}
+
+// A batch spread over both workers comes back in request order
+static void testEnrollManyAcrossWorkers() {
+    ScratchDirectory dir("shard-batch");
+    seedWithCrossingPrerequisite();
+    ShardRouter router(2);
+    router.setClock(0);
+    SessionToken ali = routerLogin(router, "Ali");
+    SessionToken adil = routerLogin(router, "Adil");
+    SessionToken amjad = routerLogin(router, "Amjad");
+    SessionToken sara = routerLogin(router, "Sara");
+    vector<Outcome> outcomes = router.enrollMany({
+        {ali, "ENG101"}, {adil, "MATH101"}, {amjad, "ENG101"}, {ali, "ENG201"}, {sara, "ENG201"}, {ali, "CS101"}
+    });
+    CHECK_EQ(outcomes.size(), size_t(6));
+    CHECK(outcomes[0].ok() && outcomes[0].subject == "English Composition");
+    CHECK(outcomes[1].ok());
+    CHECK(outcomes[2].ok());
+    CHECK(outcomes[3].status == Status::PrerequisitesMissing);
+    CHECK(outcomes[4].ok());
+    CHECK(outcomes[5].status == Status::AlreadyEnrolled);
+    CHECK_EQ(routerSeats(router, "ENG101"), 37);
+    CHECK_EQ(routerSeats(router, "MATH101"), 33);
+    CHECK_EQ(routerSeats(router, "ENG201"), 29);
+    CHECK(router.logout(ali) == Status::Ok);
+    CHECK(router.enrollCourse(ali, "CS201").status == Status::NotLoggedIn);
+}
+
+int main() {
+    testShardsSplitByDepartment();
+    testCrossShardPrerequisites();
+    testEnrollManyAcrossWorkers();
+    return testResult();
+}
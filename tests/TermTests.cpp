@@ -0,0 +1,111 @@
+#include "TestSupport.h"
+
+// Terms: completions from every closed term count towards prerequisites, and
+// data kept before terms existed carries its history over
+
+static void testCompletionsAcrossTerms() {
+    ScratchDirectory dir("terms");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken anas = loginAs(sys, "Anas", "123");
+
+    // CS101 came from the seeded spring term, CS201 is taken this fall
+    CHECK(sys.enrollCourse(anas, "CS101").status == Status::AlreadyCompleted);
+    CHECK(sys.enrollCourse(anas, "CS301").status == Status::PrerequisitesMissing);
+    CHECK(sys.closeTerm(admin, "2027-SPRING").ok());
+
+    CHECK(sys.enrollCourse(anas, "CS201").status == Status::AlreadyCompleted);
+    CHECK(sys.enrollCourse(anas, "CS301").ok());
+    CHECK(sys.closeTerm(admin, "2027-FALL").ok());
+    CHECK(sys.enrollCourse(anas, "CS401").ok());
+
+    // A restart rebuilds the same completions from the archives
+    CourseRegistrationSystem restarted;
+    SessionToken again = loginAs(restarted, "Anas", "123");
+    CHECK(restarted.enrollCourse(again, "CS301").status == Status::AlreadyCompleted);
+    CHECK(enrolledIn(restarted, again, "CS401"));
+}
+
+// A data directory from before terms: the same files with no terms.txt
+static void testPreTermDataIsSealed() {
+    ScratchDirectory dir("legacy");
+    {
+        CourseRegistrationSystem sys;
+        sys.seedData();
+    }
+    for (const auto& entry : filesystem::directory_iterator(".")) {
+        string name = entry.path().filename().string();
+        if (name == "terms.txt" || name.starts_with("term_")) filesystem::remove(entry.path());
+    }
+
+    {
+        CourseRegistrationSystem sys;
+        SessionToken admin = loginAs(sys, "admin", "admin123");
+        SessionToken anas = loginAs(sys, "Anas", "123");
+        Result<TermReport> terms = sys.termArchives(admin);
+        CHECK(terms.ok());
+        CHECK_EQ(terms.value.activeTerm, DEFAULT_TERM);
+        CHECK_EQ(terms.value.archived.size(), size_t(1));
+        CHECK_EQ(terms.value.archived[0].term, LEGACY_TERM);
+
+        // What was on file is now history: it satisfies prerequisites and frees its seats
+        CHECK(!enrolledIn(sys, anas, "CS201"));
+        CHECK_EQ(openSeats(sys, "CS201"), 25);
+        CHECK(sys.enrollCourse(anas, "CS201").status == Status::AlreadyCompleted);
+        CHECK(sys.enrollCourse(anas, "CS301").ok());
+    }
+
+    // Sealed once: the next start finds terms.txt and keeps this term's enrollments
+    CourseRegistrationSystem sys;
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken anas = loginAs(sys, "Anas", "123");
+    CHECK_EQ(sys.termArchives(admin).value.archived.size(), size_t(1));
+    CHECK(enrolledIn(sys, anas, "CS301"));
+}
+
+// A deleted student's name can be registered again; the new account starts
+// with none of the old one's history, payments, preferences or rate limit
+static void testReusedNameStartsFresh() {
+    ScratchDirectory dir("reused-name");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken anas = loginAs(sys, "Anas", "123");
+    CHECK(sys.processPayment(anas, "T-1", 500).ok());
+    CHECK(sys.openPreferenceRound(admin).ok());
+    CHECK(sys.submitPreferences(anas, {"MATH101"}).ok());
+    Status last = Status::Ok;
+    for (int i = 0; i < 10 && last != Status::RateLimited; i++) last = sys.enrollCourse(anas, "CS101").status;
+    CHECK(last == Status::RateLimited);
+
+    CHECK(sys.deleteUser(admin, "Anas") == Status::Ok);
+    CHECK(sys.registerUser("Anas", "456", "Anas Again", "02-134242-168") == Status::Ok);
+    SessionToken again = loginAs(sys, "Anas", "456");
+    CHECK(sys.openPreferenceRound(admin).count == 0);
+    Result<Transcript> history = sys.transcript(again, "Anas");
+    CHECK(history.ok() && history.value.terms.empty());
+    Result<PaymentHistory> paid = sys.paymentHistory(again, "Anas");
+    CHECK(paid.ok() && paid.value.payments.empty());
+    CHECK(sys.enrollCourse(again, "CS201").status == Status::PrerequisitesMissing);
+    CHECK(sys.enrollCourse(again, "CS101").ok()); // Neither completed nor rate limited
+
+    // A restart rebuilds the same: the sealed term and the ledger still name the old account
+    CourseRegistrationSystem restarted;
+    restarted.setClock(0);
+    SessionToken later = loginAs(restarted, "Anas", "456");
+    history = restarted.transcript(later, "Anas");
+    CHECK(history.ok() && history.value.terms.empty());
+    paid = restarted.paymentHistory(later, "Anas");
+    CHECK(paid.ok() && paid.value.payments.empty());
+    CHECK(restarted.enrollCourse(later, "CS201").status == Status::PrerequisitesMissing);
+    CHECK(enrolledIn(restarted, later, "CS101"));
+}
+
+int main() {
+    testCompletionsAcrossTerms();
+    testPreTermDataIsSealed();
+    testReusedNameStartsFresh();
+    return testResult();
+}
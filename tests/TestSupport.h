@@ -0,0 +1,110 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include "System.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Shared by the test programs. A failed CHECK is reported and counted, the
+// program carries on, and main returns testResult() so ctest sees the failure.
+
+inline int checkFailures = 0;
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            checkFailures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                              \
+    do {                                                                        \
+        auto actualValue = (actual);                                            \
+        auto expectedValue = (expected);                                        \
+        if (!(actualValue == expectedValue)) {                                  \
+            cerr << __FILE__ << ":" << __LINE__ << ": CHECK_EQ(" #actual ", " #expected ") failed: got " \
+                 << actualValue << ", expected " << expectedValue << "\n";      \
+            checkFailures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+inline int testResult() {
+    if (checkFailures > 0) cerr << checkFailures << " check(s) failed\n";
+    return checkFailures > 0 ? 1 : 0;
+}
+
+// The system keeps its data files in the working directory, so each test
+// works in an empty directory of its own, removed again afterwards
+class ScratchDirectory {
+private:
+    filesystem::path savedDir;
+    filesystem::path dir;
+
+public:
+    explicit ScratchDirectory(const string& name) : savedDir(filesystem::current_path()) {
+        dir = filesystem::temp_directory_path() /
+              ("crs-test-" + name + "-" + to_string(getpid()) + "-" +
+               to_string(chrono::steady_clock::now().time_since_epoch().count()));
+        filesystem::create_directories(dir);
+        filesystem::current_path(dir);
+    }
+
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+
+    ~ScratchDirectory() {
+        error_code ignored;
+        filesystem::current_path(savedDir, ignored);
+        filesystem::remove_all(dir, ignored);
+    }
+
+    const filesystem::path& path() const { return dir; }
+};
+
+inline SessionToken loginAs(CourseRegistrationSystem& sys, const string& username, const string& password) {
+    Result<LoginSession> login = sys.login(username, password);
+    CHECK(login.ok());
+    return login.value.token;
+}
+
+inline bool enrolledIn(CourseRegistrationSystem& sys, const SessionToken& session, const string& code) {
+    Result<StudentRecord> record = sys.myEnrollments(session);
+    if (!record.ok()) return false;
+    for (const CourseView& course : record.value.courses) {
+        if (course.code == code) return true;
+    }
+    return false;
+}
+
+inline int openSeats(CourseRegistrationSystem& sys, const string& code) {
+    optional<CourseView> course = sys.findCourse(code);
+    return course ? course->availableSeats : -1;
+}
+
+// Starts a system in a child process, runs body on it, then kills the child
+// without unwinding, the way kill -9 would: the system is never destroyed, so
+// nothing is saved on the way out. Returns the child's exit status, non-zero
+// if any check in it failed.
+inline int runThenCrash(const function<void(CourseRegistrationSystem&)>& body) {
+    cout.flush();
+    cerr.flush();
+    pid_t child = fork();
+    if (child == 0) {
+        checkFailures = 0; // Only the child's own checks decide its status
+        body(*new CourseRegistrationSystem());
+        _exit(checkFailures > 0 ? 1 : 0);
+    }
+    int status = 0;
+    if (child < 0 || waitpid(child, &status, 0) != child) return -1;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+#endif
@@ -0,0 +1,150 @@
+#include "TestSupport.h"
+#include <fstream>
+
+// The system clock and trace recording: time only passes when the clock is
+// set, every public call is recorded whoever makes it, and a replay that sets
+// the clock from the records reaches the same state as the recorded run
+
+static void testClockDrivesHoldsAndSessions() {
+    ScratchDirectory dir("clock");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(sys.holdSeat(ali, "ENG101").ok());
+    CHECK_EQ(openSeats(sys, "ENG101"), 38);
+
+    sys.setClock(14 * 60);
+    CHECK_EQ(openSeats(sys, "ENG101"), 38);
+    sys.setClock(15 * 60 + 1); // Default hold lasts 15 minutes
+    CHECK_EQ(openSeats(sys, "ENG101"), 39);
+    CHECK(sys.confirmHold(ali, "ENG101").status == Status::NoHold);
+
+    // Sessions idle past 30 minutes are gone
+    sys.setClock(15 * 60 + 1 + 30 * 60 + 1);
+    CHECK(sys.myEnrollments(ali).status == Status::NotLoggedIn);
+}
+
+static void testClockDrivesAdmission() {
+    ScratchDirectory dir("admission");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(sys.setRegistrationWindow(admin, "02-134242-001", 10).ok());
+
+    Outcome early = sys.enrollCourse(ali, "ENG101");
+    CHECK(early.status == Status::WindowClosed);
+    CHECK_EQ(early.waitSeconds, 600.0);
+
+    sys.setClock(600);
+    CHECK(sys.enrollCourse(ali, "ENG101").ok());
+}
+
+// Made straight against the API, the way a server front end would
+static void runRecordedScenario(CourseRegistrationSystem& sys) {
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    CHECK(sys.addCourse(admin, "CS150", "Discrete Structures", 3, 1, "TR 14-15") == Status::Ok);
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(sys.holdSeat(ali, "CS150").ok());
+
+    sys.setClock(60);
+    SessionToken sara = loginAs(sys, "Sara", "123");
+    CHECK(sys.enrollCourse(sara, "CS150").status == Status::NoSeats);
+
+    // Ali's hold lapses; Sara gets the seat
+    sys.setClock(16 * 60);
+    CHECK(sys.enrollCourse(sara, "CS150").ok());
+    CHECK(sys.enrollCourse(ali, "CS150").status == Status::NoSeats);
+    CHECK(sys.logout(admin) == Status::Ok);
+}
+
+static void testRecordingCapturesApiCalls() {
+    ScratchDirectory dir("record");
+    {
+        CourseRegistrationSystem sys;
+        sys.seedData();
+        sys.setClock(0);
+        CHECK(sys.startRecording("run.trace") == Status::Ok);
+        runRecordedScenario(sys);
+    }
+
+    TraceReader reader("run.trace");
+    CHECK(reader.isValid());
+    vector<TraceRecord> records;
+    TraceRecord record;
+    while (reader.next(record)) records.push_back(record);
+
+    const TraceOp expected[] = {TraceOp::Login, TraceOp::AddCourse, TraceOp::Login, TraceOp::HoldSeat,
+                                TraceOp::Login, TraceOp::EnrollCourse, TraceOp::EnrollCourse,
+                                TraceOp::EnrollCourse, TraceOp::Logout};
+    CHECK_EQ(records.size(), size(expected));
+    for (size_t i = 0; i < records.size() && i < size(expected); i++) CHECK(records[i].op == expected[i]);
+    if (records.size() != size(expected)) return;
+
+    CHECK(records[0].args == vector<string>({"admin", "admin123"}));
+    CHECK(records[1].args == vector<string>({"CS150", "Discrete Structures", "3", "1", "TR 14-15"}));
+    // Sessions are numbered in login order and every call carries its own
+    const uint32_t sessions[] = {1, 1, 2, 2, 3, 3, 3, 2, 1};
+    for (size_t i = 0; i < records.size(); i++) CHECK_EQ(records[i].session, sessions[i]);
+    CHECK_EQ(records[5].atMicros, uint64_t(60'000'000));
+    CHECK_EQ(records[6].atMicros, uint64_t(960'000'000));
+
+    // The data files embedded at the start already hold the seed data
+    bool hasUsers = false;
+    for (const auto& [name, data] : reader.dataFiles) {
+        if (name == "users.txt") hasUsers = data.find("Ali,") != string::npos;
+    }
+    CHECK(hasUsers);
+}
+
+// Re-runs the trace by hand, like replayTrace, so the end state can be checked
+static void testReplayFollowsRecordedClock() {
+    ScratchDirectory recorded("replay-source");
+    {
+        CourseRegistrationSystem sys;
+        sys.seedData();
+        sys.setClock(0);
+        CHECK(sys.startRecording("run.trace") == Status::Ok);
+        runRecordedScenario(sys);
+    }
+    filesystem::path trace = recorded.path() / "run.trace";
+
+    ScratchDirectory replayed("replay");
+    TraceReader reader(trace.string());
+    CHECK(reader.isValid());
+    for (const auto& [name, data] : reader.dataFiles) {
+        if (data.empty()) continue;
+        ofstream file(name, ios::binary);
+        file.write(data.data(), static_cast<streamsize>(data.size()));
+    }
+
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    vector<SessionToken> sessions(1);
+    TraceRecord record;
+    while (reader.next(record)) {
+        sys.setClock(record.atMicros / 1e6);
+        if (record.session == sessions.size()) sessions.emplace_back();
+        invokeTraceOp(sys, sessions[record.session], record);
+    }
+    CHECK_EQ(sessions.size(), size_t(4));
+    CHECK(enrolledIn(sys, sessions[3], "CS150"));
+    CHECK(!enrolledIn(sys, sessions[2], "CS150"));
+    CHECK_EQ(openSeats(sys, "CS150"), 0);
+
+    Result<ReplayReport> report = replayTrace(trace.string(), false);
+    CHECK(report.ok());
+    CHECK_EQ(report.value.replayed, size_t(9));
+    CHECK_EQ(report.value.sessions, size_t(3));
+}
+
+int main() {
+    testClockDrivesHoldsAndSessions();
+    testClockDrivesAdmission();
+    testRecordingCapturesApiCalls();
+    testReplayFollowsRecordedClock();
+    return testResult();
+}
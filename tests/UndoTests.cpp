@@ -0,0 +1,77 @@
+#include "TestSupport.h"
+#include <fstream>
+#include <sstream>
+
+// Undo reverses one action in constant time: the enrollment is unlinked
+// through its shard's index and the reversal is one appended drop record,
+// never a rewrite of the enrollment snapshot
+
+static string readFile(const string& name) {
+    ifstream file(name);
+    stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+static void testUndoAppendsOneDropRecord() {
+    ScratchDirectory dir("undo-append");
+    filesystem::file_time_type snapshotWritten;
+    {
+        CourseRegistrationSystem sys;
+        sys.seedData();
+        sys.setClock(0);
+        SessionToken ali = loginAs(sys, "Ali", "123");
+        snapshotWritten = filesystem::last_write_time("enrollments.dat");
+        CHECK(sys.enrollCourse(ali, "ENG101").ok());
+        CHECK_EQ(openSeats(sys, "ENG101"), 38);
+
+        Result<UserAction> undone = sys.undoLastAction(ali);
+        CHECK(undone.ok() && undone.value.type == ActionType::Enroll && undone.value.target == "ENG101");
+        CHECK(!enrolledIn(sys, ali, "ENG101"));
+        CHECK_EQ(openSeats(sys, "ENG101"), 39);
+        CHECK(filesystem::last_write_time("enrollments.dat") == snapshotWritten);
+        CHECK_EQ(readFile("enrollments.txt"), string("Ali,ENG101\nDROP,Ali,ENG101\n"));
+
+        // Redone, the enrollment is one more appended line
+        CHECK(sys.redoLastAction(ali).ok());
+        CHECK(enrolledIn(sys, ali, "ENG101"));
+        CHECK_EQ(readFile("enrollments.txt"), string("Ali,ENG101\nDROP,Ali,ENG101\nAli,ENG101\n"));
+    }
+    CourseRegistrationSystem sys;
+    SessionToken ali = loginAs(sys, "Ali", "123");
+    CHECK(enrolledIn(sys, ali, "ENG101"));
+    CHECK_EQ(openSeats(sys, "ENG101"), 38);
+}
+
+// The other students' enrollments in the department stay linked around the removed one
+static void testUndoLeavesNeighboursLinked() {
+    ScratchDirectory dir("undo-neighbours");
+    CourseRegistrationSystem sys;
+    sys.seedData();
+    sys.setClock(0);
+    SessionToken admin = loginAs(sys, "admin", "admin123");
+    for (int i = 0; i < 5; i++) {
+        string n = to_string(i);
+        CHECK(sys.registerUser("u" + n, "123", "User " + n, "U-" + n) == Status::Ok);
+    }
+    vector<SessionToken> students;
+    for (int i = 0; i < 5; i++) {
+        students.push_back(loginAs(sys, "u" + to_string(i), "123"));
+        CHECK(sys.enrollCourse(students.back(), "ENG101").ok());
+    }
+    CHECK(sys.undoLastAction(students[2]).ok()); // Middle of the list
+    CHECK(sys.undoLastAction(students[4]).ok()); // The tail
+    CHECK(sys.undoLastAction(students[0]).ok()); // Right behind Sara's
+    Result<CourseRoster> roster = sys.courseEnrollments(admin, "ENG101");
+    CHECK(roster.ok() && roster.value.students.size() == 3);
+    CHECK(enrolledIn(sys, students[1], "ENG101"));
+    CHECK(enrolledIn(sys, students[3], "ENG101"));
+    CHECK(sys.enrollCourse(students[4], "ENG101").ok());
+    CHECK_EQ(openSeats(sys, "ENG101"), 36);
+}
+
+int main() {
+    testUndoAppendsOneDropRecord();
+    testUndoLeavesNeighboursLinked();
+    return testResult();
+}